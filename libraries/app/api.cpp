@@ -25,7 +25,9 @@
 
 #include <graphene/app/api.hpp>
 #include <graphene/app/api_access.hpp>
+#include <graphene/app/api_reader_pool.hpp>
 #include <graphene/app/application.hpp>
+#include <graphene/app/cold_history.hpp>
 #include <graphene/app/impacted.hpp>
 #include <graphene/chain/database.hpp>
 #include <graphene/chain/get_config.hpp>
@@ -56,8 +58,8 @@ template class fc::api<graphene::app::login_api>;
 
 namespace graphene { namespace app {
 
-    login_api::login_api(application& a)
-    :_app(a) { }
+    login_api::login_api( application& a, const transport_backlog_reader& transport_backlog )
+    :_app(a), _transport_backlog(transport_backlog) { }
 
     login_api::~login_api() { }
 
@@ -89,7 +91,9 @@ namespace graphene { namespace app {
     void login_api::enable_api( const std::string& api_name )
     {
        if (api_name == "database_api") {
-          _database_api = std::make_shared< database_api >( std::ref( *_app.chain_database() ) );
+          _database_api = std::make_shared< database_api >( std::ref( *_app.chain_database() ),
+                                                            _app.get_subscription_queue_limits(),
+                                                            _transport_backlog, _app.get_api_reader_pool() );
        }
        else if (api_name == "network_broadcast_api") {
           _network_broadcast_api = std::make_shared< network_broadcast_api >( std::ref( _app ) );
@@ -444,6 +448,7 @@ namespace graphene { namespace app {
                } case impl_block_summary_object_type:
                   break;
                  case impl_account_transaction_history_object_type:
+                 case impl_account_address_history_object_type:
                  case impl_chain_property_object_type:
                  case impl_witness_schedule_object_type:
                  case impl_budget_record_object_type:
@@ -458,37 +463,252 @@ namespace graphene { namespace app {
                  case impl_fund_statistics_object_type:
                  case impl_fund_transaction_history_object_type:
                  case impl_fund_history_object_type:
+                 case impl_fund_history_item_object_type:
                  case impl_settings_object_type:
                  case impl_blind_transfer2_object_type:
                   break;
+                 case impl_account_online_object_type:{
+                  const auto& aobj = dynamic_cast<const account_online_object*>(obj);
+                  assert( aobj != nullptr );
+                  result.push_back( aobj->owner );
+                  break;
+               }
           }
        }
        return result;
     } // end get_relevant_accounts( obj )
 
+    namespace {
+
+    /**
+     * Finds the most recent history entry of an account or a fund whose operation id is not greater than @p start,
+     * or the most recent entry if @p start is the default id. The entry is found in O(log n) on the by_op index
+     * and returned as an iterator of the by_seq index, which is the end iterator if there is no such entry.
+     */
+    template<typename Index, typename Owner>
+    auto seek_history( const Index& hist_idx, Owner owner, operation_history_id_type start )
+    {
+       const auto& by_op_idx = hist_idx.indices().template get<by_op>();
+       auto itr = ( start == operation_history_id_type() ) ? by_op_idx.upper_bound( boost::make_tuple( owner ) )
+                                                           : by_op_idx.upper_bound( boost::make_tuple( owner, start ) );
+       if( itr == by_op_idx.lower_bound( boost::make_tuple( owner ) ) )
+          return hist_idx.indices().template get<by_seq>().end();
+       return hist_idx.indices().template project<by_seq>( std::prev( itr ) );
+    }
+
+    /**
+     * Same as seek_history(), but @p start is a sequence number within the history of @p owner, 0 for the most
+     * recent entry.
+     */
+    template<typename Index, typename Owner>
+    auto seek_history_by_seq( const Index& hist_idx, Owner owner, uint32_t start )
+    {
+       const auto& by_seq_idx = hist_idx.indices().template get<by_seq>();
+       auto itr = ( start == 0 ) ? by_seq_idx.upper_bound( boost::make_tuple( owner ) )
+                                 : by_seq_idx.upper_bound( boost::make_tuple( owner, start ) );
+       if( itr == by_seq_idx.lower_bound( boost::make_tuple( owner ) ) )
+          return by_seq_idx.end();
+       return std::prev( itr );
+    }
+
+    /**
+     * Visits the history entries of @p owner from @p itr towards older ones while their operation ids are
+     * greater than @p stop, until @p visit returns false.
+     */
+    template<typename Index, typename Owner, typename Iterator, typename Visitor>
+    void walk_history( const Index& hist_idx, Owner owner, Iterator itr, operation_history_id_type stop,
+                       Visitor&& visit )
+    {
+       const auto& by_seq_idx = hist_idx.indices().template get<by_seq>();
+       if( itr == by_seq_idx.end() )
+          return;
+       const auto first = by_seq_idx.lower_bound( boost::make_tuple( owner ) );
+       while( itr->operation_id.instance.value > stop.instance.value && visit( *itr ) && itr != first )
+          --itr;
+    }
+
+    /**
+     * Returns the sequence number of the most recent history entry of @p account whose operation id is not greater
+     * than @p start (any entry if @p start is the default id), or 0 if there is none.
+     */
+    uint32_t history_start_sequence( const account_transaction_history_index& hist_idx, account_id_type account,
+                                     operation_history_id_type start )
+    {
+       auto itr = seek_history( hist_idx, account, start );
+       return ( itr == hist_idx.indices().get<by_seq>().end() ) ? 0 : itr->sequence;
+    }
+
+    /**
+     * Visits the history entries of several ranges of one account, each given as the pair of its end (exclusive)
+     * and its first entry and ordered by sequence, from the most recent entry of all ranges towards older ones,
+     * while their operation ids are greater than @p stop, until @p visit returns false.
+     */
+    template<typename Iterator, typename Visitor>
+    void merge_history_ranges( vector< std::pair<Iterator, Iterator> >& ranges, operation_history_id_type stop,
+                               Visitor&& visit )
+    {
+       while( !ranges.empty() )
+       {
+          size_t newest = 0;
+          for( size_t i = 1; i < ranges.size(); ++i )
+             if( std::prev( ranges[i].first )->sequence > std::prev( ranges[newest].first )->sequence )
+                newest = i;
+
+          auto entry = std::prev( ranges[newest].first );
+          if( entry->operation_id.instance.value <= stop.instance.value || !visit( *entry ) )
+             return;
+
+          if( entry == ranges[newest].second )
+             ranges.erase( ranges.begin() + newest );
+          else
+             ranges[newest].first = entry;
+       }
+    }
+
+    /**
+     * Visits the history entries of @p account with one of @p operation_types, from the most recent one whose
+     * sequence is not greater than @p start_seq towards older ones, while their operation ids are greater than
+     * @p stop, until @p visit returns false. The entries of each type form one range of the by_type_seq index,
+     * so the ranges are merged by sequence and operations of other types are never visited.
+     */
+    template<typename Visitor>
+    void walk_typed_history( const account_transaction_history_index& hist_idx, account_id_type account,
+                             const flat_set<uint16_t>& operation_types, uint32_t start_seq,
+                             operation_history_id_type stop, Visitor&& visit )
+    {
+       const auto& by_type_idx = hist_idx.indices().get<by_type_seq>();
+       typedef decltype( by_type_idx.begin() ) iterator;
+
+       vector< std::pair<iterator, iterator> > ranges;
+       ranges.reserve( operation_types.size() );
+       for( uint16_t op_type : operation_types )
+       {
+          auto first = by_type_idx.lower_bound( boost::make_tuple( account, op_type ) );
+          auto itr = by_type_idx.upper_bound( boost::make_tuple( account, op_type, start_seq ) );
+          if( itr != first )
+             ranges.emplace_back( itr, first );
+       }
+       merge_history_ranges( ranges, stop, std::forward<Visitor>( visit ) );
+    }
+
+    /**
+     * Visits the transfers of @p account sent to one of the non-empty @p addresses, from the most recent one towards
+     * older ones, until @p visit returns false. Each address is one range of the by_address_seq index.
+     */
+    template<typename Visitor>
+    void walk_address_history( const account_address_history_index& address_idx, account_id_type account,
+                               const flat_set<string>& addresses, Visitor&& visit )
+    {
+       const auto& by_address_idx = address_idx.indices().get<by_address_seq>();
+       typedef decltype( by_address_idx.begin() ) iterator;
+
+       vector< std::pair<iterator, iterator> > ranges;
+       ranges.reserve( addresses.size() );
+       for( const string& address : addresses )
+       {
+          auto first = by_address_idx.lower_bound( boost::make_tuple( account, address ) );
+          auto itr = by_address_idx.upper_bound( boost::make_tuple( account, address ) );
+          if( itr != first )
+             ranges.emplace_back( itr, first );
+       }
+       merge_history_ranges( ranges, operation_history_id_type(), std::forward<Visitor>( visit ) );
+    }
+
+    /**
+     * @return the sequence of the oldest history entry of @p account kept in memory, the maximum sequence if there
+     * is none. Older entries may have been moved to the cold store of the history plugin.
+     */
+    uint32_t oldest_memory_sequence( const account_transaction_history_index& hist_idx, account_id_type account )
+    {
+       const auto& by_seq_idx = hist_idx.indices().get<by_seq>();
+       auto itr = by_seq_idx.lower_bound( boost::make_tuple( account ) );
+       if( itr == by_seq_idx.end() || itr->account != account )
+          return std::numeric_limits<uint32_t>::max();
+       return itr->sequence;
+    }
+
+    /**
+     * Visits the entries of @p account in the cold history store with a sequence lower than @p before_seq and an
+     * operation id not greater than @p start (any id if @p start is the default one), from the most recent one
+     * towards older ones, while their operation ids are greater than @p stop, until @p visit returns false.
+     */
+    template<typename Visitor>
+    void walk_cold_history( const cold_history_reader& store, account_id_type account,
+                            uint32_t before_seq, operation_history_id_type start, operation_history_id_type stop,
+                            Visitor&& visit )
+    {
+       typedef cold_history_entry entry;
+       const vector<entry>& entries = store.entries( account );
+       auto itr = std::lower_bound( entries.begin(), entries.end(), before_seq,
+                                    []( const entry& e, uint32_t seq ) { return e.sequence < seq; } );
+       if( start != operation_history_id_type() )
+          itr = std::upper_bound( entries.begin(), itr, start.instance.value,
+                                  []( uint64_t id, const entry& e ) { return id < e.operation_id.instance.value; } );
+       while( itr != entries.begin() )
+       {
+          --itr;
+          if( itr->operation_id.instance.value <= stop.instance.value || !visit( *itr ) )
+             return;
+       }
+    }
+
+    /**
+     * Continues a walk over the history of @p account kept in memory with the older entries in the cold history
+     * store @p store, if there is one. Their operations are read from the store and visited as walk_cold_history()
+     * does, skipping the entries without one of @p operation_types unless it is empty.
+     */
+    template<typename Visitor>
+    void walk_cold_operations( const cold_history_reader* store, const account_transaction_history_index& hist_idx,
+                               account_id_type account, const flat_set<uint16_t>& operation_types,
+                               operation_history_id_type start, operation_history_id_type stop, Visitor&& visit )
+    {
+       if( store == nullptr )
+          return;
+       walk_cold_history( *store, account, oldest_memory_sequence( hist_idx, account ), start, stop,
+                          [&]( const cold_history_entry& e )
+       {
+          if( !operation_types.empty() && operation_types.find( e.op_type ) == operation_types.end() )
+             return true;
+          return visit( store->read( e ) );
+       });
+    }
+
+    /// Returns the market address a transfer was sent to, or an empty string if it has none
+    string transfer_address( const transfer_operation& op )
+    {
+       for( const auto& ext : op.extensions )
+          if( ext.which() == asset_ext_type::value_type::tag<string>::value )
+             return ext.get<string>();
+       return string();
+    }
+
+    } // anonymous namespace
+
     vector<order_history_object> history_api::get_fill_order_history( asset_id_type a, asset_id_type b, uint32_t limit  )const
     {
        FC_ASSERT(_app.chain_database());
        const auto& db = *_app.chain_database();
-       if( a > b ) std::swap(a,b);
-       const auto& history_idx = db.get_index_type<graphene::market_history::history_index>().indices().get<by_key>();
-       history_key hkey;
-       hkey.base = a;
-       hkey.quote = b;
-       hkey.sequence = std::numeric_limits<int64_t>::min();
-
-       uint32_t count = 0;
-       auto itr = history_idx.lower_bound( hkey );
-       vector<order_history_object> result;
-       while( itr != history_idx.end() && count < limit)
-       {
-          if( itr->key.base != a || itr->key.quote != b ) break;
-          result.push_back( *itr );
-          ++itr;
-          ++count;
-       }
+       return read_only( _app.get_api_reader_pool(), [&]() {
+          if( a > b ) std::swap(a,b);
+          const auto& history_idx = db.get_index_type<graphene::market_history::history_index>().indices().get<by_key>();
+          history_key hkey;
+          hkey.base = a;
+          hkey.quote = b;
+          hkey.sequence = std::numeric_limits<int64_t>::min();
+
+          uint32_t count = 0;
+          auto itr = history_idx.lower_bound( hkey );
+          vector<order_history_object> result;
+          while( itr != history_idx.end() && count < limit)
+          {
+             if( itr->key.base != a || itr->key.quote != b ) break;
+             result.push_back( *itr );
+             ++itr;
+             ++count;
+          }
 
-       return result;
+          return result;
+       } );
     }
 
     inline void reserve_op(operation_history_object& h_obj)
@@ -511,22 +731,30 @@ namespace graphene { namespace app {
     {
        FC_ASSERT( _app.chain_database() );
        const auto& db = *_app.chain_database();
-       FC_ASSERT( limit <= 100 );
-       vector<operation_history_object> result;
+       return read_only( _app.get_api_reader_pool(), [&]() {
+          FC_ASSERT( limit <= 100 );
+          vector<operation_history_object> result;
 
-       const auto& idx = db.get_index_type<operation_history_index>().indices().get<by_id>();
-       for (auto rit = idx.rbegin(); rit != idx.crend(); ++rit)
-       {
-          if (result.size() < limit)
+          const auto& idx = db.get_index_type<operation_history_index>().indices().get<by_id>();
+          for (auto rit = idx.rbegin(); rit != idx.crend(); ++rit)
           {
-             operation_history_object obj = *rit;
-             db.clear_op(obj.op);
-             result.emplace_back(std::move(obj));
+             if (result.size() < limit)
+             {
+                operation_history_object obj = *rit;
+                db.clear_op(obj.op);
+                result.emplace_back(std::move(obj));
+             }
+             if (result.size() == limit) { break; }
           }
-          if (result.size() == limit) { break; }
-       }
 
-       return result;
+          return result;
+       } );
+    }
+
+    const cold_history_reader* history_api::cold_store()const
+    {
+       auto provider = std::dynamic_pointer_cast<cold_history_provider>( _app.get_plugin( "history" ) );
+       return provider ? provider->cold_history() : nullptr;
     }
 
     vector<operation_history_object> history_api::get_account_history( account_id_type account,
@@ -536,47 +764,108 @@ namespace graphene { namespace app {
     {
        FC_ASSERT( _app.chain_database() );
        const auto& db = *_app.chain_database();       
-       FC_ASSERT( limit <= 100 );
-       vector<operation_history_object> result;
-
-       const auto& stats = account(db).statistics(db);
-       if (stats.most_recent_op == account_transaction_history_id_type()) { return result; }
+       return read_only( _app.get_api_reader_pool(), [&]() {
+          FC_ASSERT( limit <= 100 );
+          vector<operation_history_object> result;
+
+          const auto& hist_idx = db.get_index_type<account_transaction_history_index>();
+          bool complete = false;
+          walk_history( hist_idx, account, seek_history( hist_idx, account, start ), stop,
+                        [&]( const account_transaction_history_object& node )
+          {
+             if( result.size() >= limit )
+                return false;
+             try
+             {
+                operation_history_object op_h = node.operation_id(db);
+                reserve_op(op_h);
+                result.push_back(std::move(op_h));
+             } catch( const fc::exception& ) { complete = true; return false; }
+             return true;
+          });
 
-       if (!db.find(stats.most_recent_op)) {
+          const cold_history_reader* store = cold_store();
+          if( store != nullptr && !complete && result.size() < limit )
+          {
+             walk_cold_history( *store, account, oldest_memory_sequence( hist_idx, account ), start, stop,
+                                [&]( const cold_history_entry& e )
+             {
+                if( result.size() >= limit )
+                   return false;
+                operation_history_object op_h = store->read( e );
+                reserve_op(op_h);
+                result.push_back(std::move(op_h));
+                return true;
+             });
+          }
+       
           return result;
-       }
-       const account_transaction_history_object* node = &stats.most_recent_op(db);
+       } );
+    }
 
-       if (start == operation_history_id_type()) {
-          start = node->operation_id;
-       }
-       while (node && (node->operation_id.instance.value > stop.instance.value) && (result.size() < limit) )
-       {
-          if (node->operation_id.instance.value <= start.instance.value)
+    account_history_page history_api::get_account_history_page( account_id_type account,
+                                                                uint32_t start,
+                                                                unsigned limit,
+                                                                const vector<uint16_t>& operation_types ) const
+    {
+       FC_ASSERT( _app.chain_database() );
+       const auto& db = *_app.chain_database();
+       return read_only( _app.get_api_reader_pool(), [&]() {
+          FC_ASSERT( limit <= 100 );
+          account_history_page result;
+          bool complete = false;
+
+          auto visit = [&]( const account_transaction_history_object& node )
           {
+             if( result.operations.size() >= limit )
+             {
+                result.next_start = node.sequence;
+                return false;
+             }
              try
              {
-                operation_history_object op_h = node->operation_id(db);
+                operation_history_object op_h = node.operation_id(db);
                 reserve_op(op_h);
-                result.push_back(std::move(op_h));
-             } catch(fc::exception e) { break; }
-          }
-          if (node->next == account_transaction_history_id_type()) {
-             node = nullptr;
-          }
+                result.operations.push_back(std::move(op_h));
+             } catch( const fc::exception& ) { complete = true; return false; }
+             return true;
+          };
+
+          const auto& hist_idx = db.get_index_type<account_transaction_history_index>();
+          if( operation_types.empty() )
+             walk_history( hist_idx, account, seek_history_by_seq( hist_idx, account, start ), operation_history_id_type(),
+                           visit );
           else
+             walk_typed_history( hist_idx, account, flat_set<uint16_t>( operation_types.begin(), operation_types.end() ),
+                                 start == 0 ? std::numeric_limits<uint32_t>::max() : start, operation_history_id_type(),
+                                 visit );
+
+          const cold_history_reader* store = cold_store();
+          if( store != nullptr && !complete && result.next_start == 0 )
           {
-             auto f_idx = db.get_index_type<account_transaction_history_index>().indices().get<by_id>().find(node->next);
-             if (f_idx == db.get_index_type<account_transaction_history_index>().indices().get<by_id>().end()) {
-                node = nullptr;
-             }
-             else {
-                node = &(*f_idx);
-             }
+             const flat_set<uint16_t> types( operation_types.begin(), operation_types.end() );
+             uint32_t before_seq = oldest_memory_sequence( hist_idx, account );
+             if( start != 0 && start < before_seq )
+                before_seq = start + 1;
+             walk_cold_history( *store, account, before_seq, operation_history_id_type(), operation_history_id_type(),
+                                [&]( const cold_history_entry& e )
+             {
+                if( !types.empty() && types.find( e.op_type ) == types.end() )
+                   return true;
+                if( result.operations.size() >= limit )
+                {
+                   result.next_start = e.sequence;
+                   return false;
+                }
+                operation_history_object op_h = store->read( e );
+                reserve_op(op_h);
+                result.operations.push_back(std::move(op_h));
+                return true;
+             });
           }
-       }
-       
-       return result;
+
+          return result;
+       } );
     }
 
    vector<listtransactions_result>
@@ -584,50 +873,74 @@ namespace graphene { namespace app {
    {
       FC_ASSERT(_app.chain_database());
       const auto& db = *_app.chain_database();       
-      FC_ASSERT(count <= 100);
-      vector<listtransactions_result> result;
-      const auto& stats = account(db).statistics(db);
-      if (stats.most_recent_op == account_transaction_history_id_type()) { return result; }
-      if (!db.find(stats.most_recent_op)) {
-         return result;
-      }
-      const account_transaction_history_object* node = &stats.most_recent_op(db);
-      const uint32_t current_block = db.head_block_num();
-      while ((node != nullptr) && (result.size() < (uint32_t)count))
-      {
-         auto op_hist = node->operation_id(db);
-         if (op_hist.op.which() == operation::tag<transfer_operation>::value)
+      return read_only( _app.get_api_reader_pool(), [&]() {
+         FC_ASSERT(count <= 100);
+         vector<listtransactions_result> result;
+         const uint32_t current_block = db.head_block_num();
+
+         const auto& hist_idx = db.get_index_type<account_transaction_history_index>();
+         const auto& address_idx = db.get_index_type<account_address_history_index>();
+         bool complete = false;
+         auto visit = [&]( operation_history_id_type operation_id )
          {
-            auto ext = op_hist.op.get<transfer_operation>().extensions;
-            auto tr_address = ext.begin() != ext.end() ? ext.begin()->get<string>(): "";
-            if (addresses.size() && std::find(addresses.begin(), addresses.end(), tr_address) == addresses.end())
+            if( result.size() >= (uint32_t)count )
+               return false;
+            const operation_history_object* op_hist = db.find( operation_id );
+            if( op_hist == nullptr )
             {
-               node = &node->next(db);
-               continue;
+               complete = true;
+               return false;
             }
-            try
-            {
-               result.push_back(listtransactions_result{op_hist.op.get<transfer_operation>(),
-                                                        (int)(current_block - op_hist.block_num)});
-            } catch (fc::exception e)
-            { break; }
-         }
-         if (node->next == account_transaction_history_id_type()) {
-            node = nullptr;
+            result.push_back(listtransactions_result{op_hist->op.get<transfer_operation>(),
+                                                     (int)(current_block - op_hist->block_num)});
+            return true;
+         };
+
+         const flat_set<string> address_set( addresses.begin(), addresses.end() );
+         if( addresses.empty() )
+            walk_typed_history( hist_idx, account, { operation::tag<transfer_operation>::value },
+                                std::numeric_limits<uint32_t>::max(), operation_history_id_type(),
+                                [&]( const account_transaction_history_object& node ) {
+                                   return visit( node.operation_id );
+                                });
+         else if( address_set.find( string() ) != address_set.end() )
+         {
+            // the transfers without an address are not in the address index, so every transfer is looked up there
+            const auto& by_seq_idx = address_idx.indices().get<by_seq>();
+            walk_typed_history( hist_idx, account, { operation::tag<transfer_operation>::value },
+                                std::numeric_limits<uint32_t>::max(), operation_history_id_type(),
+                                [&]( const account_transaction_history_object& node ) {
+                                   auto itr = by_seq_idx.find( boost::make_tuple( account, node.sequence ) );
+                                   const string address = ( itr == by_seq_idx.end() ) ? string() : itr->address;
+                                   if( address_set.find( address ) == address_set.end() )
+                                      return true;
+                                   return visit( node.operation_id );
+                                });
          }
          else
+            walk_address_history( address_idx, account, address_set,
+                                  [&]( const account_address_history_object& entry ) {
+                                     return visit( entry.operation_id );
+                                  });
+
+         if( !complete && result.size() < (uint32_t)count )
          {
-            auto f_idx = db.get_index_type<account_transaction_history_index>().indices().get<by_id>().find(node->next);
-            if (f_idx == db.get_index_type<account_transaction_history_index>().indices().get<by_id>().end()) {
-               node = nullptr;
-            }
-            else {
-               node = &(*f_idx);
-            }
+            walk_cold_operations( cold_store(), hist_idx, account, { operation::tag<transfer_operation>::value },
+                                  operation_history_id_type(), operation_history_id_type(),
+                                  [&]( const operation_history_object& op_hist )
+            {
+               if( result.size() >= (uint32_t)count )
+                  return false;
+               const transfer_operation& tr_op = op_hist.op.get<transfer_operation>();
+               if( !address_set.empty() && address_set.find( transfer_address( tr_op ) ) == address_set.end() )
+                  return true;
+               result.push_back(listtransactions_result{tr_op, (int)(current_block - op_hist.block_num)});
+               return true;
+            });
          }
-      }
        
-      return result;
+         return result;
+      } );
    }
 
     vector<operation_history_object> history_api::get_relative_history( account_id_type account, 
@@ -637,77 +950,93 @@ namespace graphene { namespace app {
     {
        FC_ASSERT( _app.chain_database() );
        const auto& db = *_app.chain_database();
-       FC_ASSERT(limit <= 100);
-       vector<operation_history_object> result;
-       if( start == 0 )
-         start = account(db).statistics(db).total_ops;
-       else start = min( account(db).statistics(db).total_ops, start );
-       const auto& hist_idx = db.get_index_type<account_transaction_history_index>();
-       const auto& by_seq_idx = hist_idx.indices().get<by_seq>();
-       
-       auto itr = by_seq_idx.upper_bound( boost::make_tuple( account, start ) );
-       auto itr_stop = by_seq_idx.lower_bound( boost::make_tuple( account, stop ) );
-       --itr;
-       
-       while ( itr != itr_stop && result.size() < limit )
-       {
-          try
+       return read_only( _app.get_api_reader_pool(), [&]() {
+          FC_ASSERT(limit <= 100);
+          vector<operation_history_object> result;
+          if( start == 0 )
+            start = account(db).statistics(db).total_ops;
+          else start = min( account(db).statistics(db).total_ops, start );
+          const auto& hist_idx = db.get_index_type<account_transaction_history_index>();
+          bool complete = false;
+          walk_history( hist_idx, account, seek_history_by_seq( hist_idx, account, start ), operation_history_id_type(),
+                        [&]( const account_transaction_history_object& node )
           {
-             operation_history_object op_h = itr->operation_id(db);
-             reserve_op(op_h);
-             result.push_back(std::move(op_h));
-          } catch(fc::exception e) { break; }
-          --itr;
-       }
-       
-       return result;
+             if( node.sequence <= stop )
+             {
+                complete = true;
+                return false;
+             }
+             if( result.size() >= limit )
+                return false;
+             try
+             {
+                operation_history_object op_h = node.operation_id(db);
+                reserve_op(op_h);
+                result.push_back(std::move(op_h));
+             } catch( const fc::exception& ) { complete = true; return false; }
+             return true;
+          });
+
+          const cold_history_reader* store = cold_store();
+          if( store != nullptr && !complete && result.size() < limit )
+          {
+             walk_cold_history( *store, account, std::min( oldest_memory_sequence( hist_idx, account ), start + 1 ),
+                                operation_history_id_type(), operation_history_id_type(),
+                                [&]( const cold_history_entry& e )
+             {
+                if( e.sequence <= stop || result.size() >= limit )
+                   return false;
+                operation_history_object op_h = store->read( e );
+                reserve_op(op_h);
+                result.push_back(std::move(op_h));
+                return true;
+             });
+          }
+
+          return result;
+       } );
     }
 
     vector<operation_history_object>
     history_api::get_account_operation_history(account_id_type account, unsigned operation_type, unsigned limit) const
     {
       FC_ASSERT( _app.chain_database() );
-      const auto& db = *_app.chain_database();       
-      FC_ASSERT( limit <= 100 );
+      const auto& db = *_app.chain_database();
+      return read_only( _app.get_api_reader_pool(), [&]() {
+         FC_ASSERT( limit <= 100 );
 
-      vector<operation_history_object> result;
-      const auto& stats = account(db).statistics(db);
-      if( stats.most_recent_op == account_transaction_history_id_type() ) { return result; }
+         vector<operation_history_object> result;
+         if( operation_type > std::numeric_limits<uint16_t>::max() )
+            return result;
+         bool complete = false;
+         auto visit = [&]( const operation_history_object& hist )
+         {
+           if( result.size() >= limit )
+              return false;
+           operation_history_object op_h = hist;
+           reserve_op(op_h);
+           result.push_back(std::move(op_h));
+           return true;
+         };
+
+         const auto& hist_idx = db.get_index_type<account_transaction_history_index>();
+         walk_typed_history( hist_idx, account, { uint16_t(operation_type) }, std::numeric_limits<uint32_t>::max(),
+                             operation_history_id_type(), [&]( const account_transaction_history_object& node )
+         {
+           const operation_history_object* hist = db.find( node.operation_id );
+           if( hist == nullptr )
+           {
+              complete = true;
+              return false;
+           }
+           return visit( *hist );
+         });
+         if( !complete && result.size() < limit )
+            walk_cold_operations( cold_store(), hist_idx, account, { uint16_t(operation_type) },
+                                  operation_history_id_type(), operation_history_id_type(), visit );
 
-      if (!db.find(stats.most_recent_op)) {
          return result;
-      }
-      const account_transaction_history_object* node = &stats.most_recent_op(db);
-
-      while (node && result.size() < limit)
-      {
-        try
-        {
-          const operation_history_object& hist = node->operation_id(db);
-          if ((unsigned)hist.op.which() == operation_type)
-          {
-             operation_history_object op_h = hist;
-             reserve_op(op_h);
-             result.push_back(std::move(op_h));
-          }
-        }
-        catch(fc::exception e) { break; }
-        if ( node->next == account_transaction_history_id_type() ) {
-           node = nullptr;
-        }
-        else
-        {
-           auto f_idx = db.get_index_type<account_transaction_history_index>().indices().get<by_id>().find(node->next);
-           if (f_idx == db.get_index_type<account_transaction_history_index>().indices().get<by_id>().end()) {
-              node = nullptr;
-           }
-           else {
-              node = &(*f_idx);
-           }
-        }
-      }
-      
-      return result;
+      } );
     }
 
     vector<operation_history_object> history_api::get_account_operation_history2(
@@ -718,54 +1047,42 @@ namespace graphene { namespace app {
        , unsigned operation_type) const
     { 
       FC_ASSERT( _app.chain_database() );
-      const auto& db = *_app.chain_database();       
-      FC_ASSERT( limit <= 100 );
-      vector<operation_history_object> result;
-      const auto& stats = account(db).statistics(db);
-
-      if (stats.most_recent_op == account_transaction_history_id_type()) { return result; }
-
-      if (!db.find(stats.most_recent_op)) {
-         return result;
-      }
-      const account_transaction_history_object* node = &stats.most_recent_op(db);
-
-      if (start == operation_history_id_type()) {
-         start = node->operation_id;
-      }
+      const auto& db = *_app.chain_database();
+      return read_only( _app.get_api_reader_pool(), [&]() {
+         FC_ASSERT( limit <= 100 );
+         vector<operation_history_object> result;
+         if( operation_type > std::numeric_limits<uint16_t>::max() )
+            return result;
 
-      while (node && (node->operation_id.instance.value > stop.instance.value) && (result.size() < limit))
-      {
-        try
-        {
-          auto& hist = node->operation_id(db);
-          if (node->operation_id.instance.value <= start.instance.value)
-          {
-             if ((unsigned)hist.op.which() == operation_type)
-             {
-                operation_history_object op_h = hist;
-                reserve_op(op_h);
-                result.push_back(std::move(op_h));
-             }
-          }
-        }
-        catch(fc::exception e) { break; }
-        if (node->next == account_transaction_history_id_type()) {
-           node = nullptr;
-        }
-        else
-        {
-           auto f_idx = db.get_index_type<account_transaction_history_index>().indices().get<by_id>().find(node->next);
-           if (f_idx == db.get_index_type<account_transaction_history_index>().indices().get<by_id>().end()) {
-              node = nullptr;
-           }
-           else {
-              node = &(*f_idx);
+         bool complete = false;
+         auto visit = [&]( const operation_history_object& hist )
+         {
+           if( result.size() >= limit )
+              return false;
+           operation_history_object op_h = hist;
+           reserve_op(op_h);
+           result.push_back(std::move(op_h));
+           return true;
+         };
+
+         const auto& hist_idx = db.get_index_type<account_transaction_history_index>();
+         walk_typed_history( hist_idx, account, { uint16_t(operation_type) },
+                             history_start_sequence( hist_idx, account, start ), stop,
+                             [&]( const account_transaction_history_object& node )
+         {
+           const operation_history_object* hist = db.find( node.operation_id );
+           if( hist == nullptr )
+           {
+              complete = true;
+              return false;
            }
-        }
-      }
+           return visit( *hist );
+         });
+         if( !complete && result.size() < limit )
+            walk_cold_operations( cold_store(), hist_idx, account, { uint16_t(operation_type) }, start, stop, visit );
 
-      return result;
+         return result;
+      } );
    }
 
    vector<operation_history_object> history_api::get_account_operation_history3(
@@ -777,65 +1094,46 @@ namespace graphene { namespace app {
    {
       FC_ASSERT( _app.chain_database() );
       const auto& db = *_app.chain_database();
-      FC_ASSERT( limit <= 100 );
-      vector<operation_history_object> result;
-      const auto& stats = account_id(db).statistics(db);
-
-      if (stats.most_recent_op == account_transaction_history_id_type()) { return result; }
-
-      if (!db.find(stats.most_recent_op)) {
-         return result;
-      }
-      const account_transaction_history_object* node = &stats.most_recent_op(db);
+      return read_only( _app.get_api_reader_pool(), [&]() {
+         FC_ASSERT( limit <= 100 );
+         vector<operation_history_object> result;
 
-      if (start == operation_history_id_type()) {
-         start = node->operation_id;
-      }
-
-      while (node && (node->operation_id.instance.value > stop.instance.value) && (result.size() < limit))
-      {
-         try
+         bool complete = false;
+         auto visit = [&]( const operation_history_object& hist )
          {
-            operation_history_object hist = node->operation_id(db);
-            reserve_op(hist);
+            if( result.size() >= limit )
+               return false;
 
-            if (node->operation_id.instance.value <= start.instance.value)
-            {
-               std::for_each(operation_types.begin(), operation_types.end(), [&account_id, &hist, &result](const uint16_t& op_type)
-               {
-                  if ((unsigned)hist.op.which() == op_type)
-                  {
-                     // fund_payment_operation
-                     if (hist.op.which() == operation::tag<fund_payment_operation>::value)
-                     {
-                        if (hist.op.get<fund_payment_operation>().issue_to_account == account_id) {
-                           result.push_back(std::move(hist));
-                        }
-                     }
-                     else {
-                        result.push_back(std::move(hist));
-                     }
-                  }
-               });
+            // fund_payment_operation
+            if (hist.op.which() == operation::tag<fund_payment_operation>::value
+                && hist.op.get<fund_payment_operation>().issue_to_account != account_id) {
+               return true;
             }
-         }
-         catch(fc::exception e) { break; }
-         if (node->next == account_transaction_history_id_type()) {
-            node = nullptr;
-         }
-         else
+            operation_history_object op_h = hist;
+            reserve_op(op_h);
+            result.push_back(std::move(op_h));
+            return true;
+         };
+
+         const flat_set<uint16_t> types( operation_types.begin(), operation_types.end() );
+         const auto& hist_idx = db.get_index_type<account_transaction_history_index>();
+         walk_typed_history( hist_idx, account_id, types, history_start_sequence( hist_idx, account_id, start ), stop,
+                             [&]( const account_transaction_history_object& node )
          {
-            auto f_idx = db.get_index_type<account_transaction_history_index>().indices().get<by_id>().find(node->next);
-            if (f_idx == db.get_index_type<account_transaction_history_index>().indices().get<by_id>().end()) {
-               node = nullptr;
-            }
-            else {
-               node = &(*f_idx);
+            const operation_history_object* hist = db.find( node.operation_id );
+            if( hist == nullptr )
+            {
+               complete = true;
+               return false;
             }
-         }
-      }
+            return visit( *hist );
+         });
+         // an empty list of types selects no operation in memory either
+         if( !complete && !types.empty() && result.size() < limit )
+            walk_cold_operations( cold_store(), hist_idx, account_id, types, start, stop, visit );
 
-      return result;
+         return result;
+      } );
    }
 
    vector<operation_history_object> history_api::get_account_operation_history4(
@@ -846,64 +1144,108 @@ namespace graphene { namespace app {
    {
       FC_ASSERT( _app.chain_database() );
       const auto& db = *_app.chain_database();
-      FC_ASSERT( limit <= 100 );
-      vector<operation_history_object> result;
-      result.reserve(limit);
+      return read_only( _app.get_api_reader_pool(), [&]() {
+         FC_ASSERT( limit <= 100 );
+         vector<operation_history_object> result;
+         result.reserve(limit);
+
+         // only transfers to or from the account are supported
+         const uint16_t transfer_type = operation::tag<transfer_operation>::value;
+         if( std::find( operation_types.begin(), operation_types.end(), transfer_type ) == operation_types.end() ) {
+            return result;
+         }
+
+         auto is_valid_operation = [&account]( const operation_history_object& op ) -> bool
+         {
+            if( op.op.which() != operation::tag<transfer_operation>::value )
+               return false;
+            const transfer_operation& tr_op = op.op.get<transfer_operation>();
+            return (tr_op.from == account) || (tr_op.to == account);
+         };
+
+         const auto& hist_idx = db.get_index_type<account_transaction_history_index>();
+         const auto& by_seq_idx = hist_idx.indices().get<by_seq>();
+         auto oldest = by_seq_idx.lower_bound( boost::make_tuple( account ) );
+         const bool in_memory = oldest != by_seq_idx.end() && oldest->account == account;
+
+         // The entries trimmed from memory continue the typed index if the cold store holds all of them
+         const cold_history_reader* store = cold_store();
+         const vector<cold_history_entry>* cold_entries = nullptr;
+         if( store != nullptr && !store->entries( account ).empty() )
+         {
+            const vector<cold_history_entry>& entries = store->entries( account );
+            const uint32_t next_sequence = in_memory ? oldest->sequence : account(db).statistics(db).total_ops + 1;
+            if( entries.front().sequence == 1 && entries.back().sequence + 1 >= next_sequence )
+               cold_entries = &entries;
+         }
 
-      const auto& idx = db.get_index_type<operation_history_index>().indices().get<by_id>();
-      auto itr = idx.begin();
+         if( start != operation_history_id_type() && db.find( start ) == nullptr && cold_entries == nullptr ) { return result; }
 
-      auto is_valid_operation = [&operation_types, &account](const operation_history_object& op) -> bool
-      {
-         for (const uint16_t& op_type: operation_types)
+         // The typed index holds the history of the account from its oldest entry on. It covers the whole range only
+         // if nothing was trimmed before start or the trimmed entries are in the cold store; otherwise, and for
+         // accounts that are not tracked, all stored operations are scanned as before the index existed.
+         const bool covered = cold_entries != nullptr
+                              || ( in_memory
+                                   && ( oldest->sequence == 1
+                                        || ( start != operation_history_id_type()
+                                             && oldest->operation_id.instance.value <= start.instance.value ) ) );
+
+         if( !covered )
          {
-            if ((unsigned)op.op.which() == op_type)
+            const auto& idx = db.get_index_type<operation_history_index>().indices().get<by_id>();
+            auto itr = ( start == operation_history_id_type() ) ? idx.begin() : idx.find( start );
+            for( ; itr != idx.end() && result.size() < limit; ++itr )
             {
-               // transfer operation
-               if (op.op.which() == operation::tag<transfer_operation>::value)
-               {
-                  const transfer_operation& tr_op = op.op.get<transfer_operation>();
-                  if ((tr_op.from == account) || (tr_op.to == account)) {
-                     return true;
-                  }
-               }
-               // ...
+               if( is_valid_operation( *itr ) )
+                  result.emplace_back( *itr );
             }
+            return result;
          }
-         return false;
-      };
 
-      if (start == operation_history_id_type())
-      {
-         while (itr != idx.end())
+         if( cold_entries != nullptr )
          {
-            // find first valid operation
-            if (is_valid_operation(*itr)) {
-               break;
+            // the operation ids grow with the sequence, so the transfers from start on follow the first one not before it
+            auto cold_itr = std::lower_bound( cold_entries->begin(), cold_entries->end(), start.instance.value,
+                                              []( const cold_history_entry& e, uint64_t id )
+                                              { return e.operation_id.instance.value < id; } );
+            const uint32_t next_sequence = in_memory ? oldest->sequence : std::numeric_limits<uint32_t>::max();
+            for( ; cold_itr != cold_entries->end() && cold_itr->sequence < next_sequence && result.size() < limit;
+                 ++cold_itr )
+            {
+               if( cold_itr->op_type != transfer_type )
+                  continue;
+               operation_history_object op = store->read( *cold_itr );
+               if( is_valid_operation( op ) )
+                  result.emplace_back( std::move( op ) );
             }
-            ++itr;
+            if( !in_memory || result.size() >= limit ) { return result; }
          }
-      }
-      else
-      {
-         itr = idx.find(start);
-         if (itr == idx.end()) { return result; }
-      }
-
-      while (itr != idx.end())
-      {
-         if (result.size() == limit) { break;}
 
-         const operation_history_object& op = *itr;
+         const auto& by_type_idx = hist_idx.indices().get<by_type_seq>();
+         auto itr = by_type_idx.lower_bound( boost::make_tuple( account, transfer_type ) );
+         const auto end = by_type_idx.upper_bound( boost::make_tuple( account, transfer_type ) );
 
-         if (is_valid_operation(op)) {
-            result.emplace_back(op);
+         if (start != operation_history_id_type())
+         {
+            // the transfers of the account from start on, found on the sequence of the first operation not before start
+            const auto& by_op_idx = hist_idx.indices().get<by_op>();
+            auto op_itr = by_op_idx.lower_bound( boost::make_tuple( account, start ) );
+            if( op_itr == by_op_idx.end() || op_itr->account != account ) { return result; }
+            itr = by_type_idx.lower_bound( boost::make_tuple( account, transfer_type, op_itr->sequence ) );
          }
 
-         ++itr;
-      }
+         for( ; itr != end && result.size() < limit; ++itr )
+         {
+            const operation_history_object* op = db.find( itr->operation_id );
+            if( op == nullptr ) { break; }
 
-      return result;
+            if( is_valid_operation( *op ) ) {
+               result.emplace_back(*op);
+            }
+         }
+
+         return result;
+      } );
    }
 
    vector<operation_history_object> history_api::get_account_leasing_history(
@@ -914,105 +1256,100 @@ namespace graphene { namespace app {
    {
       FC_ASSERT( _app.chain_database() );
       const auto& db = *_app.chain_database();
-      FC_ASSERT( limit <= 100 );
-      vector<operation_history_object> result;
-      const auto& stats = account_id(db).statistics(db);
+      return read_only( _app.get_api_reader_pool(), [&]() {
+         FC_ASSERT( limit <= 100 );
+         vector<operation_history_object> result;
 
-      if (stats.most_recent_op == account_transaction_history_id_type()) { return result; }
-
-      if (!db.find(stats.most_recent_op)) {
-         return result;
-      }
-      const account_transaction_history_object* node = &stats.most_recent_op(db);
-
-      if (start == operation_history_id_type()) {
-         start = node->operation_id;
-      }
-
-      auto set_fund_validation = [&](const fund_id_type& fund_id, bool& status)
-      {
-         auto&& itr = std::find_if(funds.begin(), funds.end(), [&fund_id](const fund_id_type& item){
-            return (item == fund_id);
-         });
-         if (itr != funds.end()) {
-            status = true;
-         }
-      };
+         auto set_fund_validation = [&](const fund_id_type& fund_id, bool& status)
+         {
+            auto&& itr = std::find_if(funds.begin(), funds.end(), [&fund_id](const fund_id_type& item){
+               return (item == fund_id);
+            });
+            if (itr != funds.end()) {
+               status = true;
+            }
+         };
 
-      while (node && (result.size() < limit))
-      {
-         try
+         auto visit = [&]( const operation_history_object& node_hist )
          {
-            operation_history_object hist = node->operation_id(db);
+            if( result.size() >= limit )
+               return false;
+            operation_history_object hist = node_hist;
             reserve_op(hist);
 
-            if (node->operation_id.instance.value <= start.instance.value)
-            {
-               const auto& op = hist.op.which();
+            const auto& op = hist.op.which();
 
-               bool fund_is_valid = false;
-               bool account_is_valid = false;
+            bool fund_is_valid = false;
+            bool account_is_valid = false;
 
-               if (op == operation::tag<fund_update_operation>::value)
-               {
-                  const fund_update_operation& inner_op = hist.op.get<fund_update_operation>();
+            if (op == operation::tag<fund_update_operation>::value)
+            {
+               const fund_update_operation& inner_op = hist.op.get<fund_update_operation>();
 
-                  set_fund_validation(inner_op.id, fund_is_valid);
-                  if (fund_is_valid && (inner_op.from_account == account_id)) {
-                     account_is_valid = true;
-                  }
-               }
-               else if (op == operation::tag<fund_deposit_operation>::value)
-               {
-                  const fund_deposit_operation& inner_op = hist.op.get<fund_deposit_operation>();
-
-                  set_fund_validation(inner_op.fund_id, fund_is_valid);
-                  if (fund_is_valid && (inner_op.from_account == account_id)) {
-                     account_is_valid = true;
-                  }
+               set_fund_validation(inner_op.id, fund_is_valid);
+               if (fund_is_valid && (inner_op.from_account == account_id)) {
+                  account_is_valid = true;
                }
-               else if (op == operation::tag<fund_withdrawal_operation>::value)
-               {
-                  const fund_withdrawal_operation& inner_op = hist.op.get<fund_withdrawal_operation>();
-
-                  set_fund_validation(inner_op.fund_id, fund_is_valid);
-                  if (fund_is_valid && (inner_op.issue_to_account == account_id)) {
-                     account_is_valid = true;
-                  }
+            }
+            else if (op == operation::tag<fund_deposit_operation>::value)
+            {
+               const fund_deposit_operation& inner_op = hist.op.get<fund_deposit_operation>();
+
+               set_fund_validation(inner_op.fund_id, fund_is_valid);
+               if (fund_is_valid && (inner_op.from_account == account_id)) {
+                  account_is_valid = true;
                }
-               else if (op == operation::tag<fund_payment_operation>::value)
-               {
-                  const fund_payment_operation& inner_op = hist.op.get<fund_payment_operation>();
-
-                  set_fund_validation(inner_op.fund_id, fund_is_valid);
-                  if (fund_is_valid && (inner_op.issue_to_account == account_id)) {
-                     account_is_valid = true;
-                  }
+            }
+            else if (op == operation::tag<fund_withdrawal_operation>::value)
+            {
+               const fund_withdrawal_operation& inner_op = hist.op.get<fund_withdrawal_operation>();
+
+               set_fund_validation(inner_op.fund_id, fund_is_valid);
+               if (fund_is_valid && (inner_op.issue_to_account == account_id)) {
+                  account_is_valid = true;
                }
+            }
+            else if (op == operation::tag<fund_payment_operation>::value)
+            {
+               const fund_payment_operation& inner_op = hist.op.get<fund_payment_operation>();
 
-               if (account_is_valid && fund_is_valid) {
-                  result.push_back(std::move(hist));
+               set_fund_validation(inner_op.fund_id, fund_is_valid);
+               if (fund_is_valid && (inner_op.issue_to_account == account_id)) {
+                  account_is_valid = true;
                }
             }
-         }
-         catch(fc::exception e) { break; }
 
-         if (node->next == account_transaction_history_id_type()) {
-            node = nullptr;
-         }
-         else
-         {
-            auto f_idx = db.get_index_type<account_transaction_history_index>().indices().get<by_id>().find(node->next);
-            if (f_idx == db.get_index_type<account_transaction_history_index>().indices().get<by_id>().end()) {
-               node = nullptr;
+            if (account_is_valid && fund_is_valid) {
+               result.push_back(std::move(hist));
             }
-            else {
-               node = &(*f_idx);
+            return true;
+         };
+
+         bool complete = false;
+         const auto& hist_idx = db.get_index_type<account_transaction_history_index>();
+         walk_history( hist_idx, account_id, seek_history( hist_idx, account_id, start ), operation_history_id_type(),
+                       [&]( const account_transaction_history_object& node )
+         {
+            const operation_history_object* hist = db.find( node.operation_id );
+            if( hist == nullptr )
+            {
+               complete = true;
+               return false;
             }
+            return visit( *hist );
+         });
+         if( !complete && result.size() < limit )
+         {
+            const flat_set<uint16_t> fund_types = { operation::tag<fund_update_operation>::value,
+                                                    operation::tag<fund_deposit_operation>::value,
+                                                    operation::tag<fund_withdrawal_operation>::value,
+                                                    operation::tag<fund_payment_operation>::value };
+            walk_cold_operations( cold_store(), hist_idx, account_id, fund_types, start, operation_history_id_type(),
+                                  visit );
          }
-      }
 
-      return result;
+         return result;
+      } );
    }
 
    vector<operation_history_object> history_api::get_fund_history(fund_id_type fund_id
@@ -1023,53 +1360,29 @@ namespace graphene { namespace app {
    { try {
       FC_ASSERT( _app.chain_database() );
       const auto& db = *_app.chain_database();
-      FC_ASSERT( limit <= 100 );
-      vector<operation_history_object> result;
-      const auto& stats = fund_id(db).statistics_id(db);
-
-      if (stats.most_recent_op == fund_transaction_history_id_type()) { return result; }
-
-      if (!db.find(stats.most_recent_op)) {
-         return result;
-      }
-      const fund_transaction_history_object* node = &stats.most_recent_op(db);
-
-      if (start == operation_history_id_type()) {
-         start = node->operation_id;
-      }
+      return read_only( _app.get_api_reader_pool(), [&]() {
+         FC_ASSERT( limit <= 100 );
+         vector<operation_history_object> result;
 
-      while (node && (node->operation_id.instance.value > stop.instance.value) && (result.size() < limit))
-      {
-         try
+         const auto& hist_idx = db.get_index_type<fund_transaction_history_index>();
+         walk_history( hist_idx, fund_id, seek_history( hist_idx, fund_id, start ), stop,
+                       [&]( const fund_transaction_history_object& node )
          {
-            auto& hist = node->operation_id(db);
-            if (node->operation_id.instance.value <= start.instance.value)
+            if( result.size() >= limit )
+               return false;
+            try
             {
-               std::for_each(operation_types.begin(), operation_types.end(), [&hist, &result](const uint16_t& op_type)
-               {
-                  if ((unsigned) hist.op.which() == op_type) {
-                     result.push_back(hist);
-                  }
-               });
-            }
-         }
-         catch(fc::exception e) { break; }
-         if (node->next == fund_transaction_history_id_type()) {
-            node = nullptr;
-         }
-         else
-         {
-            auto f_idx = db.get_index_type<fund_transaction_history_index>().indices().get<by_id>().find(node->next);
-            if (f_idx == db.get_index_type<fund_transaction_history_index>().indices().get<by_id>().end()) {
-               node = nullptr;
-            }
-            else {
-               node = &(*f_idx);
+               const operation_history_object& hist = node.operation_id(db);
+               if( std::find( operation_types.begin(), operation_types.end(), hist.op.which() ) != operation_types.end() ) {
+                  result.push_back(hist);
+               }
             }
-         }
-      }
+            catch( const fc::exception& ) { return false; }
+            return true;
+         });
 
-      return result;
+         return result;
+      } );
    } FC_CAPTURE_AND_RETHROW( (fund_id)(stop)(limit)(start)(operation_types) ) }
 
    vector<fund_history_object::history_item>
@@ -1077,25 +1390,52 @@ namespace graphene { namespace app {
    { try {
       FC_ASSERT( _app.chain_database() );
       const auto& db = *_app.chain_database();
-      FC_ASSERT( limit <= 100 );
+      return read_only( _app.get_api_reader_pool(), [&]() {
+         FC_ASSERT( limit <= 100 );
 
-      vector<fund_history_object::history_item> result;
-      result.reserve(limit);
+         vector<fund_history_object::history_item> result;
+         result.reserve(limit);
 
-      const auto& hist = fund_id(db).history_id(db);
+         const auto& hist_idx = db.get_index_type<fund_history_item_index>().indices().get<by_fund_datetime>();
+         auto range = hist_idx.equal_range(fund_id);
 
-      std::vector<fund_history_object::history_item>::const_reverse_iterator rit = hist.items.rbegin();
-      for (size_t i = 0; rit != hist.items.crend(); ++rit, ++i)
-      {
-         if ( (i >= start) && (result.size() < limit) ) {
-            result.emplace_back(*rit);
+         // newest items first
+         auto rit = std::make_reverse_iterator(range.second);
+         const auto rend = std::make_reverse_iterator(range.first);
+         for (uint32_t i = 0; (rit != rend) && (i < start); ++rit, ++i);
+         for (; (rit != rend) && (result.size() < limit); ++rit) {
+            result.emplace_back(rit->get_item());
          }
-         if (result.size() == limit) { break; }
-      }
 
-      return result;
+         return result;
+      } );
    } FC_CAPTURE_AND_RETHROW( (fund_id)(start)(limit) ) }
 
+   vector<fund_history_object::history_item>
+   history_api::list_fund_payments_history(fund_id_type fund_id, fc::time_point before, uint32_t limit) const
+   { try {
+      FC_ASSERT( _app.chain_database() );
+      const auto& db = *_app.chain_database();
+      return read_only( _app.get_api_reader_pool(), [&]() {
+         FC_ASSERT( limit <= 100 );
+
+         vector<fund_history_object::history_item> result;
+         result.reserve(limit);
+
+         // newest items first, from the last one created before the cursor
+         const auto& hist_idx = db.get_index_type<fund_history_item_index>().indices().get<by_fund_datetime>();
+         const auto first = hist_idx.lower_bound(boost::make_tuple(fund_id));
+         auto itr = (before == fc::time_point()) ? hist_idx.upper_bound(boost::make_tuple(fund_id))
+                                                 : hist_idx.lower_bound(boost::make_tuple(fund_id, before));
+         while (itr != first && result.size() < limit) {
+            --itr;
+            result.emplace_back(itr->get_item());
+         }
+
+         return result;
+      } );
+   } FC_CAPTURE_AND_RETHROW( (fund_id)(before)(limit) ) }
+
    flat_set<uint32_t> history_api::get_market_history_buckets()const
    {
       auto hist = _app.get_plugin<market_history_plugin>( "market_history" );
@@ -1108,25 +1448,26 @@ namespace graphene { namespace app {
    { try {
       FC_ASSERT(_app.chain_database());
       const auto& db = *_app.chain_database();
-      vector<bucket_object> result;
-      result.reserve(200);
+      return read_only( _app.get_api_reader_pool(), [&]() {
+         vector<bucket_object> result;
+         result.reserve(200);
 
-      if (a > b) std::swap(a,b);
+         if (a > b) std::swap(a,b);
 
-      const auto& bidx = db.get_index_type<bucket_index>();
-      const auto& by_key_idx = bidx.indices().get<by_key>();
+         const auto& bidx = db.get_index_type<bucket_index>();
+         const auto& by_key_idx = bidx.indices().get<by_key>();
 
-      auto itr = by_key_idx.lower_bound( bucket_key( a, b, bucket_seconds, start ) );
-      while( itr != by_key_idx.end() && itr->key.open <= end && result.size() < 200 )
-      {
-         if (!(itr->key.base == a && itr->key.quote == b && itr->key.seconds == bucket_seconds)) {
-            return result;
+         auto itr = by_key_idx.lower_bound( bucket_key( a, b, bucket_seconds, start ) );
+         while( itr != by_key_idx.end() && itr->key.open <= end && result.size() < 200 )
+         {
+            if (!(itr->key.base == a && itr->key.quote == b && itr->key.seconds == bucket_seconds)) {
+               return result;
+            }
+            result.push_back(*itr);
+            ++itr;
          }
-         result.push_back(*itr);
-         ++itr;
-      }
-      return result;
-
+         return result;
+      } );
    } FC_CAPTURE_AND_RETHROW( (a)(b)(bucket_seconds)(start)(end) ) }
 
    fc::variants secure_api::get_objects(const vector<object_id_type>& ids) const
@@ -1188,6 +1529,29 @@ namespace graphene { namespace app {
       return result;
    }
 
+   std::vector<cheque_object>
+   secure_api::list_account_cheques(account_id_type account_id, cheque_id_type start, uint32_t limit) const
+   {
+      FC_ASSERT(_app.chain_database());
+      FC_ASSERT(limit <= 100);
+      const auto& db = *_app.chain_database();
+
+      return read_only( _app.get_api_reader_pool(), [&]() {
+         std::vector<cheque_object> result;
+         const auto& idx = dynamic_cast<const primary_index<cheque_index>&>(db.get_index_type<cheque_index>());
+         const auto& cheques = idx.get_secondary_index<cheque_account_index>().cheques_by_account;
+         auto account_cheques = cheques.find(account_id);
+         if (account_cheques == cheques.end())
+            return result;
+
+         const auto& ids = account_cheques->second;
+         auto itr = start == cheque_id_type() ? ids.end() : ids.upper_bound(start);
+         while (itr != ids.begin() && result.size() < limit)
+            result.emplace_back((*--itr)(db));
+         return result;
+      } );
+   }
+
    std::vector<blind_transfer2_object>
    secure_api::get_account_blind_transfers2(account_id_type account_id, uint32_t start, uint32_t limit) const
    {
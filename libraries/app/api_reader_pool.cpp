@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/app/api_reader_pool.hpp>
+
+namespace graphene { namespace app {
+
+api_reader_pool::api_reader_pool( const graphene::chain::database& db, uint16_t thread_count )
+   : _db(db)
+{
+   FC_ASSERT( thread_count > 0 );
+   for( uint16_t i = 0; i < thread_count; ++i )
+      _threads.emplace_back( new fc::thread( "api reader " + std::to_string(i) ) );
+}
+
+api_reader_pool::~api_reader_pool()
+{
+   for( auto& thread : _threads )
+      thread->quit();
+}
+
+bool api_reader_pool::is_reader_thread()const
+{
+   const fc::thread* current = &fc::thread::current();
+   for( const auto& thread : _threads )
+      if( thread.get() == current )
+         return true;
+   return false;
+}
+
+fc::thread& api_reader_pool::next_thread()
+{
+   return *_threads[ _next++ % _threads.size() ];
+}
+
+} } // graphene::app
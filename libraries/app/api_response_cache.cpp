@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/app/api_response_cache.hpp>
+
+#include <map>
+
+namespace graphene { namespace app {
+
+namespace {
+
+std::mutex registry_mutex;
+std::map<const graphene::chain::database*, std::shared_ptr<api_response_cache>> registry;
+
+} // anonymous namespace
+
+api_response_cache::api_response_cache( graphene::chain::database& db, uint32_t max_entries )
+   : _db(db), _max_entries(max_entries)
+{
+   FC_ASSERT( max_entries > 0 );
+   _info.enabled = true;
+   _head_block = db.head_block_id();
+   _applied_block_connection = db.applied_block.connect( [this]( const signed_block& ) { invalidate(); } );
+   _pending_transaction_connection = db.on_pending_transaction.connect( [this]( const signed_transaction& ) {
+      invalidate();
+   });
+}
+
+void api_response_cache::install( const std::shared_ptr<api_response_cache>& cache )
+{
+   std::lock_guard<std::mutex> guard( registry_mutex );
+   registry[&cache->_db] = cache;
+}
+
+void api_response_cache::uninstall( const graphene::chain::database& db )
+{
+   std::lock_guard<std::mutex> guard( registry_mutex );
+   registry.erase( &db );
+}
+
+std::shared_ptr<api_response_cache> api_response_cache::get( const graphene::chain::database& db )
+{
+   std::lock_guard<std::mutex> guard( registry_mutex );
+   auto itr = registry.find( &db );
+   return itr == registry.end() ? std::shared_ptr<api_response_cache>() : itr->second;
+}
+
+response_cache_info api_response_cache::get_info()const
+{
+   std::lock_guard<std::mutex> guard( _mutex );
+   response_cache_info info = _info;
+   info.entries = _entries.size();
+   return info;
+}
+
+std::shared_ptr<const void> api_response_cache::find( const std::string& key, uint64_t& generation )
+{
+   // the head block moves back without a signal when blocks are popped
+   const block_id_type head = _db.head_block_id();
+   std::lock_guard<std::mutex> guard( _mutex );
+   if( head != _head_block )
+   {
+      if( !_entries.empty() )
+         ++_info.invalidations;
+      _entries.clear();
+      _head_block = head;
+      ++_generation;
+   }
+   generation = _generation;
+   auto itr = _entries.find( key );
+   if( itr == _entries.end() )
+   {
+      ++_info.misses;
+      return std::shared_ptr<const void>();
+   }
+   ++_info.hits;
+   return itr->second;
+}
+
+void api_response_cache::store( const std::string& key, uint64_t generation, std::shared_ptr<const void> result )
+{
+   std::lock_guard<std::mutex> guard( _mutex );
+   if( generation != _generation || _entries.size() >= _max_entries )
+      return;
+   _entries.emplace( key, std::move( result ) );
+}
+
+void api_response_cache::invalidate()
+{
+   std::lock_guard<std::mutex> guard( _mutex );
+   if( !_entries.empty() )
+      ++_info.invalidations;
+   _entries.clear();
+   ++_generation;
+}
+
+} } // graphene::app
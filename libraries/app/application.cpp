@@ -23,9 +23,12 @@
  */
 #include <graphene/app/api.hpp>
 #include <graphene/app/api_access.hpp>
+#include <graphene/app/api_reader_pool.hpp>
+#include <graphene/app/api_response_cache.hpp>
 #include <graphene/app/application.hpp>
 #include <graphene/app/plugin.hpp>
 #include <graphene/protocol/fee_schedule.hpp>
+#include <graphene/protocol/signature_cache.hpp>
 #include <graphene/protocol/types.hpp>
 #include <graphene/chain/worker_evaluator.hpp>
 #include <graphene/egenesis/egenesis.hpp>
@@ -170,6 +173,16 @@ namespace graphene { namespace app { namespace detail {
       FC_CAPTURE_AND_RETHROW((endpoint_string))
    }
 
+   /// the session data of the connection owns its APIs, so they must not keep the connection alive
+   static transport_backlog_reader transport_backlog_of( const fc::http::websocket_connection_ptr& c )
+   {
+      std::weak_ptr<fc::http::websocket_connection> weak_c = c;
+      return [weak_c]() -> uint64_t {
+         auto con = weak_c.lock();
+         return con ? con->get_buffered_amount() : 0;
+      };
+   }
+
    void application_impl::reset_websocket_server()
    { try {
       if( !_options->count("rpc-endpoint") )
@@ -181,8 +194,11 @@ namespace graphene { namespace app { namespace detail {
 
       _websocket_server->on_connection([&]( const fc::http::websocket_connection_ptr& c ){
          auto wsc = std::make_shared<fc::rpc::websocket_api_connection>(c, GRAPHENE_NET_MAX_NESTED_OBJECTS);
-         auto login = std::make_shared<graphene::app::login_api>( std::ref(*_self) );
-         auto db_api = std::make_shared<graphene::app::database_api>( std::ref(*_self->chain_database()) );
+         const auto backlog = transport_backlog_of( c );
+         auto login = std::make_shared<graphene::app::login_api>( std::ref(*_self), backlog );
+         auto db_api = std::make_shared<graphene::app::database_api>( std::ref(*_self->chain_database()),
+                                                                      _subscription_queue_limits, backlog,
+                                                                      _api_reader_pool );
          wsc->register_api(fc::api<graphene::app::database_api>(db_api));
          wsc->register_api(fc::api<graphene::app::login_api>(login));
          c->set_session_data( wsc );
@@ -209,8 +225,11 @@ namespace graphene { namespace app { namespace detail {
       _websocket_tls_server->on_connection([&]( const fc::http::websocket_connection_ptr& c )
       {
          auto wsc = std::make_shared<fc::rpc::websocket_api_connection>(c, GRAPHENE_NET_MAX_NESTED_OBJECTS);
-         auto login = std::make_shared<graphene::app::login_api>( std::ref(*_self) );
-         auto db_api = std::make_shared<graphene::app::database_api>( std::ref(*_self->chain_database()) );
+         const auto backlog = transport_backlog_of( c );
+         auto login = std::make_shared<graphene::app::login_api>( std::ref(*_self), backlog );
+         auto db_api = std::make_shared<graphene::app::database_api>( std::ref(*_self->chain_database()),
+                                                                      _subscription_queue_limits, backlog,
+                                                                      _api_reader_pool );
          wsc->register_api(fc::api<graphene::app::database_api>(db_api));
          wsc->register_api(fc::api<graphene::app::login_api>(login));
          c->set_session_data( wsc );
@@ -228,7 +247,7 @@ namespace graphene { namespace app { namespace detail {
          genesis.initial_witness_candidates[i].block_signing_key = init_pubkey;
    }
 
-   void application_impl::startup()
+   void application_impl::open_database()
    { try {
       bool clean = !fc::exists(_data_dir / "blockchain/dblock");
       fc::create_directories(_data_dir / "blockchain/dblock");
@@ -378,6 +397,25 @@ namespace graphene { namespace app { namespace detail {
          ilog( "All transaction signatures will be validated" );
          _force_validate = true;
       }
+   } FC_LOG_AND_RETHROW() }
+
+   void application_impl::startup()
+   { try {
+      open_database();
+
+      if( _options->count("api-reader-threads") && _options->at("api-reader-threads").as<uint16_t>() > 0 )
+      {
+         const uint16_t reader_threads = _options->at("api-reader-threads").as<uint16_t>();
+         ilog( "Running read-only API calls on ${n} reader threads", ("n",reader_threads) );
+         _api_reader_pool = std::make_shared<api_reader_pool>( *_chain_db, reader_threads );
+      }
+
+      if( _options->count("api-response-cache-size") && _options->at("api-response-cache-size").as<uint32_t>() > 0 )
+      {
+         const uint32_t cache_size = _options->at("api-response-cache-size").as<uint32_t>();
+         ilog( "Caching up to ${n} API responses per block", ("n",cache_size) );
+         api_response_cache::install( std::make_shared<api_response_cache>( *_chain_db, cache_size ) );
+      }
 
       if ( _options->count("api-access") ) {
          _apiaccess = fc::json::from_file(_options->at("api-access").as<boost::filesystem::path>()).as<api_access>(20);
@@ -465,7 +503,9 @@ namespace graphene { namespace app { namespace detail {
          // you can help the network code out by throwing a block_older_than_undo_history exception.
          // when the net code sees that, it will stop trying to push blocks from that chain, but
          // leave that peer connected so that they can get sync blocks from us
-         bool result = _chain_db->push_block(blk_msg.block, (_is_block_producer | _force_validate) ? database::skip_nothing : database::skip_transaction_signatures);
+         const uint32_t skip = (_is_block_producer | _force_validate) ? database::skip_nothing : database::skip_transaction_signatures;
+         _chain_db->precompute_parallel( blk_msg.block, skip ).wait();
+         bool result = _chain_db->push_block(blk_msg.block, skip);
 
          // the block was accepted, so we now know all of the transactions contained in the block
          if (!sync_mode)
@@ -506,11 +546,15 @@ namespace graphene { namespace app { namespace detail {
       ++trx_count;
       auto now = fc::time_point::now();
       if( now - last_call > fc::seconds(1) ) {
-         ilog("Got ${c} transactions from network", ("c",trx_count) );
+         const auto stats = signature_cache::instance().get_stats();
+         const uint64_t lookups = stats.hits + stats.misses;
+         ilog("Got ${c} transactions from network, signature cache hit rate ${r}% (${s} keys)",
+              ("c",trx_count)("r", lookups ? stats.hits * 100 / lookups : 0)("s",stats.size) );
          last_call = now;
          trx_count = 0;
       }
 
+      _chain_db->precompute_parallel( transaction_message.trx ).wait();
       _chain_db->push_transaction( transaction_message.trx );
    } FC_CAPTURE_AND_RETHROW( (transaction_message) ) }
 
@@ -858,6 +902,9 @@ application::~application()
    }
    if( my->_chain_db )
    {
+      // calls still running on the pool keep it alive until they return
+      my->_api_reader_pool.reset();
+      api_response_cache::uninstall( *my->_chain_db );
       my->_chain_db->close();
    }
 }
@@ -880,6 +927,23 @@ void application::set_program_options(boost::program_options::options_descriptio
          ("api-access", bpo::value<boost::filesystem::path>(), "JSON file specifying API permissions")
          ("io-threads", bpo::value<uint16_t>()->implicit_value(0), "Number of IO threads, default to 0 for auto-configuration")
          ("replay-blockchain", "Rebuild object graph by replaying all blocks")
+         ("signature-cache-size", bpo::value<uint32_t>()->default_value(GRAPHENE_DEFAULT_SIGNATURE_CACHE_SIZE),
+          "Number of public keys recovered from transaction signatures to keep in memory, 0 to disable the cache")
+         ("api-subscription-queue-max-updates", bpo::value<uint32_t>()->default_value(subscription_queue_limits().max_updates),
+          "Number of notifications an API session may have waiting for delivery before they are dropped")
+         ("api-subscription-queue-max-bytes", bpo::value<uint64_t>()->default_value(subscription_queue_limits().max_bytes),
+          "Size in bytes of the notifications an API session may have waiting for delivery before they are dropped, "
+          "including what its connection has not sent yet")
+         ("api-subscription-queue-max-transport-bytes",
+          bpo::value<uint64_t>()->default_value(subscription_queue_limits().max_transport_bytes),
+          "Notifications are held back while the connection of an API session has more than this many bytes not sent")
+         ("api-subscription-queue-overflow", bpo::value<string>()->default_value("drop"),
+          "What happens to an API session going over its notification queue limits: its queued notifications "
+          "are dropped (drop), or also its subscriptions are cancelled (cancel)")
+         ("api-reader-threads", bpo::value<uint16_t>()->default_value(0),
+          "Number of threads running the read-only API calls next to block application, 0 to run them on the API thread")
+         ("api-response-cache-size", bpo::value<uint32_t>()->default_value(0),
+          "Number of results of frequent read-only API calls kept until the state changes, 0 to disable the cache")
          ;
    command_line_options.add(configuration_file_options);
    command_line_options.add_options()
@@ -928,6 +992,24 @@ void application::initialize(const fc::path& data_dir, const boost::program_opti
       std::exit(EXIT_SUCCESS);
    }
 
+   if( options.count("signature-cache-size") )
+      signature_cache::instance().set_capacity( options.at("signature-cache-size").as<uint32_t>() );
+
+   if( options.count("api-subscription-queue-max-updates") )
+      my->_subscription_queue_limits.max_updates = options.at("api-subscription-queue-max-updates").as<uint32_t>();
+   if( options.count("api-subscription-queue-max-bytes") )
+      my->_subscription_queue_limits.max_bytes = options.at("api-subscription-queue-max-bytes").as<uint64_t>();
+   if( options.count("api-subscription-queue-max-transport-bytes") )
+      my->_subscription_queue_limits.max_transport_bytes =
+            options.at("api-subscription-queue-max-transport-bytes").as<uint64_t>();
+   if( options.count("api-subscription-queue-overflow") )
+   {
+      const string overflow = options.at("api-subscription-queue-overflow").as<string>();
+      FC_ASSERT( overflow == "drop" || overflow == "cancel",
+                 "api-subscription-queue-overflow must be drop or cancel, not ${o}", ("o",overflow) );
+      my->_subscription_queue_limits.cancel_on_overflow = ( overflow == "cancel" );
+   }
+
    if ( options.count("io-threads") )
    {
       const uint16_t num_threads = options["io-threads"].as<uint16_t>();
@@ -935,6 +1017,19 @@ void application::initialize(const fc::path& data_dir, const boost::program_opti
    }
 }
 
+void application::open_database()
+{
+   try {
+   my->open_database();
+   } catch ( const fc::exception& e ) {
+      elog( "${e}", ("e",e.to_detail_string()) );
+      throw;
+   } catch ( ... ) {
+      elog( "unexpected exception" );
+      throw;
+   }
+}
+
 void application::startup()
 {
    try {
@@ -1333,6 +1428,16 @@ fc::optional< api_access_info > application::get_api_access_info( const string&
    return my->get_api_access_info( username );
 }
 
+const subscription_queue_limits& application::get_subscription_queue_limits()const
+{
+   return my->_subscription_queue_limits;
+}
+
+std::shared_ptr<api_reader_pool> application::get_api_reader_pool()const
+{
+   return my->_api_reader_pool;
+}
+
 void application::set_api_access_info(const string& username, api_access_info&& permissions)
 {
    my->set_api_access_info(username, std::move(permissions));
@@ -1359,7 +1464,12 @@ void application::shutdown()
    if( my->_p2p_network )
       my->_p2p_network->close();
    if( my->_chain_db )
+   {
+      // calls still running on the pool keep it alive until they return
+      my->_api_reader_pool.reset();
+      api_response_cache::uninstall( *my->_chain_db );
       my->_chain_db->close();
+   }
 }
 
 void application::initialize_plugins( const boost::program_options::variables_map& options )
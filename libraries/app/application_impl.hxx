@@ -27,6 +27,7 @@ class application_impl : public net::node_delegate
 
       void set_dbg_init_key( genesis_state_type& genesis, const std::string& init_key );
 
+      void open_database();
       void startup();
 
       fc::optional< api_access_info > get_api_access_info(const string& username)const;
@@ -171,6 +172,8 @@ class application_impl : public net::node_delegate
       fc::path _data_dir;
       const bpo::variables_map* _options = nullptr;
       api_access _apiaccess;
+      subscription_queue_limits _subscription_queue_limits;
+      std::shared_ptr<api_reader_pool> _api_reader_pool;
 
       std::shared_ptr<graphene::chain::database>            _chain_db;
       std::shared_ptr<graphene::net::node>                  _p2p_network;
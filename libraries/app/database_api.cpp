@@ -24,6 +24,9 @@
 
 #include "database_api_impl.hxx"
 
+#include <graphene/app/api_reader_pool.hpp>
+#include <graphene/app/api_response_cache.hpp>
+
 #include <graphene/chain/get_config.hpp>
 #include <graphene/chain/settings_object.hpp>
 #include <graphene/protocol/pts_address.hpp>
@@ -53,20 +56,25 @@ namespace graphene { namespace app {
 //                                                                  //
 //////////////////////////////////////////////////////////////////////
 
-database_api::database_api( graphene::chain::database& db )
-   : my( new database_api_impl( db ) ) {}
+database_api::database_api( graphene::chain::database& db, const subscription_queue_limits& limits,
+                            const transport_backlog_reader& transport_backlog,
+                            const std::shared_ptr<api_reader_pool>& reader_pool )
+   : my( new database_api_impl( db, limits, transport_backlog, reader_pool ) )
+{
+   my->_change_dispatcher = object_change_dispatcher::get( db );
+   my->_change_dispatcher->add_session( my );
+}
 
 database_api::~database_api() {}
 
-database_api_impl::database_api_impl( graphene::chain::database& db ):_db(db)
+thread_local vector<vector<char>>* database_api_impl::_collected_subscriptions = nullptr;
+
+database_api_impl::database_api_impl( graphene::chain::database& db, const subscription_queue_limits& limits,
+                                      const transport_backlog_reader& transport_backlog,
+                                      const std::shared_ptr<api_reader_pool>& reader_pool )
+   :_queue_limits(limits),_transport_backlog(transport_backlog),_reader_pool(reader_pool),_db(db)
 {
    wlog("creating database api ${x}", ("x",int64_t(this)) );
-   _change_connection = _db.changed_objects.connect([this](const vector<object_id_type>& ids) {
-                                on_objects_changed(ids);
-                                });
-   _removed_connection = _db.removed_objects.connect([this](const vector<const object*>& objs) {
-                                on_objects_removed(objs);
-                                });
    _applied_block_connection = _db.applied_block.connect([this](const signed_block&){ on_applied_block(); });
 
    _pending_trx_connection = _db.on_pending_transaction.connect([this](const signed_transaction& trx ){
@@ -85,20 +93,18 @@ database_api_impl::~database_api_impl() {
 //////////////////////////////////////////////////////////////////////
 
 fc::variants database_api::get_objects(const vector<object_id_type>& ids) const {
-   return my->get_objects( ids );
+   return my->read_only( [&]() { return my->get_objects( ids ); } );
 }
 
 fc::variants database_api_impl::get_objects(const vector<object_id_type>& ids) const
 {
-   if (_subscribe_callback)
+   // subscribe_to_item() finds out whether there is a subscribe callback on the API thread
+   for (auto id: ids)
    {
-      for (auto id: ids)
-      {
-         if (id.type() == operation_history_object_type && id.space() == protocol_ids) continue;
-         if (id.type() == impl_account_transaction_history_object_type && id.space() == implementation_ids) continue;
+      if (id.type() == operation_history_object_type && id.space() == protocol_ids) continue;
+      if (id.type() == impl_account_transaction_history_object_type && id.space() == implementation_ids) continue;
 
-         this->subscribe_to_item( id );
-      }
+      this->subscribe_to_item( id );
    }
 //   else {
 //      elog( "getObjects without subscribe callback??" );
@@ -190,6 +196,7 @@ void database_api_impl::set_subscribe_callback(std::function<void(const variant&
       param.false_positive_probability = 1.0/10000;
       param.maximum_size = 1024*8*8*2;
       param.compute_optimal_parameters();
+      std::lock_guard<std::mutex> guard( _subscribe_filter_mutex );
       _subscribe_filter = fc::bloom_filter(param);
    }
 }
@@ -199,6 +206,16 @@ void database_api::set_pending_transaction_callback( std::function<void(const va
    my->set_pending_transaction_callback( cb );
 }
 
+void database_api_impl::subscribe_to_packed( const vector<char>& packed )const
+{
+   if( !_subscribe_callback )
+      return;
+
+   std::lock_guard<std::mutex> guard( _subscribe_filter_mutex );
+   if( !_subscribe_filter.contains( packed.data(), packed.size() ) )
+      _subscribe_filter.insert( packed.data(), packed.size() );
+}
+
 void database_api_impl::set_pending_transaction_callback( std::function<void(const variant&)> cb )
 {
    _pending_trx_callback = cb;
@@ -225,6 +242,17 @@ void database_api_impl::cancel_all_subscriptions()
    _market_subscriptions.clear();
 }
 
+subscription_queue_info database_api::get_subscription_queue_info() const
+{
+   return my->get_subscription_queue_info();
+}
+
+subscription_queue_info database_api_impl::get_subscription_queue_info() const
+{
+   std::lock_guard<std::mutex> guard( _queue_mutex );
+   return _queue_info;
+}
+
 //////////////////////////////////////////////////////////////////////
 //                                                                  //
 // Blocks and transactions                                          //
@@ -259,6 +287,7 @@ optional<signed_block> database_api_impl::get_block(uint32_t block_num)
    signed_block b = *block;
    for (processed_transaction& tr: b.transactions) {
       _db.clear_ops(tr.operations);
+      tr.invalidate_cache();
    }
    return b;
 }
@@ -305,7 +334,9 @@ database_api_impl::get_asset_objects(const asset& amount, bool is_blind) const
 }
 
 transfer_fee_info database_api::get_required_transfer_fee(const asset& amount, account_id_type from, account_id_type to) const {
-   return my->get_required_transfer_fee(amount, from, to);
+   return cached( my->_db, "get_required_transfer_fee", [&]() {
+      return my->get_required_transfer_fee(amount, from, to);
+   }, amount, from, to );
 }
 
 transfer_fee_info database_api_impl::get_required_transfer_fee(const asset& amount, account_id_type from, account_id_type to) const
@@ -622,6 +653,7 @@ optional<signed_block> database_api_impl::get_block_by_id(string block_id)
    signed_block b = *block;
    for (processed_transaction& tr: b.transactions) {
       _db.clear_ops(tr.operations);
+      tr.invalidate_cache();
    }
 
    return b;
@@ -652,6 +684,7 @@ processed_transaction database_api_impl::get_transaction(uint32_t block_num, uin
 
    processed_transaction& tr = opt_block->transactions[trx_num];
    _db.clear_ops(tr.operations);
+   tr.invalidate_cache();
 
    return tr;
 }
@@ -674,7 +707,7 @@ chain_property_object database_api_impl::get_chain_properties()const
 
 global_property_object database_api::get_global_properties()const
 {
-   return my->get_global_properties();
+   return cached( my->_db, "get_global_properties", [&]() { return my->get_global_properties(); } );
 }
 
 global_property_object database_api_impl::get_global_properties()const
@@ -704,7 +737,7 @@ chain_id_type database_api_impl::get_chain_id()const
 
 dynamic_global_property_object database_api::get_dynamic_global_properties()const
 {
-   return my->get_dynamic_global_properties();
+   return cached( my->_db, "get_dynamic_global_properties", [&]() { return my->get_dynamic_global_properties(); } );
 }
 
 dynamic_global_property_object database_api_impl::get_dynamic_global_properties()const
@@ -712,6 +745,17 @@ dynamic_global_property_object database_api_impl::get_dynamic_global_properties(
    return _db.get(dynamic_global_property_id_type());
 }
 
+response_cache_info database_api::get_response_cache_info()const
+{
+   return my->get_response_cache_info();
+}
+
+response_cache_info database_api_impl::get_response_cache_info()const
+{
+   auto cache = api_response_cache::get( _db );
+   return cache ? cache->get_info() : response_cache_info();
+}
+
 //////////////////////////////////////////////////////////////////////
 //                                                                  //
 // Keys                                                             //
@@ -719,7 +763,7 @@ dynamic_global_property_object database_api_impl::get_dynamic_global_properties(
 //////////////////////////////////////////////////////////////////////
 
 vector<vector<account_id_type>> database_api::get_key_references( vector<public_key_type> key) const {
-   return my->get_key_references( key );
+   return my->read_only( [&]() { return my->get_key_references( key ); } );
 }
 
 /**
@@ -860,7 +904,7 @@ fc::optional<account_id_type> database_api_impl::get_market_reference(const addr
 //////////////////////////////////////////////////////////////////////
 
 vector<optional<account_object>> database_api::get_accounts(const vector<account_id_type>& account_ids) const {
-   return my->get_accounts( account_ids );
+   return my->read_only( [&]() { return my->get_accounts( account_ids ); } );
 }
 
 std::pair<unsigned, vector<address>>
@@ -911,7 +955,7 @@ database_api_impl::get_account_addresses(const string& name_or_id, unsigned from
 }
 
 std::map<string,full_account> database_api::get_full_accounts(const vector<string>& names_or_ids, bool subscribe) {
-   return my->get_full_accounts(names_or_ids, subscribe);
+   return my->read_only( [&]() { return my->get_full_accounts(names_or_ids, subscribe); } );
 }
 
 std::map<std::string, full_account> database_api_impl::get_full_accounts(const vector<std::string>& names_or_ids, bool subscribe)
@@ -1094,7 +1138,7 @@ optional<account_object> database_api_impl::get_account_by_name_or_id(const stri
 }
 
 vector<account_id_type> database_api::get_account_references( account_id_type account_id ) const {
-   return my->get_account_references( account_id );
+   return my->read_only( [&]() { return my->get_account_references( account_id ); } );
 }
 
 vector<account_id_type> database_api_impl::get_account_references( account_id_type account_id )const
@@ -1130,7 +1174,7 @@ optional<restricted_account_object> database_api_impl::get_restricted_account(ac
 }
 
 vector<optional<account_object>> database_api::lookup_account_names(const vector<string>& account_names) const {
-   return my->lookup_account_names( account_names );
+   return my->read_only( [&]() { return my->lookup_account_names( account_names ); } );
 }
 
 vector<optional<account_object>> database_api_impl::lookup_account_names(const vector<string>& account_names)const
@@ -1148,7 +1192,7 @@ vector<optional<account_object>> database_api_impl::lookup_account_names(const v
 
 map<string,account_id_type> database_api::lookup_accounts(const string& lower_bound_name, uint32_t limit)const
 {
-   return my->lookup_accounts( lower_bound_name, limit );
+   return my->read_only( [&]() { return my->lookup_accounts( lower_bound_name, limit ); } );
 }
 
 map<string,account_id_type> database_api_impl::lookup_accounts(const string& lower_bound_name, uint32_t limit)const
@@ -1187,7 +1231,9 @@ uint64_t database_api_impl::get_account_count()const
 
 vector<asset> database_api::get_account_balances(account_id_type id, const flat_set<asset_id_type>& assets)const
 {
-   return my->get_account_balances( id, assets );
+   return cached( my->_db, "get_account_balances", [&]() {
+      return my->read_only( [&]() { return my->get_account_balances( id, assets ); } );
+   }, id, assets );
 }
 
 vector<asset> database_api_impl::get_account_balances(account_id_type acnt, const flat_set<asset_id_type>& assets)const
@@ -1214,7 +1260,7 @@ vector<asset> database_api_impl::get_account_balances(account_id_type acnt, cons
 
 vector<asset> database_api::get_named_account_balances(const std::string& name, const flat_set<asset_id_type>& assets)const
 {
-   return my->get_named_account_balances( name, assets );
+   return my->read_only( [&]() { return my->get_named_account_balances( name, assets ); } );
 }
 
 vector<asset> database_api_impl::get_named_account_balances(const std::string& name, const flat_set<asset_id_type>& assets) const
@@ -1225,6 +1271,65 @@ vector<asset> database_api_impl::get_named_account_balances(const std::string& n
    return get_account_balances(itr->get_id(), assets);
 }
 
+account_balance_columns database_api::get_asset_balances(asset_id_type asset_id, account_id_type start, uint32_t limit)const
+{
+   FC_ASSERT( limit <= 10000 );
+   return my->read_only( [&]() { return my->get_asset_balances( asset_id, start, limit ); } );
+}
+
+account_balance_columns database_api_impl::get_asset_balances(asset_id_type asset_id, account_id_type start, uint32_t limit)const
+{
+   account_balance_columns result;
+   result.asset_id = asset_id;
+
+   const auto& bal_idx = _db.get_index_type<account_balance_index>().indices().get<by_asset_account>();
+   auto itr = bal_idx.lower_bound( boost::make_tuple( asset_id, start ) );
+   auto end = bal_idx.upper_bound( boost::make_tuple( asset_id ) );
+   for( ; itr != end && result.accounts.size() < limit; ++itr )
+      append_balance_column( result, itr->owner, itr->balance );
+   if( itr != end )
+      result.next = itr->owner;
+   return result;
+}
+
+account_balance_columns database_api::get_asset_balances_of(asset_id_type asset_id, const vector<account_id_type>& accounts)const
+{
+   FC_ASSERT( accounts.size() <= 10000 );
+   return my->read_only( [&]() { return my->get_asset_balances_of( asset_id, accounts ); } );
+}
+
+account_balance_columns database_api_impl::get_asset_balances_of(asset_id_type asset_id, const vector<account_id_type>& accounts)const
+{
+   account_balance_columns result;
+   result.asset_id = asset_id;
+   result.accounts.reserve( accounts.size() );
+   result.balances.reserve( accounts.size() );
+   result.mature_balances.reserve( accounts.size() );
+   result.deposits.reserve( accounts.size() );
+
+   const auto& bal_idx = _db.get_index_type<account_balance_index>().indices().get<by_account_asset>();
+   for( const account_id_type& account : accounts )
+   {
+      auto itr = bal_idx.find( boost::make_tuple( account, asset_id ) );
+      append_balance_column( result, account, itr != bal_idx.end() ? itr->balance : share_type() );
+   }
+   return result;
+}
+
+void database_api_impl::append_balance_column(account_balance_columns& result, account_id_type account, share_type balance)const
+{
+   const auto& mature_idx = _db.get_index_type<account_mature_balance_index>().indices().get<by_account_asset>();
+   auto mature = mature_idx.find( boost::make_tuple( account, result.asset_id ) );
+   share_type deposits;
+   if( _db.find( account ) )
+      deposits = std::get<0>( _db.get_user_deposits_info( account, result.asset_id ) );
+
+   result.accounts.push_back( account.instance.value );
+   result.balances.push_back( balance );
+   result.mature_balances.push_back( mature != mature_idx.end() ? mature->balance : share_type() );
+   result.deposits.push_back( deposits );
+}
+
 vector<balance_object> database_api::get_balance_objects( const vector<address>& addrs )const
 {
    return my->get_balance_objects( addrs );
@@ -1365,7 +1470,9 @@ vector<optional<asset_object>> database_api_impl::lookup_asset_symbols(const vec
 }
 
 vector<fund_object> database_api::list_funds() const {
-   return my->list_funds();
+   return cached( my->_db, "list_funds", [&]() {
+      return my->read_only( [&]() { return my->list_funds(); } );
+   } );
 }
 
 const fund_object* database_api_impl::get_fund_by_name_or_id(const std::string& fund_name_or_id) const
@@ -1390,7 +1497,7 @@ const fund_object* database_api_impl::get_fund_by_name_or_id(const std::string&
 }
 
 fund_object database_api::get_fund(const std::string& fund_name_or_id) const {
-   return my->get_fund(fund_name_or_id);
+   return cached( my->_db, "get_fund", [&]() { return my->get_fund(fund_name_or_id); }, fund_name_or_id );
 }
 
 const fund_object database_api_impl::get_fund(const std::string& fund_name_or_id) const
@@ -1453,8 +1560,39 @@ vector<fund_object> database_api_impl::list_funds() const
    return result;
 }
 
+namespace {
+
+/**
+ * Returns up to @p limit objects of @p key from an index ordered by (key, id), from the newest to the oldest, starting
+ * at @p start or at the newest object if @p start is null. The page costs a lookup whatever its position.
+ */
+template<typename Object, typename Index, typename Key>
+vector<Object> page_newest_first( const Index& idx, const Key& key, object_id_type start, uint32_t limit )
+{
+   vector<Object> result;
+   const auto first = idx.lower_bound( boost::make_tuple( key ) );
+   auto itr = start.instance() == 0 ? idx.upper_bound( boost::make_tuple( key ) )
+                                    : idx.upper_bound( boost::make_tuple( key, start ) );
+   while( itr != first && result.size() < limit )
+      result.emplace_back( *--itr );
+   return result;
+}
+
+/** Same as @ref page_newest_first, from the oldest object to the newest one starting at @p start */
+template<typename Object, typename Index, typename Key>
+vector<Object> page_oldest_first( const Index& idx, const Key& key, object_id_type start, uint32_t limit )
+{
+   vector<Object> result;
+   const auto last = idx.upper_bound( boost::make_tuple( key ) );
+   for( auto itr = idx.lower_bound( boost::make_tuple( key, start ) ); itr != last && result.size() < limit; ++itr )
+      result.emplace_back( *itr );
+   return result;
+}
+
+} // anonymous namespace
+
 vector<fund_deposit_object> database_api::get_fund_deposits(const std::string& fund_name_or_id, uint32_t start, uint32_t limit) const {
-   return my->get_fund_deposits(fund_name_or_id, start, limit);
+   return my->read_only( [&]() { return my->get_fund_deposits(fund_name_or_id, start, limit); } );
 }
 
 vector<fund_deposit_object> database_api_impl::get_fund_deposits(const std::string& fund_name_or_id, uint32_t start, uint32_t limit) const
@@ -1480,6 +1618,20 @@ vector<fund_deposit_object> database_api_impl::get_fund_deposits(const std::stri
    return result;
 }
 
+vector<fund_deposit_object>
+database_api::list_fund_deposits(const std::string& fund_name_or_id, fund_deposit_id_type start, uint32_t limit) const {
+   return my->read_only( [&]() { return my->list_fund_deposits(fund_name_or_id, start, limit); } );
+}
+
+vector<fund_deposit_object>
+database_api_impl::list_fund_deposits(const std::string& fund_name_or_id, fund_deposit_id_type start, uint32_t limit) const
+{
+   FC_ASSERT( limit <= 100 );
+   const fund_object* fund_ptr = get_fund_by_name_or_id(fund_name_or_id);
+   const auto& idx = _db.get_index_type<fund_deposit_index>().indices().get<by_fund_id>();
+   return page_newest_first<fund_deposit_object>( idx, fund_ptr->get_id(), start, limit );
+}
+
 pair<vector<fund_deposit_object>, uint32_t>
 database_api::get_all_fund_deposits_by_period(uint32_t period, uint32_t start, uint32_t limit) const {
    return my->get_all_fund_deposits_by_period(period, start, limit);
@@ -1512,6 +1664,19 @@ database_api_impl::get_all_fund_deposits_by_period(uint32_t period, uint32_t sta
    return std::make_pair(result, new_start);
 }
 
+vector<fund_deposit_object>
+database_api::list_fund_deposits_by_period(uint32_t period, fund_deposit_id_type start, uint32_t limit) const {
+   return my->read_only( [&]() { return my->list_fund_deposits_by_period(period, start, limit); } );
+}
+
+vector<fund_deposit_object>
+database_api_impl::list_fund_deposits_by_period(uint32_t period, fund_deposit_id_type start, uint32_t limit) const
+{
+   FC_ASSERT( limit <= 100 );
+   const auto& idx = _db.get_index_type<fund_deposit_index>().indices().get<by_period>();
+   return page_oldest_first<fund_deposit_object>( idx, period, start, limit );
+}
+
 asset database_api::get_fund_deposits_amount_by_account(fund_id_type fund_id, account_id_type account_id) const {
    return my->get_fund_deposits_amount_by_account(fund_id, account_id);
 }
@@ -1533,7 +1698,7 @@ asset database_api_impl::get_fund_deposits_amount_by_account(fund_id_type fund_i
 }
 
 vector<fund_deposit_object> database_api::get_account_deposits(account_id_type account_id, uint32_t start, uint32_t limit) const {
-   return my->get_account_deposits(account_id, start, limit);
+   return my->read_only( [&]() { return my->get_account_deposits(account_id, start, limit); } );
 }
 
 vector<fund_deposit_object> database_api_impl::get_account_deposits(account_id_type account_id, uint32_t start, uint32_t limit) const
@@ -1554,6 +1719,19 @@ vector<fund_deposit_object> database_api_impl::get_account_deposits(account_id_t
    return result;
 }
 
+vector<fund_deposit_object>
+database_api::list_account_deposits(account_id_type account_id, fund_deposit_id_type start, uint32_t limit) const {
+   return my->read_only( [&]() { return my->list_account_deposits(account_id, start, limit); } );
+}
+
+vector<fund_deposit_object>
+database_api_impl::list_account_deposits(account_id_type account_id, fund_deposit_id_type start, uint32_t limit) const
+{
+   FC_ASSERT( limit <= 100 );
+   const auto& idx = _db.get_index_type<fund_deposit_index>().indices().get<by_account_id>();
+   return page_newest_first<fund_deposit_object>( idx, account_id, start, limit );
+}
+
 //////////////////////////////////////////////////////////////////////
 //                                                                  //
 // Markets / feeds                                                  //
@@ -1561,7 +1739,7 @@ vector<fund_deposit_object> database_api_impl::get_account_deposits(account_id_t
 //////////////////////////////////////////////////////////////////////
 
 vector<market_address_object> database_api::get_market_addresses(account_id_type account_id, uint32_t start, uint32_t limit) const {
-   return my->get_market_addresses(account_id, start, limit);
+   return my->read_only( [&]() { return my->get_market_addresses(account_id, start, limit); } );
 }
 
 vector<market_address_object> database_api_impl::get_market_addresses(account_id_type account_id, uint32_t start, uint32_t limit) const
@@ -1582,8 +1760,21 @@ vector<market_address_object> database_api_impl::get_market_addresses(account_id
    return result;
 }
 
+vector<market_address_object>
+database_api::list_market_addresses(account_id_type account_id, market_address_id_type start, uint32_t limit) const {
+   return my->read_only( [&]() { return my->list_market_addresses(account_id, start, limit); } );
+}
+
+vector<market_address_object>
+database_api_impl::list_market_addresses(account_id_type account_id, market_address_id_type start, uint32_t limit) const
+{
+   FC_ASSERT( limit <= 1000 );
+   const auto& idx = _db.get_index_type<market_address_index>().indices().get<by_market_account_id>();
+   return page_oldest_first<market_address_object>( idx, account_id, start, limit );
+}
+
 vector<limit_order_object> database_api::get_limit_orders(asset_id_type a, asset_id_type b, uint32_t limit) const {
-   return my->get_limit_orders( a, b, limit );
+   return my->read_only( [&]() { return my->get_limit_orders( a, b, limit ); } );
 }
 
 /**
@@ -1640,7 +1831,46 @@ map<account_id_type, uint16_t> database_api::get_online_info()const
 
 map<account_id_type, uint16_t> database_api_impl::get_online_info()const
 {
-    return _db.get(accounts_online_id_type()).online_info;
+   map<account_id_type, uint16_t> result;
+   for( const account_online_object& o : _db.get_index_type<account_online_index>().indices().get<by_account>() )
+      result.emplace_hint( result.end(), o.owner, o.online_minutes );
+   return result;
+}
+
+vector<account_online_object> database_api::list_online_info(account_id_type start, uint32_t limit)const
+{
+   FC_ASSERT( limit <= 1000 );
+   return my->read_only( [&]() { return my->list_online_info( start, limit ); } );
+}
+
+vector<account_online_object> database_api_impl::list_online_info(account_id_type start, uint32_t limit)const
+{
+   const auto& idx = _db.get_index_type<account_online_index>().indices().get<by_account>();
+   vector<account_online_object> result;
+   for( auto itr = idx.lower_bound( start ); itr != idx.end() && result.size() < limit; ++itr )
+      result.push_back( *itr );
+   return result;
+}
+
+online_info_changes database_api::get_online_info_changes(uint32_t since_block, account_id_type start,
+                                                          uint32_t limit)const
+{
+   FC_ASSERT( limit <= 1000 );
+   return my->read_only( [&]() { return my->get_online_info_changes( since_block, start, limit ); } );
+}
+
+online_info_changes database_api_impl::get_online_info_changes(uint32_t since_block, account_id_type start,
+                                                               uint32_t limit)const
+{
+   online_info_changes result;
+   result.head_block_num = _db.head_block_num();
+   result.entries_removed = _db.get(accounts_online_id_type()).last_removal_block > since_block;
+
+   const auto& idx = _db.get_index_type<account_online_index>().indices().get<by_last_update>();
+   for( auto itr = idx.lower_bound( boost::make_tuple( since_block + 1, start ) );
+        itr != idx.end() && result.changed.size() < limit; ++itr )
+      result.changed.push_back( *itr );
+   return result;
 }
 
 vector<force_settlement_object> database_api::get_settle_orders(asset_id_type a, uint32_t limit)const
@@ -1705,7 +1935,7 @@ void database_api_impl::unsubscribe_from_market(asset_id_type a, asset_id_type b
 
 market_ticker database_api::get_ticker( const string& base, const string& quote )const
 {
-   return my->get_ticker( base, quote );
+   return my->read_only( [&]() { return my->get_ticker( base, quote ); } );
 }
 
 market_ticker database_api_impl::get_ticker( const string& base, const string& quote )const
@@ -1820,7 +2050,7 @@ market_volume database_api_impl::get_24_volume( const string& base, const string
 
 order_book database_api::get_order_book( const string& base, const string& quote, unsigned limit )const
 {
-   return my->get_order_book( base, quote, limit);
+   return my->read_only( [&]() { return my->get_order_book( base, quote, limit); } );
 }
 
 order_book database_api_impl::get_order_book( const string& base, const string& quote, unsigned limit )const
@@ -1879,7 +2109,7 @@ vector<market_trade> database_api::get_trade_history( const string& base,
                                                       fc::time_point_sec stop,
                                                       unsigned limit )const
 {
-   return my->get_trade_history( base, quote, start, stop, limit );
+   return my->read_only( [&]() { return my->get_trade_history( base, quote, start, stop, limit ); } );
 }
 
 vector<market_trade> database_api_impl::get_trade_history( const string& base,
@@ -2512,115 +2742,323 @@ optional<cheque_info_object> database_api_impl::get_cheque_by_code(const std::st
 //                                                                  //
 //////////////////////////////////////////////////////////////////////
 
-void database_api_impl::broadcast_updates( const vector<variant>& updates )
+void database_api_impl::queue_update( const object_id_type& id, const variant& update, uint64_t size )
 {
-   if( updates.size() ) {
-      auto capture_this = shared_from_this();
-      fc::async([capture_this,updates](){
-          capture_this->_subscribe_callback( fc::variant(updates) );
-      });
+   std::lock_guard<std::mutex> guard( _queue_mutex );
+
+   auto pos = _queued_positions.find( id );
+   if( pos != _queued_positions.end() )
+   {
+      // latest state wins, at the position of the first one
+      queued_update& queued = _queued_updates[pos->second];
+      _queue_info.queued_bytes = _queue_info.queued_bytes - queued.size + size;
+      queued.update = update;
+      queued.size = size;
+      ++_queue_info.coalesced_updates;
    }
+   else
+   {
+      _queued_positions.emplace( id, _queued_updates.size() );
+      _queued_updates.push_back( { id, update, size } );
+      ++_queue_info.queued_updates;
+      _queue_info.queued_bytes += size;
+   }
+
+   check_queue_limits();
+   schedule_flush();
+}
+
+void database_api_impl::queue_market_update( const pair<asset_id_type, asset_id_type>& market, const variant& update,
+                                             uint64_t size )
+{
+   std::lock_guard<std::mutex> guard( _queue_mutex );
+
+   _queued_market_updates[market].push_back( update );
+   ++_queue_info.queued_updates;
+   _queue_info.queued_bytes += size;
+
+   check_queue_limits();
+   schedule_flush();
 }
 
-void database_api_impl::on_objects_removed( const vector<const object*>& objs )
+void database_api_impl::queue_block_applied( const variant& block_id )
 {
+   std::lock_guard<std::mutex> guard( _queue_mutex );
+
+   // only the head block is of interest
+   _queued_block_id = block_id;
+   schedule_flush();
+}
+
+uint64_t database_api_impl::transport_bytes() const
+{
+   return _transport_backlog ? _transport_backlog() : 0;
+}
+
+void database_api_impl::check_queue_limits()
+{
+   _queue_info.transport_bytes = transport_bytes();
+   if( (_queue_info.queued_updates <= _queue_limits.max_updates)
+       && (_queue_info.queued_bytes + _queue_info.transport_bytes <= _queue_limits.max_bytes) )
+      return;
+
+   wlog( "database api ${x} is not keeping up with its subscriptions: dropping ${n} queued updates (${b} bytes, "
+         "${t} bytes not sent yet)${c}",
+         ("x",int64_t(this))("n",_queue_info.queued_updates)("b",_queue_info.queued_bytes)
+         ("t",_queue_info.transport_bytes)
+         ("c",_queue_limits.cancel_on_overflow ? ", cancelling its subscriptions" : "") );
+
+   _queue_info.dropped_updates += _queue_info.queued_updates;
+   ++_queue_info.overflows;
+   _queue_info.queued_updates = 0;
+   _queue_info.queued_bytes = 0;
+   _queued_updates.clear();
+   _queued_positions.clear();
+   _queued_market_updates.clear();
+
+   if( _queue_limits.cancel_on_overflow )
+      cancel_all_subscriptions();
+}
+
+void database_api_impl::schedule_flush()
+{
+   if( _flush_scheduled )
+      return;
+   _flush_scheduled = true;
+
    /// we need to ensure the database_api is not deleted for the life of the async operation
-   if( _subscribe_callback )
+   auto capture_this = shared_from_this();
+   fc::async([capture_this](){ capture_this->flush_queue(); });
+}
+
+void database_api_impl::flush_queue()
+{
+   vector<queued_update> updates;
+   map<pair<asset_id_type,asset_id_type>, vector<variant>> market_updates;
+   optional<variant> block_id;
    {
-      vector<variant>    updates;
-      updates.reserve(objs.size());
+      std::lock_guard<std::mutex> guard( _queue_mutex );
+      _queue_info.transport_bytes = transport_bytes();
+      if( _queue_info.transport_bytes > _queue_limits.max_transport_bytes )
+      {
+         // the connection has not sent what it got last time, the queue keeps coalescing until it catches up
+         ++_queue_info.deferred_flushes;
+         auto capture_this = shared_from_this();
+         fc::schedule( [capture_this](){ capture_this->flush_queue(); },
+                       fc::time_point::now() + fc::milliseconds(100), "subscription queue flush" );
+         return;
+      }
+      std::swap( updates, _queued_updates );
+      std::swap( market_updates, _queued_market_updates );
+      std::swap( block_id, _queued_block_id );
+      _queued_positions.clear();
+      _queue_info.queued_updates = 0;
+      _queue_info.queued_bytes = 0;
+      _flush_scheduled = false;
+   }
 
-      for( auto obj : objs )
-         updates.emplace_back( obj->to_variant() );
-      broadcast_updates( updates );
+   if( updates.size() && _subscribe_callback )
+   {
+      vector<variant> result;
+      result.reserve( updates.size() );
+      for( auto& item : updates )
+         result.emplace_back( std::move(item.update) );
+      _subscribe_callback( fc::variant(result) );
    }
 
-   if( _market_subscriptions.size() )
+   for( const auto& item : market_updates )
    {
-      map< pair<asset_id_type, asset_id_type>, vector<variant> > broadcast_queue;
-      for( const auto& obj : objs )
+      auto sub = _market_subscriptions.find(item.first);
+      if( sub != _market_subscriptions.end() )
+         sub->second( fc::variant(item.second) );
+   }
+
+   if( block_id.valid() && _block_applied_callback )
+      _block_applied_callback( *block_id );
+}
+
+//////////////////////////////////////////////////////////////////////
+//                                                                  //
+// Change dispatcher                                                //
+//                                                                  //
+//////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/** the length of the JSON text of @p v, roughly */
+uint64_t estimated_size( const variant& v )
+{
+   switch( v.get_type() )
+   {
+      case variant::string_type:
+         return v.get_string().size() + 2;
+      case variant::blob_type:
+         return v.get_blob().data.size() * 4 / 3 + 2;
+      case variant::array_type:
       {
-         const limit_order_object* order = dynamic_cast<const limit_order_object*>(obj);
-         if( order )
-         {
-            auto sub = _market_subscriptions.find( order->get_market() );
-            if( sub != _market_subscriptions.end() )
-               broadcast_queue[order->get_market()].emplace_back( order->to_variant() );
-         }
+         uint64_t size = 2;
+         for( const auto& item : v.get_array() )
+            size += estimated_size( item ) + 1;
+         return size;
       }
-      if( broadcast_queue.size() )
+      case variant::object_type:
       {
-         auto capture_this = shared_from_this();
-         fc::async([capture_this,this,broadcast_queue](){
-             for( const auto& item : broadcast_queue )
-             {
-               auto sub = _market_subscriptions.find(item.first);
-               if( sub != _market_subscriptions.end() )
-                   sub->second( fc::variant(item.second ) );
-             }
-         });
+         uint64_t size = 2;
+         for( const auto& entry : v.get_object() )
+            size += entry.key().size() + 4 + estimated_size( entry.value() );
+         return size;
       }
+      default:
+         return 8;
+   }
+}
+
+} // anonymous namespace
+
+object_change_dispatcher::object_change_dispatcher( graphene::chain::database& db ):_db(db)
+{
+   _change_connection = _db.changed_objects.connect([this](const vector<object_id_type>& ids) {
+                                on_objects_changed(ids);
+                                });
+   _removed_connection = _db.removed_objects.connect([this](const vector<const object*>& objs) {
+                                on_objects_removed(objs);
+                                });
+}
+
+std::shared_ptr<object_change_dispatcher> object_change_dispatcher::get( graphene::chain::database& db )
+{
+   static std::mutex registry_mutex;
+   static std::map<const graphene::chain::database*, std::weak_ptr<object_change_dispatcher>> registry;
+
+   std::lock_guard<std::mutex> guard( registry_mutex );
+   auto& entry = registry[&db];
+   auto dispatcher = entry.lock();
+   if( !dispatcher )
+   {
+      dispatcher = std::make_shared<object_change_dispatcher>( db );
+      entry = dispatcher;
    }
+   return dispatcher;
 }
 
-void database_api_impl::on_objects_changed(const vector<object_id_type>& ids)
+void object_change_dispatcher::add_session( const std::shared_ptr<database_api_impl>& session )
+{
+   std::lock_guard<std::mutex> guard( _sessions_mutex );
+   _sessions.emplace_back( session );
+}
+
+vector<std::shared_ptr<database_api_impl>> object_change_dispatcher::subscribed_sessions()
+{
+   vector<std::shared_ptr<database_api_impl>> result;
+
+   std::lock_guard<std::mutex> guard( _sessions_mutex );
+   result.reserve( _sessions.size() );
+   auto out = _sessions.begin();
+   for( auto itr = _sessions.begin(); itr != _sessions.end(); ++itr )
+   {
+      auto session = itr->lock();
+      if( !session )
+         continue;
+      if( session->_subscribe_callback || session->_market_subscriptions.size() )
+         result.emplace_back( session );
+      *out++ = std::move( *itr );
+   }
+   _sessions.erase( out, _sessions.end() );
+
+   return result;
+}
+
+void object_change_dispatcher::on_objects_changed( const vector<object_id_type>& ids )
 {
    if (_db.start_notify_block_num >= _db.head_block_num()) return;
-   vector<variant>    updates;
-   map< pair<asset_id_type, asset_id_type>,  vector<variant> > market_broadcast_queue;
-   for(auto id : ids)
+
+   const asset_object* edc = _db.find( EDC_ASSET );
+
+   vector<std::pair<object_id_type, const object*>> changes;
+   changes.reserve( ids.size() );
+   for( const auto& id : ids )
    {
-      if (id == ALPHA_ACCOUNT_ID) continue;
+      if( id == ALPHA_ACCOUNT_ID ) continue;
+      if( edc && (edc->issuer == id) ) continue;
 
-      const vector<optional<asset_object>>& assets = get_assets({EDC_ASSET});
-      if ( (assets.size() > 0) && assets[0].valid() && (assets[0]->issuer == id) ) { continue; }
+      changes.emplace_back( id, _db.find_object( id ) );
+   }
 
-      const object* obj = nullptr;
-      if( _subscribe_callback )
-      {
-         obj = _db.find_object( id );
-         if( obj )
-         {
-            updates.emplace_back( obj->to_variant() );
-         }
-         else
-         {
-            updates.emplace_back(fc::variant( id, 1 )); // send just the id to indicate removal
-         }
-      }
+   dispatch( changes );
+}
+
+void object_change_dispatcher::on_objects_removed( const vector<const object*>& objs )
+{
+   vector<std::pair<object_id_type, const object*>> changes;
+   changes.reserve( objs.size() );
+   for( const object* obj : objs )
+      changes.emplace_back( obj->id, obj );
 
-      if( _market_subscriptions.size() )
+   dispatch( changes );
+}
+
+void object_change_dispatcher::dispatch( const vector<std::pair<object_id_type, const object*>>& changes )
+{
+   if( changes.empty() ) return;
+
+   const auto sessions = subscribed_sessions();
+   if( sessions.empty() ) return;
+
+   for( const auto& change : changes )
+   {
+      const object_id_type& id = change.first;
+      const object* obj = change.second;
+
+      // everything below is computed once for all the sessions, and only if a session needs it
+      const vector<char> packed_id = fc::raw::pack( id );
+      optional<vector<vector<char>>> packed_accounts;
+      optional<variant> serialized;
+      uint64_t serialized_size = 0;
+
+      const limit_order_object* order = nullptr;
+      if( obj && (id.space() == protocol_ids) && (id.type() == limit_order_object_type) )
+         order = dynamic_cast<const limit_order_object*>( obj );
+
+      for( size_t i = 0; i < sessions.size(); ++i )
       {
-         if( !_subscribe_callback )
-            obj = _db.find_object( id );
-         if( obj )
+         const database_api_impl& session = *sessions[i];
+
+         bool matches = session.is_subscribed_to_packed( packed_id );
+         if( !matches && obj && session._subscribe_callback )
          {
-            const limit_order_object* order = dynamic_cast<const limit_order_object*>(obj);
-            if( order )
+            if( !packed_accounts.valid() )
+            {
+               packed_accounts = vector<vector<char>>();
+               for( const account_id_type& account : get_relevant_accounts( obj ) )
+                  packed_accounts->emplace_back( fc::raw::pack( object_id_type(account) ) );
+            }
+            for( const auto& packed_account : *packed_accounts )
             {
-               auto sub = _market_subscriptions.find( order->get_market() );
-               if( sub != _market_subscriptions.end() )
-                  market_broadcast_queue[order->get_market()].emplace_back( order->to_variant() );
+               if( session.is_subscribed_to_packed( packed_account ) )
+               {
+                  matches = true;
+                  break;
+               }
             }
          }
-      }
-   }
-
-   auto capture_this = shared_from_this();
 
-   /// pushing the future back / popping the prior future if it is complete.
-   /// if a connection hangs then this could get backed up and result in
-   /// a failure to exit cleanly.
-   fc::async([capture_this,this,updates,market_broadcast_queue](){
-      if( _subscribe_callback ) _subscribe_callback( updates );
+         const bool market_matches = order && session._market_subscriptions.count( order->get_market() );
+         if( !matches && !market_matches )
+            continue;
 
-      for( const auto& item : market_broadcast_queue )
-      {
-        auto sub = _market_subscriptions.find(item.first);
-        if( sub != _market_subscriptions.end() )
-            sub->second( fc::variant(item.second ) );
+         if( !serialized.valid() )
+         {
+            // a removed object is sent as just its id
+            serialized = obj ? obj->to_variant() : fc::variant( id, 1 );
+            serialized_size = estimated_size( *serialized );
+         }
+         // copies of an object variant share its fields
+         if( matches )
+            sessions[i]->queue_update( id, *serialized, serialized_size );
+         if( market_matches )
+            sessions[i]->queue_market_update( order->get_market(), *serialized, serialized_size );
       }
-   });
+   }
 }
 
 /** note: this method cannot yield because it is called in the middle of
@@ -2629,19 +3067,12 @@ void database_api_impl::on_objects_changed(const vector<object_id_type>& ids)
 void database_api_impl::on_applied_block()
 {
    if (_block_applied_callback)
-   {
-      auto capture_this = shared_from_this();
-      block_id_type block_id = _db.head_block_id();
-      fc::async([this,capture_this,block_id](){
-         _block_applied_callback(fc::variant(block_id, 1));
-      });
-   }
+      queue_block_applied( fc::variant(_db.head_block_id(), 1) );
 
    if(_market_subscriptions.size() == 0)
       return;
 
    const auto& ops = _db.get_applied_operations();
-   map< std::pair<asset_id_type,asset_id_type>, vector<pair<operation, operation_result>> > subscribed_markets_ops;
    for(const optional< operation_history_object >& o_op : ops)
    {
       if( !o_op.valid() )
@@ -2665,64 +3096,94 @@ void database_api_impl::on_applied_block()
          default: break;
       }
       if(_market_subscriptions.count(market))
-         subscribed_markets_ops[market].push_back(std::make_pair(op.op, op.result));
-   }
-   /// we need to ensure the database_api is not deleted for the life of the async operation
-   auto capture_this = shared_from_this();
-   fc::async([this,capture_this,subscribed_markets_ops](){
-      for(auto item : subscribed_markets_ops)
       {
-         auto itr = _market_subscriptions.find(item.first);
-         if(itr != _market_subscriptions.end())
-            itr->second(fc::variant(item.second, GRAPHENE_NET_MAX_NESTED_OBJECTS));
+         fc::variant fill( std::make_pair(op.op, op.result), GRAPHENE_NET_MAX_NESTED_OBJECTS );
+         const uint64_t size = estimated_size( fill );
+         queue_market_update( market, fill, size );
       }
-   });
+   }
 }
 
 Unit database_api::get_referrals(const std::string& account_name_or_id)
 {
-   auto account = my->get_account_by_name_or_id(account_name_or_id);
-   FC_ASSERT(account.valid(), "invalid account");
-   return my->get_referrals(account);
+   return cached( my->_db, "get_referrals", [&]() {
+      return my->read_only( [&]() {
+         auto account = my->get_account_by_name_or_id(account_name_or_id);
+         FC_ASSERT(account.valid(), "invalid account");
+         return my->get_referrals(account, account_id_type(), std::numeric_limits<uint32_t>::max());
+      } );
+   }, account_name_or_id );
+}
+
+Unit database_api::get_referrals_page(const std::string& account_name_or_id, account_id_type start, uint32_t limit)
+{
+   FC_ASSERT( limit <= 1000 );
+   return my->read_only( [&]() {
+      auto account = my->get_account_by_name_or_id(account_name_or_id);
+      FC_ASSERT(account.valid(), "invalid account");
+      return my->get_referrals(account, start, limit);
+   } );
 }
 
-Unit database_api_impl::get_referrals(optional<account_object> account) const
+Unit database_api_impl::get_referrals(optional<account_object> account, account_id_type start, uint32_t limit) const
 {
    const auto& idx = _db.get_index_type<chain::account_index>();
+   const auto& referrers = dynamic_cast<const primary_index<account_index>&>(idx)
+                              .get_secondary_index<graphene::chain::account_referrer_index>();
    auto asset = _db.get_index_type<asset_index>().indices().get<by_symbol>().find(EDC_ASSET_SYMBOL);
    Unit result(account->get_id(), account->name, _db.get_balance(account->id, asset->id).amount.value);
-   idx.inspect_all_objects([&](const chain::object& obj)
+   auto referred = referrers.referred_by.find(account->get_id());
+   if (referred == referrers.referred_by.end())
+      return result;
+   for (auto itr = referred->second.lower_bound(start);
+        itr != referred->second.end() && result.referrals.size() < limit; ++itr)
    {
-      const account_object& acc = static_cast<const chain::account_object&>(obj);
-      if (acc.referrer == account->get_id())
-      {
-         auto balance = _db.get_balance(acc.id, asset->id).amount.value;
-         auto nElem = Unit(acc.get_id(), acc.name, balance);
-         result.referrals.push_back(std::move(nElem));
-      }
-   });
+      const account_object& acc = (*itr)(_db);
+      auto balance = _db.get_balance(acc.id, asset->id).amount.value;
+      result.referrals.push_back(Unit(acc.get_id(), acc.name, balance));
+   }
    return result;
 }
 
 ref_info database_api::get_referrals2(const std::string& account_name_or_id)
 {
-   auto account = my->get_account_by_name_or_id(account_name_or_id);
-   FC_ASSERT(account.valid(), "invalid account");
-   return my->get_referrals2(account);
+   return cached( my->_db, "get_referrals2", [&]() {
+      return my->read_only( [&]() {
+         auto account = my->get_account_by_name_or_id(account_name_or_id);
+         FC_ASSERT(account.valid(), "invalid account");
+         return my->get_referrals2(account, account_id_type(), std::numeric_limits<uint32_t>::max());
+      } );
+   }, account_name_or_id );
+}
+
+ref_info database_api::get_referrals2_page(const std::string& account_name_or_id, account_id_type start,
+                                           uint32_t limit)
+{
+   FC_ASSERT( limit <= 1000 );
+   return cached( my->_db, "get_referrals2_page", [&]() {
+      return my->read_only( [&]() {
+         auto account = my->get_account_by_name_or_id(account_name_or_id);
+         FC_ASSERT(account.valid(), "invalid account");
+         return my->get_referrals2(account, start, limit);
+      } );
+   }, account_name_or_id, start, limit );
 }
 
-ref_info database_api_impl::get_referrals2( optional<account_object> account ) const
+ref_info database_api_impl::get_referrals2( optional<account_object> account, account_id_type start,
+                                            uint32_t limit ) const
 {
     const auto& idx = _db.get_index_type<chain::account_index>();
+    const auto& referrers = dynamic_cast<const primary_index<account_index>&>(idx)
+                               .get_secondary_index<graphene::chain::account_referrer_index>();
     auto asset = _db.get_index_type<asset_index>().indices().get<by_symbol>().find(EDC_ASSET_SYMBOL);
     auto& bal_idx = _db.get_index_type<account_balance_index>();
     referral_tree rtree( idx, bal_idx, asset->id, account->id );
-    rtree.form_old();
+    rtree.form_old_subtree( referrers );
     leaf_info root = *rtree.referral_map.find(account->id)->second;
     ref_info result( root, account->name );
     for (child_balance e: root.child_balances)
     {
-        if (e.level == 1) {
+        if (e.level == 1 && !(e.account_id < start) && result.level_1.size() < limit) {
             result.level_1.push_back(ref_info(*rtree.referral_map.find(e.account_id)->second, e.account_id(_db).name));
         }
     }
@@ -2731,28 +3192,30 @@ ref_info database_api_impl::get_referrals2( optional<account_object> account ) c
 
 vector<SimpleUnit> database_api::get_accounts_info(vector<string> account_names_or_ids)
 {
-   vector<optional<account_object>> accs;
-   accs.reserve(account_names_or_ids.size());
-   for( string acc_name_or_id : account_names_or_ids )
-   {
-      const account_object* account_ptr = nullptr;
-      if (std::isdigit(acc_name_or_id[0])) {
-         account_ptr = my->_db.find(fc::variant(acc_name_or_id, 1).as<account_id_type>(1));
-      }
-      else
+   return my->read_only( [&]() {
+      vector<optional<account_object>> accs;
+      accs.reserve(account_names_or_ids.size());
+      for( string acc_name_or_id : account_names_or_ids )
       {
-         const auto& idx = my->_db.get_index_type<account_index>().indices().get<by_name>();
-         auto itr = idx.find(acc_name_or_id);
-         if (itr != idx.end()) {
-            account_ptr = &*itr;
+         const account_object* account_ptr = nullptr;
+         if (std::isdigit(acc_name_or_id[0])) {
+            account_ptr = my->_db.find(fc::variant(acc_name_or_id, 1).as<account_id_type>(1));
+         }
+         else
+         {
+            const auto& idx = my->_db.get_index_type<account_index>().indices().get<by_name>();
+            auto itr = idx.find(acc_name_or_id);
+            if (itr != idx.end()) {
+               account_ptr = &*itr;
+            }
          }
-      }
 
-      if (account_ptr) {
-         accs.push_back(*account_ptr);
+         if (account_ptr) {
+            accs.push_back(*account_ptr);
+         }
       }
-   }
-   return my->get_accounts_info(accs);
+      return my->get_accounts_info(accs);
+   } );
 }
 
 vector<SimpleUnit> database_api_impl::get_accounts_info(vector<optional<account_object>> accounts)
@@ -2810,10 +3273,12 @@ vector<SimpleUnit> database_api_impl::get_accounts_info(vector<optional<account_
       }
       if (found) continue;
       const auto& db_idx = _db.get_index_type<chain::account_index>();
+      const auto& referrers = dynamic_cast<const primary_index<account_index>&>(db_idx)
+                                 .get_secondary_index<graphene::chain::account_referrer_index>();
       auto asset = _db.get_index_type<asset_index>().indices().get<by_symbol>().find(EDC_ASSET_SYMBOL);
       auto& bal_idx = _db.get_index_type<account_balance_index>();
       referral_set.push_back(referral_tree( db_idx, bal_idx, asset->id, acc_obj.get_id() ));
-      referral_set.back().form_old();
+      referral_set.back().form_old_subtree( referrers );
       referral_set.back().scan_old();
       ret_unit.balance =      referral_set.back().root.node->data.balance;
       ret_unit.id =           referral_set.back().root.node->data.account_id;
@@ -2829,7 +3294,7 @@ vector<SimpleUnit> database_api_impl::get_accounts_info(vector<optional<account_
 
 fc::variant_object database_api::get_user_count_by_ranks() 
 {
-   return my->get_user_count_by_ranks();
+   return my->read_only( [&]() { return my->get_user_count_by_ranks(); } );
 }
 
 fc::variant_object database_api_impl::get_user_count_by_ranks() const
@@ -2869,43 +3334,36 @@ int64_t database_api::get_user_count_with_balances(std::vector<fc::time_point_se
       end = dates[1];
       if (start > end) std::swap(start, end);
    }
-   return my->get_user_count_with_balances(start, end);
+   return my->read_only( [&]() { return my->get_user_count_with_balances(start, end); } );
 }
 
 int64_t database_api_impl::get_user_count_with_balances(fc::time_point_sec start, fc::time_point_sec end) const 
 {
-   const auto& idx = _db.get_index_type<chain::account_index>().indices().get<by_id>();
-   auto asset = _db.get_index_type<asset_index>().indices().get<by_symbol>().find(EDC_ASSET_SYMBOL);
-   int64_t users_count = 0;
+   const auto& assets_by_symbol = _db.get_index_type<asset_index>().indices().get<by_symbol>();
+   auto asset = assets_by_symbol.find(EDC_ASSET_SYMBOL);
+   if (asset == assets_by_symbol.end())
+      return 0;
+
+   // the committee account is not a user
+   const bool committee_holds = _db.get_balance(account_id_type(), asset->id).amount > 0;
+
    if (start == fc::time_point_sec() && end == fc::time_point_sec()) {
-      for (auto account = ++idx.begin(); account != idx.end(); account++) {
-         auto balance = _db.get_balance(account->id, asset->id).amount.value;
-         if (balance < 1) continue;
+      const auto& bal_idx = dynamic_cast<const primary_index<account_balance_index>&>(
+         _db.get_index_type<account_balance_index>());
+      const auto& holders = bal_idx.get_secondary_index<graphene::chain::account_balance_holders_index>();
+      return holders.holders_count(asset->id) - (committee_holds ? 1 : 0);
+   }
+
+   if (end == fc::time_point_sec())
+      end = fc::time_point::now();
+   // accounts of the genesis state were not registered by an operation and keep the default registration time
+   start = std::max(start, fc::time_point_sec(1));
+
+   const auto& by_time = _db.get_index_type<chain::account_index>().indices().get<by_register_datetime>();
+   int64_t users_count = 0;
+   for (auto itr = by_time.lower_bound(start); itr != by_time.end() && itr->register_datetime <= end; ++itr) {
+      if (_db.get_balance(itr->id, asset->id).amount > 0)
          users_count++;
-      }
-   } else {
-      if (end == fc::time_point_sec())
-         end = fc::time_point::now();
-      for (auto account = ++idx.begin(); account != idx.end(); account++) {
-         auto balance = _db.get_balance(account->id, asset->id).amount.value;
-         if (balance < 1) continue;
-
-         const auto& stats = account->statistics(_db);
-         const account_transaction_history_object* node = &stats.most_recent_op(_db);
-         //uint32_t ops_count = stats.total_ops;
-         while (true) {
-            if (node->next == account_transaction_history_id_type()) break;
-            node = &node->next(_db);
-         }
-         auto& hist = node->operation_id(_db);
-         if (hist.op.which() == 5) { // account_create_operation 
-            auto op = hist.op.get<account_create_operation>();
-            fc::time_point_sec create_time = _db.fetch_block_by_number(hist.block_num)->timestamp;
-            if (create_time >= start && create_time <= end) {
-               users_count++;
-            }
-         }
-      }
    }
    return users_count;
 }
@@ -1,16 +1,87 @@
 
 #include <graphene/app/database_api.hpp>
+#include <graphene/app/api_reader_pool.hpp>
 
 #include <fc/bloom_filter.hpp>
 
+#include <mutex>
+#include <unordered_map>
+
 #define GET_REQUIRED_FEES_MAX_RECURSION 4
 
 namespace graphene { namespace app {
 
+class database_api_impl;
+
+/** defined in api.cpp */
+vector<account_id_type> get_relevant_accounts( const object* obj );
+
+/**
+ * Resolves the objects changed by a block once for all API sessions of a database: every changed object is looked up
+ * and serialized at most once, and only delivered to the sessions whose subscriptions match the object or one of
+ * its relevant accounts.
+ */
+class object_change_dispatcher
+{
+   public:
+      explicit object_change_dispatcher( graphene::chain::database& db );
+
+      /** returns the dispatcher of @p db, creating it for the first session */
+      static std::shared_ptr<object_change_dispatcher> get( graphene::chain::database& db );
+
+      void add_session( const std::shared_ptr<database_api_impl>& session );
+
+      void on_objects_changed( const vector<object_id_type>& ids );
+      void on_objects_removed( const vector<const object*>& objs );
+
+   private:
+      /** sessions with a subscribe callback or market subscriptions; forgets the closed ones */
+      vector<std::shared_ptr<database_api_impl>> subscribed_sessions();
+
+      /** hands the objects to every matching session, @p obj is null for an object that no longer exists */
+      void dispatch( const vector<std::pair<object_id_type, const object*>>& changes );
+
+      graphene::chain::database&                 _db;
+      std::mutex                                 _sessions_mutex;
+      vector<std::weak_ptr<database_api_impl>>   _sessions;
+      boost::signals2::scoped_connection         _change_connection;
+      boost::signals2::scoped_connection         _removed_connection;
+};
+
 class database_api_impl : public std::enable_shared_from_this<database_api_impl>
 {
    public:
-      explicit database_api_impl( graphene::chain::database& db );
+      database_api_impl( graphene::chain::database& db, const subscription_queue_limits& limits,
+                         const transport_backlog_reader& transport_backlog,
+                         const std::shared_ptr<api_reader_pool>& reader_pool );
+
+      /**
+       * Runs @p call, a read-only call of this session, on the reader pool if there is one. The items the call
+       * subscribes to are collected on the reader thread and added to the filter once it returns, so the
+       * subscription state of the session only changes on the API thread.
+       */
+      template<typename Callable>
+      auto read_only( Callable&& call ) -> decltype(call())
+      {
+         if( !_reader_pool || _reader_pool->is_reader_thread() )
+            return call();
+
+         vector<vector<char>> subscriptions;
+         auto result = _reader_pool->run( [&]() {
+            _collected_subscriptions = &subscriptions;
+            try {
+               auto call_result = call();
+               _collected_subscriptions = nullptr;
+               return call_result;
+            } catch( ... ) {
+               _collected_subscriptions = nullptr;
+               throw;
+            }
+         } );
+         for( const auto& packed : subscriptions )
+            subscribe_to_packed( packed );
+         return result;
+      }
       ~database_api_impl();
 
       // Objects
@@ -22,6 +93,7 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
       void set_pending_transaction_callback( std::function<void(const variant&)> cb );
       void set_block_applied_callback( std::function<void(const variant& block_id)> cb );
       void cancel_all_subscriptions();
+      subscription_queue_info get_subscription_queue_info() const;
 
       // Blocks and transactions
       optional<block_header> get_block_header(uint32_t block_num)const;
@@ -36,6 +108,7 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
       fc::variant_object get_config() const;
       chain_id_type get_chain_id() const;
       dynamic_global_property_object get_dynamic_global_properties() const;
+      response_cache_info get_response_cache_info() const;
 
       // Keys
       vector<vector<account_id_type>> get_key_references( vector<public_key_type> key ) const;
@@ -57,8 +130,8 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
       optional<account_object> get_account_by_name( string name ) const;
       optional<account_object> get_account_by_name_or_id(const string& name_or_id) const;
       optional<account_object> get_account_by_vote_id(const vote_id_type& v_id) const;
-      Unit get_referrals(optional<account_object> account) const;
-      ref_info get_referrals2(optional<account_object> account) const;
+      Unit get_referrals(optional<account_object> account, account_id_type start, uint32_t limit) const;
+      ref_info get_referrals2(optional<account_object> account, account_id_type start, uint32_t limit) const;
       vector<SimpleUnit> get_accounts_info(vector<optional<account_object>> accounts);
       fc::variant_object get_user_count_by_ranks() const;
       int64_t get_user_count_with_balances(fc::time_point_sec start, fc::time_point_sec end) const;
@@ -72,6 +145,9 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
       // Balances
       vector<asset> get_account_balances(account_id_type id, const flat_set<asset_id_type>& assets)const;
       vector<asset> get_named_account_balances(const std::string& name, const flat_set<asset_id_type>& assets)const;
+      account_balance_columns get_asset_balances(asset_id_type asset_id, account_id_type start, uint32_t limit)const;
+      account_balance_columns get_asset_balances_of(asset_id_type asset_id, const vector<account_id_type>& accounts)const;
+      void append_balance_column(account_balance_columns& result, account_id_type account, share_type balance)const;
       vector<balance_object> get_balance_objects( const vector<address>& addrs )const;
       vector<asset> get_vested_balances( const vector<balance_id_type>& objs )const;
       vector<vesting_balance_object> get_vesting_balances( account_id_type account_id )const;
@@ -92,12 +168,23 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
       asset                           get_fund_deposits_amount_by_account(fund_id_type fund_id, account_id_type account_id) const;
       vector<fund_deposit_object>     get_account_deposits(account_id_type account_id, uint32_t start, uint32_t limit) const;
       vector<market_address_object>   get_market_addresses(account_id_type account_id, uint32_t start, uint32_t limit) const;
+      vector<fund_deposit_object>     list_fund_deposits(const std::string& fund_name_or_id, fund_deposit_id_type start,
+                                                         uint32_t limit) const;
+      vector<fund_deposit_object>     list_fund_deposits_by_period(uint32_t period, fund_deposit_id_type start,
+                                                                   uint32_t limit) const;
+      vector<fund_deposit_object>     list_account_deposits(account_id_type account_id, fund_deposit_id_type start,
+                                                            uint32_t limit) const;
+      vector<market_address_object>   list_market_addresses(account_id_type account_id, market_address_id_type start,
+                                                            uint32_t limit) const;
 
       // Markets / feeds
       vector<limit_order_object>      get_limit_orders(asset_id_type a, asset_id_type b, uint32_t limit)const;
       vector<call_order_object>       get_call_orders(asset_id_type a, uint32_t limit)const;
       vector<force_settlement_object> get_settle_orders(asset_id_type a, uint32_t limit)const;
       map<account_id_type, uint16_t>  get_online_info()const;
+      vector<account_online_object>   list_online_info(account_id_type start, uint32_t limit)const;
+      online_info_changes             get_online_info_changes(uint32_t since_block, account_id_type start,
+                                                              uint32_t limit)const;
       vector<call_order_object>       get_margin_positions( const account_id_type& id )const;
       void subscribe_to_market(std::function<void(const variant&)> callback, asset_id_type a, asset_id_type b);
       void unsubscribe_from_market(asset_id_type a, asset_id_type b);
@@ -161,14 +248,20 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
       void subscribe_to_item( const T& i )const
       {
          auto vec = fc::raw::pack(i);
-         if( !_subscribe_callback )
-            return;
+         if( _collected_subscriptions )
+            _collected_subscriptions->push_back( std::move(vec) );
+         else
+            subscribe_to_packed( vec );
+      }
 
-         if( !is_subscribed_to_item(i) )
-         {
-            idump((i));
-            _subscribe_filter.insert( vec.data(), vec.size() );//(vecconst char*)&i, sizeof(i) );
-         }
+      /** adds an item to the filter if there is a subscribe callback, on the API thread only */
+      void subscribe_to_packed( const vector<char>& packed )const;
+
+      /** object ids are kept in the filter in their generic form, that's what the change dispatcher looks up */
+      template<uint8_t SpaceID, uint8_t TypeID>
+      void subscribe_to_item( const object_id<SpaceID, TypeID>& i )const
+      {
+         subscribe_to_item( object_id_type(i) );
       }
 
       template<typename T>
@@ -176,24 +269,63 @@ class database_api_impl : public std::enable_shared_from_this<database_api_impl>
       {
          if( !_subscribe_callback )
             return false;
-         return true;
-         return _subscribe_filter.contains( i );
+         auto vec = fc::raw::pack(i);
+         std::lock_guard<std::mutex> guard( _subscribe_filter_mutex );
+         return is_subscribed_to_packed( vec );
       }
 
-      void broadcast_updates( const vector<variant>& updates );
+      /** used by the change dispatcher, which runs on the API thread, the only one changing the filter */
+      bool is_subscribed_to_packed( const vector<char>& packed )const
+      {
+         return _subscribe_callback && _subscribe_filter.contains( packed.data(), packed.size() );
+      }
+
+      /**
+       * Queues the state of an object for the subscribe callback, replacing a state of the same object that is still
+       * queued. @p size is the estimated size of @p update.
+       */
+      void queue_update( const object_id_type& id, const variant& update, uint64_t size );
+      void queue_market_update( const pair<asset_id_type, asset_id_type>& market, const variant& update, uint64_t size );
+      void queue_block_applied( const variant& block_id );
 
-      /** called every time a block is applied to report the objects that were changed */
-      void on_objects_changed(const vector<object_id_type>& ids);
-      void on_objects_removed(const vector<const object*>& objs);
       void on_applied_block();
 
       mutable fc::bloom_filter                               _subscribe_filter;
+      mutable std::mutex                                     _subscribe_filter_mutex;
       std::function<void(const fc::variant&)> _subscribe_callback;
       std::function<void(const fc::variant&)> _pending_trx_callback;
       std::function<void(const fc::variant&)> _block_applied_callback;
 
-      boost::signals2::scoped_connection _change_connection;
-      boost::signals2::scoped_connection _removed_connection;
+      std::shared_ptr<object_change_dispatcher> _change_dispatcher;
+
+      /** the caller holds _queue_mutex */
+      void schedule_flush();
+      /** drops the queued notifications if a limit is exceeded, the caller holds _queue_mutex */
+      void check_queue_limits();
+      /** delivers everything that is queued, or tries again later while the connection is not keeping up */
+      void flush_queue();
+      /** the bytes the connection has not sent yet */
+      uint64_t transport_bytes() const;
+
+      struct queued_update
+      {
+         object_id_type id;
+         variant        update;
+         uint64_t       size = 0;
+      };
+
+      const subscription_queue_limits                     _queue_limits;
+      const transport_backlog_reader                      _transport_backlog;
+      const std::shared_ptr<api_reader_pool>              _reader_pool;
+      /** where subscribe_to_item() puts the items of a call running on this reader thread */
+      static thread_local vector<vector<char>>*           _collected_subscriptions;
+      mutable std::mutex                                  _queue_mutex;
+      subscription_queue_info                             _queue_info;
+      vector<queued_update>                               _queued_updates;
+      std::unordered_map<object_id_type, size_t>          _queued_positions;
+      map<pair<asset_id_type,asset_id_type>, vector<variant>> _queued_market_updates;
+      optional<variant>                                   _queued_block_id;
+      bool                                                _flush_scheduled = false;
       boost::signals2::scoped_connection _applied_block_connection;
       boost::signals2::scoped_connection _pending_trx_connection;
       map<pair<asset_id_type,asset_id_type>, std::function<void(const variant&)>> _market_subscriptions;
@@ -394,6 +394,7 @@ struct get_impacted_items_visitor
    void operator()( const enable_account_referral_payments_operation& op ) {
       _impacted_accounts.insert(op.account_id);
    }
+   void operator()( const update_online_time_operation& op ) { }
 };
 
 void operation_get_impacted_items(
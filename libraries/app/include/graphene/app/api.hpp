@@ -46,6 +46,10 @@
 #include <string>
 #include <vector>
 
+namespace graphene { namespace app {
+   class cold_history_reader;
+} }
+
 namespace graphene { namespace app {
    using namespace graphene::chain;
    using namespace graphene::market_history;
@@ -59,6 +63,13 @@ namespace graphene { namespace app {
       int               confirmations;
    };
 
+   struct account_history_page
+   {
+      vector<operation_history_object> operations;
+      /// sequence number to pass as start to get the next page, 0 if there are no older operations
+      uint32_t                         next_start = 0;
+   };
+
    struct verify_range_result
    {
       bool        success;
@@ -103,6 +114,22 @@ namespace graphene { namespace app {
                                                               , unsigned limit = 100
                                                               , operation_history_id_type start = operation_history_id_type())const;
 
+         /**
+          * @brief Get a page of operations relevant to the specified account. The start of the page is found
+          * directly instead of walking the history from the most recent operation, so deep pages are as cheap
+          * as the first one.
+          * @param account The account whose history should be queried
+          * @param start Sequence number of the most recent operation to retrieve, 0 for the most recent operation.
+          * To continue, pass the next_start of the previous page.
+          * @param limit Maximum number of operations to retrieve (must not exceed 100)
+          * @param operation_types Types of the operations to retrieve, all types if empty
+          * @return A page of operations performed by account, ordered from most recent to oldest.
+          */
+         account_history_page get_account_history_page(account_id_type account
+                                                       , uint32_t start = 0
+                                                       , unsigned limit = 100
+                                                       , const vector<uint16_t>& operation_types = vector<uint16_t>())const;
+
          vector<listtransactions_result> listtransactions(account_id_type account
                                                           , vector<string> addresses
                                                           , int count = 100) const;
@@ -127,6 +154,7 @@ namespace graphene { namespace app {
                                                               , const vector<uint16_t>& operation_types = vector<uint16_t>()) const;
 
          // available operations: [transfer_operation(0), ...]
+         // operations from start on, oldest first; trimmed or untracked history is scanned in the stored operations
          vector<operation_history_object> get_account_operation_history4(
                                                               account_id_type account
                                                               , operation_history_id_type start = operation_history_id_type()
@@ -148,6 +176,15 @@ namespace graphene { namespace app {
          // contains information about fund's payments (whole and to users)
          vector<fund_history_object::history_item> get_fund_payments_history(fund_id_type fund_id, uint32_t start, uint32_t limit) const;
 
+         /**
+          * @brief Get the daily payments of a fund from the newest to the oldest, a page at a time
+          * @param before Only the items created before this time are returned, or all of them if it is not set;
+          * the next page starts before the create_datetime of the last item returned
+          * @param limit Maximum number of items to fetch (must not exceed 100)
+          */
+         vector<fund_history_object::history_item>
+         list_fund_payments_history(fund_id_type fund_id, fc::time_point before, uint32_t limit) const;
+
          /**
           * @breif Get operations relevant to the specified account referenced
           * by an event numbering specific to the account. The current number of operations
@@ -171,6 +208,9 @@ namespace graphene { namespace app {
          flat_set<uint32_t> get_market_history_buckets()const;
 
       private:
+           /** @return the history entries the history plugin moved out of memory, if any */
+           const cold_history_reader* cold_store()const;
+
            application& _app;
    };
 
@@ -192,6 +232,15 @@ namespace graphene { namespace app {
       std::vector<cheque_object>
       get_account_cheques(account_id_type account_id, uint32_t start, uint32_t limit) const;
 
+      /**
+       * @brief Get the cheques an account has drawn or has been paid from, from the newest to the oldest
+       * @param start ID of the first cheque to return, or 0 to start at the newest one; the next page starts below
+       * the ID of the last cheque returned
+       * @param limit Maximum number of cheques to fetch (must not exceed 100)
+       */
+      std::vector<cheque_object>
+      list_account_cheques(account_id_type account_id, cheque_id_type start, uint32_t limit) const;
+
    private:
       application& _app;
 
@@ -351,7 +400,7 @@ namespace graphene { namespace app {
    class login_api
    {
       public:
-         login_api(application& a);
+         login_api( application& a, const transport_backlog_reader& transport_backlog = transport_backlog_reader() );
          ~login_api();
 
          /**
@@ -384,6 +433,7 @@ namespace graphene { namespace app {
          void enable_api( const string& api_name );
 
          application& _app;
+         const transport_backlog_reader           _transport_backlog;
          optional<fc::api<database_api>>          _database_api;
          optional<fc::api<network_broadcast_api>> _network_broadcast_api;
          optional<fc::api<network_node_api>>      _network_node_api;
@@ -398,6 +448,7 @@ namespace graphene { namespace app {
 extern template class fc::api<graphene::app::login_api>;
 
 FC_REFLECT( graphene::app::listtransactions_result, (transfer)(confirmations) );
+FC_REFLECT( graphene::app::account_history_page, (operations)(next_start) )
 FC_REFLECT( graphene::app::network_broadcast_api::transaction_confirmation,
         (id)(block_num)(trx_num)(trx) )
 FC_REFLECT( graphene::app::verify_range_result,
@@ -410,6 +461,7 @@ FC_REFLECT( graphene::app::verify_range_proof_rewind_result,
 FC_API(graphene::app::history_api,
        (get_accounts_history)
        (get_account_history)
+       (get_account_history_page)
        (listtransactions)
        (get_account_operation_history)
        (get_account_operation_history2)
@@ -418,6 +470,7 @@ FC_API(graphene::app::history_api,
        (get_account_leasing_history)
        (get_fund_history)
        (get_fund_payments_history)
+       (list_fund_payments_history)
        (get_relative_history)
        (get_fill_order_history)
        (get_market_history)
@@ -427,6 +480,7 @@ FC_API(graphene::app::secure_api,
        (get_objects)
        (get_account_blind_transfers2)
        (get_account_cheques)
+       (list_account_cheques)
 )
 FC_API(graphene::app::network_broadcast_api,
        (broadcast_transaction)
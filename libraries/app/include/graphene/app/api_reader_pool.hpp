@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <graphene/chain/database.hpp>
+
+#include <fc/thread/thread.hpp>
+
+#include <atomic>
+#include <shared_mutex>
+#include <memory>
+#include <vector>
+
+namespace graphene { namespace app {
+
+/**
+ * Threads running the read-only API calls of a database, so that they neither wait for nor hold up block application
+ * on the API thread. A call holds the shared lock of the database state while it runs, so it sees the state between
+ * two pushed blocks or transactions.
+ *
+ * The application owns the pool and hands it to the APIs it creates. A call on the pool must not change the state of
+ * its API session, which the API thread reads between calls without locking.
+ */
+class api_reader_pool
+{
+   public:
+      api_reader_pool( const graphene::chain::database& db, uint16_t thread_count );
+      ~api_reader_pool();
+
+      bool is_reader_thread()const;
+
+      template<typename Callable>
+      auto run( Callable&& call ) -> decltype(call())
+      {
+         const graphene::chain::database& db = _db;
+         return next_thread().async( [&db, &call]() {
+            std::shared_lock<graphene::chain::reader_writer_lock> read_guard( db.state_lock() );
+            return call();
+         }, "api reader" ).wait();
+      }
+
+   private:
+      fc::thread& next_thread();
+
+      const graphene::chain::database&          _db;
+      std::vector<std::unique_ptr<fc::thread>>  _threads;
+      std::atomic<uint32_t>                     _next{0};
+};
+
+/**
+ * Runs @p call, a read-only API call, on @p pool if there is one, or right here otherwise.
+ */
+template<typename Callable>
+auto read_only( const std::shared_ptr<api_reader_pool>& pool, Callable&& call ) -> decltype(call())
+{
+   if( !pool || pool->is_reader_thread() )
+      return call();
+   return pool->run( std::forward<Callable>( call ) );
+}
+
+} } // graphene::app
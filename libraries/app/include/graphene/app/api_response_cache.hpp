@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <graphene/app/database_api.hpp>
+#include <graphene/chain/database.hpp>
+
+#include <fc/io/raw.hpp>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+namespace graphene { namespace app {
+
+/**
+ * Results of the read-only API calls which frontends repeat many times per block, shared by all API sessions of a
+ * database and keyed by the method and its packed arguments. The cache is emptied whenever the state changes: when
+ * a block is applied, when a transaction is pushed to the pending state, and when the head block is not the one the
+ * entries were computed on. Once it holds max_entries results, further results are not kept until the next change.
+ */
+class api_response_cache
+{
+   public:
+      api_response_cache( graphene::chain::database& db, uint32_t max_entries );
+
+      /** makes @p cache hold the results of the API calls of its database */
+      static void install( const std::shared_ptr<api_response_cache>& cache );
+      static void uninstall( const graphene::chain::database& db );
+      /** the cache of @p db, null if results are not cached */
+      static std::shared_ptr<api_response_cache> get( const graphene::chain::database& db );
+
+      response_cache_info get_info()const;
+
+      /** returns the cached result of @p method for @p args, or the result of @p compute which is then cached */
+      template<typename Callable, typename... Args>
+      auto fetch( const char* method, Callable&& compute, const Args&... args ) -> std::decay_t<decltype(compute())>
+      {
+         using result_type = std::decay_t<decltype(compute())>;
+         const std::string key = make_key( method, args... );
+         uint64_t generation = 0;
+         if( auto cached = find( key, generation ) )
+            return *std::static_pointer_cast<const result_type>( cached );
+         auto result = std::make_shared<const result_type>( compute() );
+         store( key, generation, result );
+         return *result;
+      }
+
+   private:
+      template<typename... Args>
+      static std::string make_key( const char* method, const Args&... args )
+      {
+         std::string key( method );
+         key.push_back( '\0' );
+         int expand[] = { 0, ( append_packed( key, args ), 0 )... };
+         (void)expand;
+         return key;
+      }
+
+      template<typename T>
+      static void append_packed( std::string& key, const T& arg )
+      {
+         const vector<char> packed = fc::raw::pack( arg );
+         key.append( packed.data(), packed.size() );
+      }
+
+      /** sets @p generation to the state the result of a miss must be computed on */
+      std::shared_ptr<const void> find( const std::string& key, uint64_t& generation );
+      /** keeps @p result unless the state changed since @p generation */
+      void store( const std::string& key, uint64_t generation, std::shared_ptr<const void> result );
+      void invalidate();
+
+      graphene::chain::database&                                      _db;
+      const uint32_t                                                  _max_entries;
+      mutable std::mutex                                              _mutex;
+      std::unordered_map<std::string, std::shared_ptr<const void>>    _entries;
+      block_id_type                                                   _head_block;
+      uint64_t                                                        _generation = 0;
+      response_cache_info                                             _info;
+      boost::signals2::scoped_connection                              _applied_block_connection;
+      boost::signals2::scoped_connection                              _pending_transaction_connection;
+};
+
+/**
+ * Returns the result of @p method for @p args from the response cache of @p db, calling @p compute when there is no
+ * cache or the result is not cached.
+ */
+template<typename Callable, typename... Args>
+auto cached( const graphene::chain::database& db, const char* method, Callable&& compute, const Args&... args )
+   -> std::decay_t<decltype(compute())>
+{
+   auto cache = api_response_cache::get( db );
+   if( !cache )
+      return compute();
+   return cache->fetch( method, std::forward<Callable>( compute ), args... );
+}
+
+} } // graphene::app
@@ -34,6 +34,8 @@ namespace graphene { namespace app {
    using std::string;
 
    class abstract_plugin;
+   struct subscription_queue_limits;
+   class api_reader_pool;
    class op_info {
       public:
       op_info(chain::account_object obj, uint64_t quantity, std::string memo, bool is_transfer = false) {
@@ -57,6 +59,8 @@ namespace graphene { namespace app {
                                    boost::program_options::options_description& configuration_file_options )const;
          void initialize(const fc::path& data_dir, const boost::program_options::variables_map&options);
          void initialize_plugins( const boost::program_options::variables_map& options );
+         /// Opens (or replays) the chain database only; no p2p node or RPC servers are started
+         void open_database();
          void startup();
          void shutdown();
          void startup_plugins();
@@ -96,6 +100,10 @@ namespace graphene { namespace app {
          void set_block_production(bool producing_blocks);
          fc::optional< api_access_info > get_api_access_info( const string& username )const;
          void set_api_access_info(const string& username, api_access_info&& permissions);
+         /// limits of the notification queue of every database API session
+         const subscription_queue_limits& get_subscription_queue_limits()const;
+         /// threads running the read-only API calls, null if they run on the API thread
+         std::shared_ptr<api_reader_pool> get_api_reader_pool()const;
 
          bool is_finished_syncing()const;
          /// Emitted when syncing finishes (is_finished_syncing will return true)
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <graphene/chain/operation_history_object.hpp>
+
+namespace graphene { namespace app {
+   using namespace graphene::chain;
+
+/** An account history entry kept out of the object database */
+struct cold_history_entry
+{
+   uint32_t                  sequence = 0;
+   uint16_t                  op_type = 0;
+   operation_history_id_type operation_id;
+   uint64_t                  offset = 0;
+};
+
+/** Read access to the account history entries a plugin moved out of the object database */
+class cold_history_reader
+{
+   public:
+      virtual ~cold_history_reader() {}
+
+      /** @return the stored entries of @p account ordered by sequence */
+      virtual const vector<cold_history_entry>& entries( account_id_type account )const = 0;
+
+      /** @return the operation of @p item */
+      virtual operation_history_object read( const cold_history_entry& item )const = 0;
+};
+
+/**
+ * Implemented by the plugin that trims account history, so the history API reaches the trimmed entries through
+ * the plugin lookup of the application.
+ */
+class cold_history_provider
+{
+   public:
+      virtual ~cold_history_provider() {}
+
+      /** @return the entries trimmed from memory, or nullptr if they are dropped */
+      virtual const cold_history_reader* cold_history()const = 0;
+};
+
+} } // graphene::app
+
+FC_REFLECT( graphene::app::cold_history_entry, (sequence)(op_type)(operation_id)(offset) )
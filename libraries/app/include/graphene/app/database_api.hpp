@@ -65,6 +65,7 @@ using namespace graphene::market_history;
 using namespace std;
 
 class database_api_impl;
+class api_reader_pool;
 
 struct order
 {
@@ -139,6 +140,75 @@ struct max_transfer_info
    fee_t fee;
 };
 
+/**
+ * Balances of many accounts in one asset as parallel arrays: the n-th entry of every array belongs to the account
+ * with the instance number accounts[n].
+ */
+struct account_balance_columns
+{
+   asset_id_type             asset_id;
+   vector<uint64_t>          accounts;
+   vector<share_type>        balances;
+   vector<share_type>        mature_balances;
+   vector<share_type>        deposits;
+   /// account to continue with, unset when there are no more balances
+   optional<account_id_type> next;
+};
+
+/**
+ * Online minutes changed after a block. When @ref entries_removed is set, the online info of some accounts was
+ * also removed after that block, and the whole list has to be fetched again with list_online_info.
+ */
+struct online_info_changes
+{
+   uint32_t                      head_block_num = 0;
+   bool                          entries_removed = false;
+   vector<account_online_object> changed;
+};
+
+/**
+ * Bounds the notifications a session may have waiting for delivery. A queued update of an object is replaced by a
+ * newer state of the same object. A session whose queue goes over a limit loses the queued updates, and also its
+ * subscriptions if @ref cancel_on_overflow is set.
+ *
+ * The bytes its connection has not written to the socket yet count against @ref max_bytes, and the queue is not
+ * handed to the connection while it holds more than @ref max_transport_bytes.
+ */
+struct subscription_queue_limits
+{
+   uint32_t max_updates = 100000;
+   uint64_t max_bytes = 64 * 1024 * 1024;
+   uint64_t max_transport_bytes = 1024 * 1024;
+   bool     cancel_on_overflow = false;
+};
+
+/** returns the bytes the connection of a session has accepted but not sent yet */
+typedef std::function<uint64_t()> transport_backlog_reader;
+
+struct subscription_queue_info
+{
+   uint32_t queued_updates = 0;
+   uint64_t queued_bytes = 0;
+   // updates replaced by a newer state of the same object before they were delivered
+   uint64_t coalesced_updates = 0;
+   uint64_t dropped_updates = 0;
+   uint32_t overflows = 0;
+   // bytes the connection had not sent yet when last checked
+   uint64_t transport_bytes = 0;
+   // flushes put off because the connection was not keeping up
+   uint64_t deferred_flushes = 0;
+};
+
+struct response_cache_info
+{
+   bool     enabled = false;
+   uint32_t entries = 0;
+   uint64_t hits = 0;
+   uint64_t misses = 0;
+   // times the cached results were dropped because the state changed
+   uint64_t invalidations = 0;
+};
+
 /**
  * @brief The database_api class implements the RPC API for the chain database.
  *
@@ -149,7 +219,9 @@ struct max_transfer_info
 class database_api
 {
    public:
-      database_api(graphene::chain::database& db);
+      database_api( graphene::chain::database& db, const subscription_queue_limits& limits = subscription_queue_limits(),
+                    const transport_backlog_reader& transport_backlog = transport_backlog_reader(),
+                    const std::shared_ptr<api_reader_pool>& reader_pool = std::shared_ptr<api_reader_pool>() );
       ~database_api();
 
       /////////////
@@ -180,6 +252,10 @@ class database_api
        * This unsubscribes from all subscribed markets and objects.
        */
       void cancel_all_subscriptions();
+      /**
+       * @brief Get the state of the queue of notifications waiting for delivery to this session
+       */
+      subscription_queue_info get_subscription_queue_info() const;
 
       /////////////////////////////
       // Blocks and transactions //
@@ -247,6 +323,11 @@ class database_api
        */
       dynamic_global_property_object get_dynamic_global_properties()const;
 
+      /**
+       * @brief Get the hit and miss counts of the response cache shared by the API sessions of this node
+       */
+      response_cache_info get_response_cache_info()const;
+
       //////////
       // Keys //
       //////////
@@ -284,7 +365,19 @@ class database_api
        * @brief Get list of referrals of account
        */
       Unit get_referrals(const std::string& account_name_or_id);
+      /**
+       * @brief Get a page of the referrals of account, in the order of their IDs
+       * @param start ID of the first referral to return
+       * @param limit Maximum number of referrals to return, up to 1000
+       */
+      Unit get_referrals_page(const std::string& account_name_or_id, account_id_type start, uint32_t limit);
       ref_info get_referrals2(const std::string& account_name_or_id);
+      /**
+       * @brief Same as @ref get_referrals2 with a page of the first-level referrals, in the order of their IDs
+       * @param start ID of the first referral to return
+       * @param limit Maximum number of referrals to return, up to 1000
+       */
+      ref_info get_referrals2_page(const std::string& account_name_or_id, account_id_type start, uint32_t limit);
       vector<SimpleUnit> get_accounts_info(vector<string> account_names_or_ids);
       
       /** 
@@ -369,6 +462,23 @@ class database_api
       /// Semantically equivalent to @ref get_account_balances, but takes a name instead of an ID.
       vector<asset> get_named_account_balances(const std::string& name, const flat_set<asset_id_type>& assets)const;
 
+      /**
+       * @brief Get balances of all holders of an asset, in the order of account IDs
+       * @param asset_id ID of the asset to get balances in
+       * @param start ID of the first account to return
+       * @param limit Maximum number of accounts to return, up to 10000
+       * @return Balances, mature balances and deposit sums of accounts with a balance object in the asset
+       *
+       * Balances are as stored, without the mining and mandatory transfer rules of @ref get_account_balances.
+       */
+      account_balance_columns get_asset_balances(asset_id_type asset_id, account_id_type start, uint32_t limit)const;
+
+      /**
+       * @brief Same as @ref get_asset_balances for the given accounts, in the given order
+       * @param accounts IDs of up to 10000 accounts; the balances of unknown accounts are 0
+       */
+      account_balance_columns get_asset_balances_of(asset_id_type asset_id, const vector<account_id_type>& accounts)const;
+
       /** @return all unclaimed balance objects for a set of addresses */
       vector<balance_object> get_balance_objects( const vector<address>& addrs )const;
 
@@ -440,6 +550,15 @@ class database_api
        */
       vector<fund_deposit_object> get_fund_deposits(const std::string& fund_name_or_id, uint32_t start, uint32_t limit) const;
 
+      /**
+       * @brief Get fund deposits from the newest to the oldest, a page at a time
+       * @param start ID of the first deposit to return, or 0 to start at the newest one; the next page starts below
+       * the ID of the last deposit returned
+       * @param limit Maximum number of deposits to fetch (must not exceed 100)
+       */
+      vector<fund_deposit_object>
+      list_fund_deposits(const std::string& fund_name_or_id, fund_deposit_id_type start, uint32_t limit) const;
+
       /**
        * @brief Get all fund deposits alphabetically by id
        * @param period Period (in days)
@@ -449,6 +568,15 @@ class database_api
       pair<vector<fund_deposit_object>, uint32_t>
       get_all_fund_deposits_by_period(uint32_t period, uint32_t start, uint32_t limit) const;
 
+      /**
+       * @brief Get the deposits of all funds for a period from the oldest to the newest, a page at a time
+       * @param period Period (in days)
+       * @param start ID of the first deposit to return; the next page starts after the ID of the last deposit returned
+       * @param limit Maximum number of deposits to fetch (must not exceed 100)
+       */
+      vector<fund_deposit_object>
+      list_fund_deposits_by_period(uint32_t period, fund_deposit_id_type start, uint32_t limit) const;
+
       /**
        * @brief Get sum of all user's deposits
        * @param fund_id ID of fund
@@ -463,6 +591,15 @@ class database_api
        */
       vector<fund_deposit_object> get_account_deposits(account_id_type account_id, uint32_t start, uint32_t limit) const;
 
+      /**
+       * @brief Get the deposits of an account from the newest to the oldest, a page at a time
+       * @param start ID of the first deposit to return, or 0 to start at the newest one; the next page starts below
+       * the ID of the last deposit returned
+       * @param limit Maximum number of deposits to fetch (must not exceed 100)
+       */
+      vector<fund_deposit_object>
+      list_account_deposits(account_id_type account_id, fund_deposit_id_type start, uint32_t limit) const;
+
       /////////////////////
       // Markets / feeds //
       /////////////////////
@@ -473,6 +610,14 @@ class database_api
        */
       vector<market_address_object> get_market_addresses(account_id_type account_id, uint32_t start, uint32_t limit) const;
 
+      /**
+       * @brief Get addresses of the market from the oldest to the newest, a page at a time
+       * @param start ID of the first address to return; the next page starts after the ID of the last address returned
+       * @param limit Maximum number of addresses to fetch (must not exceed 1000)
+       */
+      vector<market_address_object>
+      list_market_addresses(account_id_type account_id, market_address_id_type start, uint32_t limit) const;
+
       /**
        * @brief Get limit orders in a given market
        * @param a ID of asset being sold
@@ -498,8 +643,30 @@ class database_api
        */
       vector<force_settlement_object> get_settle_orders(asset_id_type a, uint32_t limit)const;
 
+      /**
+       * @brief Get online minutes of all accounts
+       * @note The result grows with the number of online accounts, use @ref list_online_info to get it in pages
+       */
       map<account_id_type, uint16_t> get_online_info()const;
 
+      /**
+       * @brief Get a page of online minutes, in the order of account IDs
+       * @param start ID of the first account to return
+       * @param limit Maximum number of entries to return, up to 1000
+       */
+      vector<account_online_object> list_online_info(account_id_type start, uint32_t limit)const;
+
+      /**
+       * @brief Get online minutes changed after a block, in the order of the blocks they were changed in
+       * @param since_block Number of the last block already known to the caller
+       * @param start ID of the first account to return among those changed in the block after since_block
+       * @param limit Maximum number of entries to return, up to 1000
+       *
+       * A full page is continued with since_block set to one less than last_update_block of its last entry and
+       * start set to the next account ID.
+       */
+      online_info_changes get_online_info_changes(uint32_t since_block, account_id_type start, uint32_t limit)const;
+
       /**
        *  @return all open margin positions for a given account id.
        */
@@ -749,9 +916,16 @@ FC_REFLECT( graphene::app::cheque_info_object,
             (payee_amount)
           )
 FC_REFLECT(graphene::app::transfer_fee_info, (amount)(name)(precision))
+FC_REFLECT( graphene::app::subscription_queue_info,
+            (queued_updates)(queued_bytes)(coalesced_updates)(dropped_updates)(overflows)
+            (transport_bytes)(deferred_flushes) )
+FC_REFLECT( graphene::app::response_cache_info, (enabled)(entries)(hits)(misses)(invalidations) )
 
 FC_REFLECT(graphene::app::max_transfer_info::fee_t, (amount)(name)(precision))
 FC_REFLECT(graphene::app::max_transfer_info, (amount)(fee))
+FC_REFLECT( graphene::app::account_balance_columns,
+            (asset_id)(accounts)(balances)(mature_balances)(deposits)(next) )
+FC_REFLECT( graphene::app::online_info_changes, (head_block_num)(entries_removed)(changed) )
 
 extern template class fc::api<graphene::app::database_api>;
 
@@ -765,6 +939,7 @@ FC_API(graphene::app::database_api,
    (set_pending_transaction_callback)
    (set_block_applied_callback)
    (cancel_all_subscriptions)
+   (get_subscription_queue_info)
 
    // Blocks and transactions
    (get_block_header)
@@ -780,6 +955,7 @@ FC_API(graphene::app::database_api,
    (get_config)
    (get_chain_id)
    (get_dynamic_global_properties)
+   (get_response_cache_info)
 
    // Keys
    (get_key_references)
@@ -793,7 +969,9 @@ FC_API(graphene::app::database_api,
    (get_accounts)
    (get_account_addresses)
    (get_referrals)
+   (get_referrals_page)
    (get_referrals2)
+   (get_referrals2_page)
    (get_accounts_info)
    (get_user_count_by_ranks)
    (get_user_count_with_balances)
@@ -811,6 +989,8 @@ FC_API(graphene::app::database_api,
    // Balances
    (get_account_balances)
    (get_named_account_balances)
+   (get_asset_balances)
+   (get_asset_balances_of)
    (get_balance_objects)
    (get_vested_balances)
    (get_vesting_balances)
@@ -825,17 +1005,23 @@ FC_API(graphene::app::database_api,
    (get_fund)
    (get_fund_by_owner)
    (get_fund_deposits)
+   (list_fund_deposits)
    (get_all_fund_deposits_by_period)
+   (list_fund_deposits_by_period)
    (get_fund_deposits_amount_by_account)
    (get_account_deposits)
+   (list_account_deposits)
 
    // Markets / feeds
    (get_market_addresses)
+   (list_market_addresses)
    (get_order_book)
    (get_limit_orders)
    (get_call_orders)
    (get_settle_orders)
    (get_online_info)
+   (list_online_info)
+   (get_online_info_changes)
    (get_margin_positions)
    (subscribe_to_market)
    (unsubscribe_from_market)
@@ -730,9 +730,18 @@ void_result set_online_time_evaluator::do_apply(const set_online_time_operation&
 { try {
    database& d = db();
 
-   d.modify(d.get(accounts_online_id_type()), [&](accounts_online_object& obj) {
-      obj.online_info = o.online_info;
-   });
+   const auto& idx = d.get_index_type<account_online_index>().indices().get<by_account>();
+   vector<account_id_type> removed;
+   for (const account_online_object& obj : idx)
+   {
+      if (!o.online_info.count(obj.owner))
+         removed.push_back(obj.owner);
+   }
+   for (const account_id_type& id : removed)
+      d.remove_online_info(id);
+
+   for (const auto& item : o.online_info)
+      d.set_online_minutes(item.first, item.second);
 
    return void_result();
 } FC_CAPTURE_AND_RETHROW( (o) ) }
@@ -1154,4 +1163,29 @@ void_result enable_account_referral_payments_evaluator::do_apply(const enable_ac
 
 } FC_CAPTURE_AND_RETHROW( (op) ) }
 
+//////////////////////////////////////////////////////////////////////////////////////
+
+void_result update_online_time_evaluator::do_evaluate(const update_online_time_operation& op)
+{ try {
+
+   FC_ASSERT(db().head_block_time() > HARDFORK_638_TIME, "Operation is not available before hardfork 638");
+   return void_result();
+
+} FC_CAPTURE_AND_RETHROW( (op) ) }
+
+void_result update_online_time_evaluator::do_apply(const update_online_time_operation& op)
+{ try {
+
+   database& d = db();
+
+   for (const account_id_type& id : op.removed)
+      d.remove_online_info(id);
+
+   for (const auto& item : op.online_info)
+      d.set_online_minutes(item.first, item.second);
+
+   return void_result();
+
+} FC_CAPTURE_AND_RETHROW( (op) ) }
+
 } } // graphene::chain
@@ -438,10 +438,77 @@ void account_member_index::object_modified(const object& after)
 
 }
 
-void account_referrer_index::object_inserted( const object& obj ) { }
-void account_referrer_index::object_removed( const object& obj ) { }
-void account_referrer_index::about_to_modify( const object& before ) { }
-void account_referrer_index::object_modified( const object& after  ) { }
+void account_referrer_index::object_inserted( const object& obj )
+{
+   const account_object& a = static_cast<const account_object&>(obj);
+   referred_by[a.referrer].insert( a.id );
+}
+
+void account_referrer_index::object_removed( const object& obj )
+{
+   const account_object& a = static_cast<const account_object&>(obj);
+   auto itr = referred_by.find( a.referrer );
+   if( itr == referred_by.end() )
+      return;
+   itr->second.erase( a.id );
+   if( itr->second.empty() )
+      referred_by.erase( itr );
+}
+
+void account_referrer_index::about_to_modify( const object& before )
+{
+   before_referrer = static_cast<const account_object&>(before).referrer;
+}
+
+void account_referrer_index::object_modified( const object& after  )
+{
+   const account_object& a = static_cast<const account_object&>(after);
+   if( a.referrer == before_referrer )
+      return;
+   auto itr = referred_by.find( before_referrer );
+   if( itr != referred_by.end() )
+   {
+      itr->second.erase( a.id );
+      if( itr->second.empty() )
+         referred_by.erase( itr );
+   }
+   referred_by[a.referrer].insert( a.id );
+}
+
+void account_balance_holders_index::object_inserted( const object& obj )
+{
+   const account_balance_object& b = static_cast<const account_balance_object&>(obj);
+   if( b.balance > 0 )
+      ++holders[b.asset_type];
+}
+
+void account_balance_holders_index::object_removed( const object& obj )
+{
+   const account_balance_object& b = static_cast<const account_balance_object&>(obj);
+   if( b.balance > 0 )
+      --holders[b.asset_type];
+}
+
+void account_balance_holders_index::about_to_modify( const object& before )
+{
+   before_positive = static_cast<const account_balance_object&>(before).balance > 0;
+}
+
+void account_balance_holders_index::object_modified( const object& after  )
+{
+   const account_balance_object& b = static_cast<const account_balance_object&>(after);
+   const bool after_positive = b.balance > 0;
+   if( after_positive && !before_positive )
+      ++holders[b.asset_type];
+   else if( before_positive && !after_positive )
+      --holders[b.asset_type];
+}
+
+uint64_t account_balance_holders_index::holders_count( asset_id_type asset )const
+{
+   auto itr = holders.find( asset );
+   return itr == holders.end() ? 0 : itr->second;
+}
 
 } } // graphene::chain
 
@@ -500,7 +567,11 @@ FC_REFLECT_DERIVED_NO_TYPENAME( graphene::chain::restricted_account_object,
                               )
 FC_REFLECT_DERIVED_NO_TYPENAME( graphene::chain::accounts_online_object,
                                 (graphene::db::object),
-                                (online_info)
+                                (last_removal_block)
+                              )
+FC_REFLECT_DERIVED_NO_TYPENAME( graphene::chain::account_online_object,
+                                (graphene::db::object),
+                                (owner)(online_minutes)(last_update_block)
                               )
 FC_REFLECT_DERIVED_NO_TYPENAME( graphene::chain::market_address_object,
                                 (graphene::db::object),
@@ -527,6 +598,7 @@ FC_REFLECT_DERIVED_NO_TYPENAME( graphene::chain::account_mature_balance_object,
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::chain::account_object )
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::chain::restricted_account_object )
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::chain::accounts_online_object )
+GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::chain::account_online_object )
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::chain::market_address_object )
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::chain::blind_transfer2_object )
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::chain::bonus_balances_object )
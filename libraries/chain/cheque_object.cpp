@@ -47,6 +47,62 @@ namespace graphene { namespace chain {
       }
    }
 
+   set<account_id_type> cheque_account_index::get_accounts( const cheque_object& c )const
+   {
+      set<account_id_type> result = { c.drawer };
+      for (const cheque_object::payee_item& item: c.payees)
+      {
+         if (item.status == cheque_status::cheque_used)
+            result.insert(item.payee);
+      }
+      return result;
+   }
+
+   void cheque_account_index::object_inserted( const object& obj )
+   {
+      const cheque_object& c = static_cast<const cheque_object&>(obj);
+      for (const account_id_type& account: get_accounts(c))
+         cheques_by_account[account].insert(c.get_id());
+   }
+
+   void cheque_account_index::object_removed( const object& obj )
+   {
+      const cheque_object& c = static_cast<const cheque_object&>(obj);
+      for (const account_id_type& account: get_accounts(c))
+      {
+         auto itr = cheques_by_account.find(account);
+         if (itr == cheques_by_account.end())
+            continue;
+         itr->second.erase(c.get_id());
+         if (itr->second.empty())
+            cheques_by_account.erase(itr);
+      }
+   }
+
+   void cheque_account_index::about_to_modify( const object& before )
+   {
+      before_accounts = get_accounts(static_cast<const cheque_object&>(before));
+   }
+
+   void cheque_account_index::object_modified( const object& after  )
+   {
+      const cheque_object& c = static_cast<const cheque_object&>(after);
+      set<account_id_type> after_accounts = get_accounts(c);
+      for (const account_id_type& account: before_accounts)
+      {
+         if (after_accounts.count(account))
+            continue;
+         auto itr = cheques_by_account.find(account);
+         if (itr == cheques_by_account.end())
+            continue;
+         itr->second.erase(c.get_id());
+         if (itr->second.empty())
+            cheques_by_account.erase(itr);
+      }
+      for (const account_id_type& account: after_accounts)
+         cheques_by_account[account].insert(c.get_id());
+   }
+
 } } // graphene::chain
 
 FC_REFLECT_DERIVED_NO_TYPENAME( graphene::chain::cheque_object, (graphene::db::object),
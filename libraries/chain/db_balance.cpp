@@ -66,17 +66,9 @@ asset database::get_balance_for_bonus( account_id_type owner, asset_id_type asse
          return asset(0, asset_id);
       }
       auto balance = itr->get_balance();
-      auto online_info = get( accounts_online_id_type() ).online_info;
-      if (!asset_obj.params.mining || !online_info.size()) return balance;
-      auto account_online = online_info.find(owner);
-      if (account_online == online_info.end()) {
-         return asset( 0, asset_id );
-      }
-      else
-      {
-         balance.amount.value *= account_online->second / 1440.0;
-         return balance;
-      }
+      if (!asset_obj.params.mining || !has_online_info()) return balance;
+      balance.amount.value *= get_online_minutes(owner) / 1440.0;
+      return balance;
    }
 }
 
@@ -290,12 +282,66 @@ std::vector<address> database::get_address_batch(int count) const
    return result;
 }
 
-void database::consider_mining_in_mature_balances()
+bool database::has_online_info() const
+{
+   return !get_index_type<account_online_index>().indices().empty();
+}
+
+uint16_t database::get_online_minutes(account_id_type account) const
+{
+   const auto& idx = get_index_type<account_online_index>().indices().get<by_account>();
+   auto itr = idx.find(account);
+   return itr != idx.end() ? itr->online_minutes : 0;
+}
+
+void database::set_online_minutes(account_id_type account, uint16_t minutes)
+{
+   const auto& idx = get_index_type<account_online_index>().indices().get<by_account>();
+   auto itr = idx.find(account);
+   if (itr == idx.end())
+   {
+      create<account_online_object>([&](account_online_object& o) {
+         o.owner = account;
+         o.online_minutes = minutes;
+         o.last_update_block = _current_block_num;
+      });
+   }
+   else if (itr->online_minutes != minutes)
+   {
+      modify(*itr, [&](account_online_object& o) {
+         o.online_minutes = minutes;
+         o.last_update_block = _current_block_num;
+      });
+   }
+}
+
+void database::remove_online_info(account_id_type account)
 {
-   if (!find(accounts_online_id_type())) { return; }
+   const auto& idx = get_index_type<account_online_index>().indices().get<by_account>();
+   auto itr = idx.find(account);
+   if (itr == idx.end()) { return; }
 
-   auto& online_info = get(accounts_online_id_type()).online_info;
-   if ( !online_info.size() ) { return; }
+   remove(*itr);
+   modify(get(accounts_online_id_type()), [&](accounts_online_object& o) {
+      o.last_removal_block = _current_block_num;
+   });
+}
+
+void database::clear_online_info()
+{
+   const auto& idx = get_index_type<account_online_index>().indices();
+   if (idx.empty()) { return; }
+
+   while (!idx.empty())
+      remove(*idx.begin());
+   modify(get(accounts_online_id_type()), [&](accounts_online_object& o) {
+      o.last_removal_block = _current_block_num;
+   });
+}
+
+void database::consider_mining_in_mature_balances()
+{
+   if ( !has_online_info() ) { return; }
 
    const auto& asset_idx = get_index_type<asset_index>();
    const auto& account_idx = get_index_type<chain::account_index>();
@@ -308,18 +354,7 @@ void database::consider_mining_in_mature_balances()
       account_idx.inspect_all_objects( [&]( const object& obj )
       {
          const account_object& account = static_cast<const account_object&>( obj );
-         uint16_t mined_minutes = 0;
-
-         try
-         {
-            auto iter = online_info.find(account.get_id());
-            if (iter != online_info.end()) {
-               mined_minutes = iter->second;
-            }
-         }
-         catch (...) {
-            wlog("exception, ${file}:${func}", ("file", __FILE__)("func", __PRETTY_FUNCTION__));
-         }
+         uint16_t mined_minutes = get_online_minutes(account.get_id());
 
          auto& mat_index = get_index_type<account_mature_balance_index>().indices().get<by_account_asset>();
          auto mat_itr = mat_index.find( boost::make_tuple( account.get_id(), asset.get_id() ) );
@@ -333,16 +368,12 @@ void database::consider_mining_in_mature_balances()
 
 void database::consider_mining_old() 
 {
-   auto& online_info = get( accounts_online_id_type() ).online_info;
-   if (!online_info.size()) return;
+   if (!has_online_info()) return;
    const auto& account_idx = get_index_type<chain::account_index>();
    const auto asset = get_index_type<asset_index>().indices().get<by_symbol>().find(EDC_ASSET_SYMBOL);
    account_idx.inspect_all_objects( [&](const chain::object& obj) {
       const chain::account_object& account = static_cast<const chain::account_object&>(obj);
-      uint16_t mined_minutes = 0;
-      try {
-         mined_minutes = online_info.at(account.get_id());
-      } catch(...) { }
+      uint16_t mined_minutes = get_online_minutes(account.get_id());
       //auto balance = get_mature_balance(account.get_id(), asset->get_id()).amount;
       auto& mat_index = get_index_type<account_mature_balance_index>().indices().get<by_account_asset>();
       auto mat_itr = mat_index.find(boost::make_tuple(account.get_id(), asset->get_id()));
@@ -501,8 +532,7 @@ void database::issue_referral()
    auto& issuer_list = edc_asset->issuer( *this ).blacklisted_accounts;
    auto& alpha_list = ALPHA_ACCOUNT_ID( *this ).blacklisted_accounts;
    int minutes_in_1_day = 1440;
-   auto online_info = get( accounts_online_id_type() ).online_info;
-   double default_online_part = online_info.size() ? 0 : 1;
+   double default_online_part = has_online_info() ? 0 : 1;
    referral_tree rtree( idx, bal_idx, edc_asset->id, account_id_type(), &mat_bal_idx );
    rtree.form();
    auto ops = rtree.scan();
@@ -527,9 +557,7 @@ void database::issue_referral()
 
          if ( (head_block_time() > HARDFORK_618_TIME) && (head_block_time() < HARDFORK_619_TIME) && (default_online_part == 0) )
          {
-            try {
-               online_part = online_info.at(op_info.to_account_id) / (double)minutes_in_1_day;
-            } catch( ... ) { }
+            online_part = get_online_minutes(op_info.to_account_id) / (double)minutes_in_1_day;
          }
          if ( (head_block_time() < HARDFORK_620_TIME) && ( balance.value * 0.0065 * online_part < 1 ) ) { continue; }
 
@@ -37,6 +37,8 @@
 #include <graphene/chain/evaluator.hpp>
 #include <graphene/chain/tree.hpp>
 
+#include <fc/thread/parallel.hpp>
+
 namespace graphene { namespace chain {
 
 bool database::is_known_block( const block_id_type& id )const
@@ -116,10 +118,11 @@ std::vector<block_id_type> database::get_block_ids_on_fork(block_id_type head_of
 bool database::push_block(const signed_block& new_block, uint32_t skip)
 {
   //idump((new_block.block_num())(new_block.id())(new_block.timestamp)(new_block.previous));
+   std::unique_lock<reader_writer_lock> write_guard( _state_lock );
    bool result = false;
    detail::with_skip_flags( *this, skip, [&]()
       {
-         detail::without_pending_transactions( *this, std::move(_pending_tx),
+         detail::without_pending_transactions( *this, std::move(_pending_tx), std::move(_pending_tx_dependencies),
             [&]() {
                result = _push_block(new_block);
             });
@@ -218,6 +221,33 @@ bool database::_push_block(const signed_block& new_block)
    return false;
 } FC_CAPTURE_AND_RETHROW( (new_block) ) }
 
+/**
+ * Completes a block whose transactions were already applied in @p session by _generate_block()
+ * and makes it the new head block, instead of applying the whole block again.
+ * @p signing_witness and @p maint_needed are the results of validating the header on the state
+ * before the transactions, as _apply_block() does.
+ */
+void database::_push_applied_block( const signed_block& new_block, const witness_object& signing_witness,
+                                    bool maint_needed, undo_database::session&& session )
+{ try {
+   uint32_t skip = get_node_properties().skip_flags;
+   undo_database::session block_session( std::move( session ) );
+
+   _apply_block_tail( new_block, signing_witness, maint_needed );
+
+   if( !(skip & skip_fork_db) )
+      _fork_db.push_block( new_block );
+   try {
+      _block_id_to_block.store( new_block.id(), new_block );
+      block_session.commit();
+   } catch ( const fc::exception& e ) {
+      elog( "Failed to push generated block:\n${e}", ("e", e.to_detail_string()) );
+      if( !(skip & skip_fork_db) )
+         _fork_db.remove( new_block.id() );
+      throw;
+   }
+} FC_CAPTURE_AND_RETHROW( (new_block) ) }
+
 /**
  * Attempts to push the transaction into the pending queue
  *
@@ -229,6 +259,7 @@ bool database::_push_block(const signed_block& new_block)
  */
 processed_transaction database::push_transaction( const signed_transaction& trx, uint32_t skip )
 { try {
+   std::unique_lock<reader_writer_lock> write_guard( _state_lock );
    processed_transaction result;
    detail::with_skip_flags( *this, skip, [&]()
    {
@@ -252,6 +283,7 @@ processed_transaction database::_push_transaction( const signed_transaction& trx
    auto temp_session = _undo_db.start_undo_session();
    auto processed_trx = _apply_transaction( trx, false );
    _pending_tx.push_back(processed_trx);
+   _pending_tx_dependencies.push_back( std::move(_current_trx_reads) );
 
    notify_changed_objects();
    // The transaction applied successfully. Merge its changes into the pending block session.
@@ -264,6 +296,8 @@ processed_transaction database::_push_transaction( const signed_transaction& trx
 
 processed_transaction database::validate_transaction( const signed_transaction& trx )
 {
+   // the transaction is applied and undone again
+   std::unique_lock<reader_writer_lock> write_guard( _state_lock );
    auto session = _undo_db.start_undo_session();
    return _apply_transaction( trx );
 }
@@ -317,6 +351,7 @@ signed_block database::generate_block(
    uint32_t skip /* = 0 */
    )
 { try {
+   std::unique_lock<reader_writer_lock> write_guard( _state_lock );
    signed_block result;
    detail::with_skip_flags( *this, skip, [&]()
    {
@@ -371,45 +406,106 @@ signed_block database::_generate_block(
    auto maximum_block_size = get_global_properties().parameters.maximum_block_size;
    size_t total_block_size = max_block_header_size;
 
+   // The packed sizes of pending transactions are cached, so the smallest one is cheap to find.
+   // Once the remaining space falls below it, no further transaction can fit.
+   size_t min_tx_size = std::numeric_limits<size_t>::max();
+   for( const processed_transaction& tx : _pending_tx )
+      min_tx_size = std::min( min_tx_size, tx.get_packed_size() );
+
    signed_block pending_block;
 
+   // The state built below is exactly the state transition of the new block, unless apply_block()
+   // would treat the block specially. In that case it is discarded and the block is pushed as usual.
+   const uint32_t pending_block_num = head_block_num() + 1;
+   const bool apply_in_place = ( (skip & skip_fork_db) || ( _fork_db.head() && _fork_db.head()->id == head_block_id() ) )
+                               && ( _checkpoints.empty() || _checkpoints.rbegin()->first < pending_block_num );
+
    _pending_tx_session = _undo_db.start_undo_session();
 
+   // As in _apply_block(), the header is validated before any transaction of the block is applied,
+   // because a transaction may change the producing witness, e.g. its signing key.
+   const witness_object* signing_witness = nullptr;
+   bool maint_needed = false;
+   if( apply_in_place )
+   {
+      apply_hardcoded_changes( pending_block_num );
+
+      signed_block pending_header;
+      pending_header.previous = head_block_id();
+      pending_header.timestamp = when;
+      pending_header.witness = witness_id;
+      // the block is not signed yet, its signing key has been checked above
+      signing_witness = &validate_block_header( skip | skip_witness_signature, pending_header );
+      maint_needed = ( get_dynamic_global_properties().next_maintenance_time <= when );
+
+      _applied_ops.clear();
+      _current_block_num    = pending_block_num;
+      _current_trx_in_block = 0;
+   }
+
+   // As long as every preceding pending transaction was included, the block is assembled on the same
+   // state as the pending queue, so the authority checks done by the mempool still hold.
+   bool same_state_as_mempool = true;
    uint64_t postponed_tx_count = 0;
-   for( const processed_transaction& tx : _pending_tx )
+   for( size_t i = 0; i < _pending_tx.size(); ++i )
    {
-      size_t new_total_size = total_block_size + fc::raw::pack_size( tx );
+      const processed_transaction& tx = _pending_tx[i];
+
+      if( maximum_block_size < total_block_size + min_tx_size )
+      {
+         postponed_tx_count += _pending_tx.size() - i;
+         break;
+      }
+
+      size_t new_total_size = total_block_size + tx.get_packed_size();
 
       // postpone transaction if it would make block too big
       if( new_total_size > maximum_block_size )
       {
          postponed_tx_count++;
+         same_state_as_mempool = false;
          continue;
       }
 
+      const size_t old_applied_ops_size = _applied_ops.size();
       try
       {
          auto temp_session = _undo_db.start_undo_session();
-         processed_transaction ptx = _apply_transaction( tx );
+         const bool verified = same_state_as_mempool && i < _pending_tx_dependencies.size()
+                               && _pending_tx_dependencies[i].valid();
+         processed_transaction ptx;
+         if( verified )
+         {
+            detail::with_skip_flags( *this, skip | skip_transaction_signatures, [&]()
+            {
+               ptx = _apply_transaction( tx );
+            } );
+         }
+         else
+            ptx = _apply_transaction( tx );
 
-         // We have to recompute pack_size(ptx) because it may be different
-         // than pack_size(tx) (i.e. if one or more results increased
-         // their size)
-         new_total_size = total_block_size + fc::raw::pack_size( ptx );
+         // We have to recompute the packed size of ptx because it may be different
+         // than the one of tx (i.e. if one or more results increased their size)
+         new_total_size = total_block_size + ptx.get_packed_size();
          // postpone transaction if it would make block too big
          if( new_total_size > maximum_block_size )
          {
             postponed_tx_count++;
+            same_state_as_mempool = false;
+            _applied_ops.resize( old_applied_ops_size );
             continue;
          }
 
          temp_session.merge();
 
          total_block_size = new_total_size;
-         pending_block.transactions.push_back( ptx );
+         pending_block.transactions.push_back( std::move( ptx ) );
+         ++_current_trx_in_block;
       }
       catch ( const fc::exception& e )
       {
+         same_state_as_mempool = false;
+         _applied_ops.resize( old_applied_ops_size );
          // Do nothing, transaction will not be re-applied
          wlog( "Transaction was not processed while generating block due to ${e}", ("e", e) );
          wlog( "The transaction was ${t}", ("t", tx) );
@@ -420,6 +516,11 @@ signed_block database::_generate_block(
       wlog( "Postponed ${n} transactions due to block size limit", ("n", postponed_tx_count) );
    }
 
+   // The session holding the included transactions becomes the undo session of the block
+   // if it is applied in place, otherwise it is discarded here.
+   optional<undo_database::session> block_session;
+   if( apply_in_place )
+      block_session = std::move( *_pending_tx_session );
    _pending_tx_session.reset();
 
    // We have temporarily broken the invariant that
@@ -436,7 +537,19 @@ signed_block database::_generate_block(
    if( !(skip & skip_witness_signature) )
       pending_block.sign( block_signing_private_key );
 
-   push_block( pending_block, skip | skip_transaction_signatures ); // skip authority check when pushing self-generated blocks
+   // skip authority check when pushing self-generated blocks
+   if( block_session.valid() )
+   {
+      detail::with_skip_flags( *this, skip | skip_transaction_signatures, [&]()
+      {
+         detail::without_pending_transactions( *this, std::move(_pending_tx), std::move(_pending_tx_dependencies),
+            [&]() {
+               _push_applied_block( pending_block, *signing_witness, maint_needed, std::move( *block_session ) );
+            });
+      });
+   }
+   else
+      push_block( pending_block, skip | skip_transaction_signatures );
 
    return pending_block;
 } FC_CAPTURE_AND_RETHROW( (witness_id) ) }
@@ -447,6 +560,7 @@ signed_block database::_generate_block(
  */
 void database::pop_block()
 { try {
+   std::unique_lock<reader_writer_lock> write_guard( _state_lock );
    _pending_tx_session.reset();
    auto head_id = head_block_id();
    optional<signed_block> head_block = fetch_block_by_id( head_id );
@@ -462,11 +576,31 @@ void database::pop_block()
 
 void database::clear_pending()
 { try {
+   std::unique_lock<reader_writer_lock> write_guard( _state_lock );
    assert( (_pending_tx.size() == 0) || _pending_tx_session.valid() );
    _pending_tx.clear();
+   _pending_tx_dependencies.clear();
    _pending_tx_session.reset();
 } FC_CAPTURE_AND_RETHROW() }
 
+bool database::get_head_block_changes( const block_id_type& previous_head,
+                                       std::unordered_set<object_id_type>& changed )const
+{
+   if( !_undo_db.enabled() || _undo_db.size() == 0 || head_block_num() == 0 )
+      return false;
+
+   // the summary of the block preceding the head block tells whether the head block was built on previous_head
+   const auto& summary = block_summary_id_type( (head_block_num() - 1) & 0xffff )(*this);
+   if( summary.block_id != previous_head )
+      return false;
+
+   const undo_state& head_undo = _undo_db.head();
+   changed.reserve( changed.size() + head_undo.old_values.size() + head_undo.removed.size() );
+   for( const auto& item : head_undo.old_values ) changed.insert( item.first );
+   for( const auto& item : head_undo.removed ) changed.insert( item.first );
+   return true;
+}
+
 uint32_t database::push_applied_operation( const operation& op )
 {
    _applied_ops.emplace_back(op);
@@ -495,15 +629,20 @@ const vector<optional< operation_history_object > >& database::get_applied_opera
 
 //////////////////// private methods ////////////////////
 
-void database::apply_block( const signed_block& next_block, uint32_t skip )
+void database::apply_hardcoded_changes( uint32_t block_num )
 {
-   auto block_num = next_block.block_num(); 
    if (block_num == 1752250)
    {
       modify(get_global_properties(), [] (global_property_object& gpo) {
          gpo.parameters.committee_proposal_review_period = 300;
       }); 
    } 
+}
+
+void database::apply_block( const signed_block& next_block, uint32_t skip )
+{
+   auto block_num = next_block.block_num(); 
+   apply_hardcoded_changes( block_num );
    if( _checkpoints.size() && _checkpoints.rbegin()->second != block_id_type() )
    {
       auto itr = _checkpoints.find( block_num );
@@ -538,7 +677,6 @@ void database::_apply_block( const signed_block& next_block )
               ("id",next_block.id()) );
 
    const witness_object& signing_witness = validate_block_header(skip, next_block);
-   const auto& global_props = get_global_properties();
    //const auto& dynamic_global_props = get<dynamic_global_property_object>(dynamic_global_property_id_type());
    const auto& dynamic_global_props = get_dynamic_global_properties();
    bool maint_needed = (dynamic_global_props.next_maintenance_time <= next_block.timestamp);
@@ -564,13 +702,19 @@ void database::_apply_block( const signed_block& next_block )
       ++_current_trx_in_block;
    }
 
+   _apply_block_tail( next_block, signing_witness, maint_needed );
+} FC_CAPTURE_AND_RETHROW( (next_block.block_num()) )  }
+
+void database::_apply_block_tail( const signed_block& next_block, const witness_object& signing_witness,
+                                  bool maint_needed )
+{ try {
    update_global_dynamic_data(next_block);
    update_signing_witness(signing_witness, next_block);
    update_last_irreversible_block();
 
    // Are we at the maintenance interval?
    if( maint_needed ) {
-      perform_chain_maintenance(next_block, global_props);
+      perform_chain_maintenance(next_block, get_global_properties());
    }
 
    create_block_summary(next_block);
@@ -638,22 +782,29 @@ processed_transaction database::_apply_transaction(const signed_transaction& trx
    auto& trx_idx = get_mutable_index_type<transaction_index>();
    const chain_id_type& chain_id = get_chain_id();
    auto trx_id = trx.id();
+   _current_trx_reads.reset();
    if( !(skip & skip_transaction_dupe_check) )
    {
-      GRAPHENE_ASSERT( trx_idx.indices().get<by_trx_id>().find(trx.id()) == trx_idx.indices().get<by_trx_id>().end(),
+      GRAPHENE_ASSERT( trx_idx.indices().get<by_trx_id>().find(trx_id) == trx_idx.indices().get<by_trx_id>().end(),
                        duplicate_transaction,
                        "Transaction '${txid}' is already in the database",
-                       ("txid",trx.id()) );
+                       ("txid",trx_id) );
    }
    transaction_evaluation_state eval_state(this);
    const chain_parameters& chain_parameters = get_global_properties().parameters;
    eval_state._trx = &trx;
 
+   // the recovered signature keys are cached in ptrx, so they are not recovered again
+   // when the transaction is re-applied from the pending queue
+   processed_transaction ptrx(trx);
    if( !(skip & (skip_transaction_signatures | skip_authority_check) ) )
    {
-      auto get_active = [&]( account_id_type id ) { return &id(*this).active; };
-      auto get_owner  = [&]( account_id_type id ) { return &id(*this).owner;  };
-      trx.verify_authority( chain_id, get_active, get_owner, get_global_properties().parameters.max_authority_depth );
+      // the objects read here are recorded, so a pending transaction is only checked again
+      // when a block changes any of them
+      _current_trx_reads = flat_set<object_id_type>{ global_property_id_type() };
+      auto get_active = [&]( account_id_type id ) { _current_trx_reads->insert( id ); return &id(*this).active; };
+      auto get_owner  = [&]( account_id_type id ) { _current_trx_reads->insert( id ); return &id(*this).owner;  };
+      ptrx.verify_authority( chain_id, get_active, get_owner, get_global_properties().parameters.max_authority_depth );
    }
 
    //Skip all manner of expiration and TaPoS checking if we're on block 1; It's impossible that the transaction is
@@ -663,10 +814,14 @@ processed_transaction database::_apply_transaction(const signed_transaction& trx
       if( !(skip & skip_tapos_check) )
       {
          const auto& tapos_block_summary = block_summary_id_type( trx.ref_block_num )(*this);
+         if( _current_trx_reads.valid() )
+            _current_trx_reads->insert( tapos_block_summary.id );
 
          //Verify TaPoS block summary has correct ID prefix, and that this block's time is not past the expiration
          FC_ASSERT( trx.ref_block_prefix == tapos_block_summary.block_id._hash[1].value() );
       }
+      else
+         _current_trx_reads.reset();
 
       fc::time_point_sec now = head_block_time();
 
@@ -674,6 +829,8 @@ processed_transaction database::_apply_transaction(const signed_transaction& trx
                  ("trx.expiration",trx.expiration)("now",now)("max_til_exp",chain_parameters.maximum_time_until_expiration));
       FC_ASSERT( now <= trx.expiration, "", ("now",now)("trx.exp",trx.expiration) );
    }
+   else
+      _current_trx_reads.reset();
 
    //Insert transaction into unique transactions database.
    if( !(skip & skip_transaction_dupe_check) )
@@ -687,7 +844,6 @@ processed_transaction database::_apply_transaction(const signed_transaction& trx
    eval_state.operation_results.reserve(trx.operations.size());
 
    //Finally process the operations
-   processed_transaction ptrx(trx);
    _current_op_in_trx = 0;
    for( const auto& op : ptrx.operations )
    {
@@ -759,6 +915,60 @@ void database::add_checkpoints( const flat_map<uint32_t,block_id_type>& checkpts
       _checkpoints[i.first] = i.second;
 }
 
+template<typename Trx>
+void database::_precompute_parallel( const Trx* trx, const size_t count, const uint32_t skip )const
+{
+   const chain_id_type chain_id = get_chain_id();
+   for( size_t i = 0; i < count; ++i, ++trx )
+   {
+      // packs and hashes the transaction once, id() and sig_digest() reuse the packed bytes
+      if( !(skip & skip_transaction_dupe_check) )
+         trx->id();
+      if( !(skip & (skip_transaction_signatures | skip_authority_check)) )
+         trx->get_signature_keys( chain_id );
+   }
+}
+
+fc::future<void> database::precompute_parallel( const signed_block& block, const uint32_t skip )const
+{ try {
+   // transactions contained in a block are always applied without signature checks, see _apply_block()
+   const uint32_t trx_skip = skip | skip_transaction_signatures;
+   const bool need_ids    = !(trx_skip & skip_transaction_dupe_check);
+   const bool need_keys   = !(trx_skip & (skip_transaction_signatures | skip_authority_check));
+   const bool need_merkle = !(trx_skip & skip_merkle_check);
+
+   std::vector<fc::future<void>> workers;
+   if( !block.transactions.empty() && (need_ids || need_keys || need_merkle) )
+   {
+      static const size_t chunk_size = 50;
+      workers.reserve( (block.transactions.size() + chunk_size - 1) / chunk_size );
+      for( size_t base = 0; base < block.transactions.size(); base += chunk_size )
+         workers.push_back( fc::do_parallel( [this,&block,base,trx_skip,need_merkle] () {
+            const size_t count = std::min( chunk_size, block.transactions.size() - base );
+            _precompute_parallel( &block.transactions[base], count, trx_skip );
+            if( need_merkle )
+               for( size_t i = base; i < base + count; ++i )
+                  block.transactions[i].merkle_digest();
+         }) );
+   }
+
+   if( workers.empty() )
+      return fc::future<void>( fc::promise<void>::create( true ) );
+
+   auto first = workers.begin();
+   auto worker = first;
+   while( ++worker != workers.end() )
+      worker->wait();
+   return *first;
+} FC_LOG_AND_RETHROW() }
+
+fc::future<void> database::precompute_parallel( const precomputable_transaction& trx )const
+{
+   return fc::do_parallel( [this,&trx] () {
+      _precompute_parallel( &trx, 1, skip_nothing );
+   });
+}
+
 bool database::before_last_checkpoint()const
 {
    return (_checkpoints.size() > 0) && (_checkpoints.rbegin()->first >= head_block_num());
@@ -222,6 +222,7 @@ void database::initialize_evaluators()
    register_evaluator<referral_settings_evaluator>();
    register_evaluator<update_accounts_referrer_evaluator>();
    register_evaluator<enable_account_referral_payments_evaluator>();
+   register_evaluator<update_online_time_evaluator>();
 }
 
 void database::initialize_indexes()
@@ -234,7 +235,8 @@ void database::initialize_indexes()
    add_index<primary_index<force_settlement_index>>();
    add_index<primary_index<fund_index>>();
    add_index<primary_index<fund_deposit_index>>();
-   add_index<primary_index<cheque_index>>();
+   auto cheque_idx = add_index<primary_index<cheque_index>>();
+   cheque_idx->add_secondary_index<cheque_account_index>();
 
    auto acnt_index = add_index<primary_index<account_index>>();
    acnt_index->add_secondary_index<account_member_index>();
@@ -257,7 +259,8 @@ void database::initialize_indexes()
 
    // implementation object indexes
    add_index<primary_index<transaction_index                            >>();
-   add_index<primary_index<account_balance_index                        >>();
+   auto bal_index = add_index<primary_index<account_balance_index>>();
+   bal_index->add_secondary_index<account_balance_holders_index>();
    add_index<primary_index<account_mature_balance_index                 >>();
    add_index<primary_index<bonus_balances_index                         >>();
    add_index<primary_index<asset_bitasset_data_index                    >>();
@@ -277,8 +280,10 @@ void database::initialize_indexes()
    add_index<primary_index<simple_index<fba_accumulator_object    >>>();
    add_index<primary_index<simple_index<account_properties_object >>>();
    add_index<primary_index<simple_index<accounts_online_object    >>>();
+   add_index<primary_index<account_online_index                   >>();
    add_index<primary_index<simple_index<fund_statistics_object    >>>();
    add_index<primary_index<simple_index<fund_history_object       >>>();
+   add_index<primary_index<fund_history_item_index                >>();
    add_index<primary_index<simple_index<settings_object           >>>();
    add_index<primary_index<simple_index<witnesses_info_object     >>>();
 }
@@ -469,9 +474,7 @@ void database::init_genesis(const genesis_state_type& genesis_state)
 
    create<account_properties_object>([&](account_properties_object& p) { });
 
-   create<accounts_online_object>([&](accounts_online_object& p) {
-       p.online_info = map<account_id_type, uint16_t>();
-   });
+   create<accounts_online_object>([&](accounts_online_object& p) { });
 
    // custom settings
    create<settings_object>([&](settings_object& obj) { });
@@ -1031,9 +1031,7 @@ void database::clear_old_entities()
    // cancel online_info for all users
    if (head_block_time() > HARDFORK_618_TIME)
    {
-      modify(get(accounts_online_id_type()), [&](accounts_online_object& o) {
-         o.online_info = map<account_id_type, uint16_t>();
-      });
+      clear_online_info();
    }
 }
 
@@ -1692,8 +1690,7 @@ void database::issue_bonuses_before_620()
    auto& alpha_list = ALPHA_ACCOUNT_ID(*this).blacklisted_accounts;
 
    int minutes_in_1_day = 1440;
-   auto online_info = get( accounts_online_id_type() ).online_info;
-   double default_online_part = online_info.size() ? 0 : 1;
+   double default_online_part = has_online_info() ? 0 : 1;
    rtree.form();
    auto ops = rtree.scan();
    idx.inspect_all_objects( [&](const db::object& obj) {
@@ -1708,9 +1705,7 @@ void database::issue_bonuses_before_620()
       if ( issuer_list.count(account.get_id()) ) return;
       double online_part = default_online_part;
       if (head_block_time() > HARDFORK_618_TIME && head_block_time() < HARDFORK_619_TIME && default_online_part == 0) {
-         try {
-            online_part = online_info.at(account.get_id()) / (double)minutes_in_1_day;
-         } catch(...) {}
+         online_part = get_online_minutes(account.get_id()) / (double)minutes_in_1_day;
       }
       if (head_block_time() > HARDFORK_618_TIME && head_block_time() < HARDFORK_619_TIME)
          quantity *= online_part;
@@ -486,32 +486,31 @@ void fund_object::process(database& db) const
       }
    }
 
-   // erase old history items
+   // add a new history item & erase old ones
    if ( (h_item.daily_payments_owner > 0)
         || (h_item.daily_payments_total > 0)
         || (h_item.daily_payments_without_owner > 0) )
    {
-      const auto& hist_obj = history_id(db);
-      db.modify(hist_obj, [&](fund_history_object& o)
+      db.create<fund_history_item_object>([&](fund_history_item_object& o)
       {
-         o.items.emplace_back(std::move(h_item));
+         o.fund                         = id;
+         o.create_datetime              = h_item.create_datetime;
+         o.daily_payments_without_owner = h_item.daily_payments_without_owner;
+         o.daily_payments_total         = h_item.daily_payments_total;
+         o.daily_payments_owner         = h_item.daily_payments_owner;
+      });
 
-         if (db.get_history_size() > 0)
-         {
-            const time_point& tp = db.head_block_time() - fc::days(db.get_history_size());
+      if (db.get_history_size() > 0)
+      {
+         const time_point& tp = db.head_block_time() - fc::days(db.get_history_size());
 
-            for (auto it = o.items.begin(); it != o.items.end();)
-            {
-               if (it->create_datetime < tp) {
-                  it = o.items.erase(it);
-               }
-               else {
-                  break;
-                  //++it;
-               }
-            }
+         const auto& hist_idx = db.get_index_type<fund_history_item_index>().indices().get<by_fund_datetime>();
+         auto itr = hist_idx.lower_bound(get_id());
+         const auto end = hist_idx.lower_bound(boost::make_tuple(get_id(), tp));
+         while (itr != end) {
+            db.remove(*itr++);
          }
-      });
+      }
    }
 }
 
@@ -555,7 +554,15 @@ void fund_object::finish(database& db) const
 
 FC_REFLECT_DERIVED_NO_TYPENAME( graphene::chain::fund_history_object,
                     (graphene::chain::object),
-                    (owner)(items) )
+                    (owner) )
+
+FC_REFLECT_DERIVED_NO_TYPENAME( graphene::chain::fund_history_item_object,
+                    (graphene::chain::object),
+                    (fund)
+                    (create_datetime)
+                    (daily_payments_without_owner)
+                    (daily_payments_total)
+                    (daily_payments_owner) )
 
 FC_REFLECT_DERIVED_NO_TYPENAME( graphene::chain::fund_statistics_object,
                     (graphene::chain::object),
@@ -619,6 +626,7 @@ FC_REFLECT_DERIVED_NO_TYPENAME( graphene::chain::fund_object,
                     (fund_rates) )
 
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::chain::fund_history_object )
+GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::chain::fund_history_item_object )
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::chain::fund_statistics_object )
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::chain::fund_transaction_history_object )
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::chain::fund_deposit_object )
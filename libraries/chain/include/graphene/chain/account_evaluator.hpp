@@ -239,4 +239,13 @@ public:
    const account_object* account_ptr = nullptr;
 };
 
+class update_online_time_evaluator: public evaluator<update_online_time_evaluator>
+{
+public:
+   typedef update_online_time_operation operation_type;
+
+   void_result do_evaluate(const update_online_time_operation& op);
+   void_result do_apply(const update_online_time_operation& op);
+};
+
 } } // graphene::chain
@@ -210,16 +210,42 @@ namespace graphene { namespace chain {
            optional<uint8_t> restriction_type = 0x6;
    };
 
+   /**
+    * @brief Singleton with the state of the online info as a whole
+    * @ingroup object
+    *
+    * The online minutes themselves are kept per account in @ref account_online_object.
+    */
    class accounts_online_object : public abstract_object<accounts_online_object>
    {
        public:
            static const uint8_t space_id = implementation_ids;
            static const uint8_t type_id  = impl_accounts_online_object_type;
 
-           map<account_id_type, uint16_t> online_info;
+           /// number of the last block in which online info of some account was removed
+           uint32_t last_removal_block = 0;
            accounts_online_id_type get_id() { return id; }
    };
 
+   /**
+    * @brief Online minutes of an account for the last day, used by mining-enabled assets
+    * @ingroup object
+    *
+    * While there are no such objects at all, mining is not limited by online time. Otherwise
+    * accounts without an object are treated as having 0 online minutes.
+    */
+   class account_online_object : public abstract_object<account_online_object>
+   {
+       public:
+           static const uint8_t space_id = implementation_ids;
+           static const uint8_t type_id  = impl_account_online_object_type;
+
+           account_id_type owner;
+           uint16_t        online_minutes = 0;
+           /// number of the block in which online_minutes was last changed
+           uint32_t        last_update_block = 0;
+   };
+
    /**
     * @brief contains address generated for market exchange
     * @ingroup object
@@ -515,8 +541,32 @@ namespace graphene { namespace chain {
 
          /** maps the referrer to the set of accounts that they have referred */
          map< account_id_type, set<account_id_type> > referred_by;
+
+      protected:
+         account_id_type before_referrer;
    };
    
+   /**
+    *  @brief This secondary index of account balances keeps the number of accounts holding a positive balance
+    *  of each asset.
+    */
+   class account_balance_holders_index : public secondary_index
+   {
+      public:
+         virtual void object_inserted( const object& obj ) override;
+         virtual void object_removed( const object& obj ) override;
+         virtual void about_to_modify( const object& before ) override;
+         virtual void object_modified( const object& after  ) override;
+
+         /** @return the number of accounts with a positive balance of @p asset */
+         uint64_t holders_count( asset_id_type asset )const;
+
+      protected:
+         map< asset_id_type, uint64_t > holders;
+
+         bool before_positive = false;
+   };
+
    struct SimpleUnit
    {
       std::string rank = "";
@@ -574,6 +624,7 @@ namespace graphene { namespace chain {
 
    struct by_account_asset;
    struct by_asset_balance;
+   struct by_asset_account;
    struct by_account;
    /**
     * @ingroup object_index
@@ -601,6 +652,13 @@ namespace graphene { namespace chain {
                std::greater< share_type >,
                std::less< account_id_type >
             >
+         >,
+         ordered_unique< tag<by_asset_account>,
+            composite_key<
+               account_balance_object,
+               member<account_balance_object, asset_id_type, &account_balance_object::asset_type>,
+               member<account_balance_object, account_id_type, &account_balance_object::owner>
+            >
          >
       >
    > account_balance_object_multi_index_type;
@@ -670,6 +728,7 @@ namespace graphene { namespace chain {
    /////////////////////////////////////
 
    struct by_name;
+   struct by_register_datetime;
 
    /**
     * @ingroup object_index
@@ -678,7 +737,9 @@ namespace graphene { namespace chain {
       account_object,
       indexed_by<
          ordered_unique< tag<by_id>, member<object, object_id_type, &object::id>>,
-         ordered_unique< tag<by_name>, member<account_object, string, &account_object::name>>
+         ordered_unique< tag<by_name>, member<account_object, string, &account_object::name>>,
+         ordered_non_unique< tag<by_register_datetime>,
+            member<account_object, fc::time_point_sec, &account_object::register_datetime> >
       >
    > account_multi_index_type;
 
@@ -721,7 +782,12 @@ namespace graphene { namespace chain {
       market_address_object,
       indexed_by<
          ordered_unique<tag<by_id>, member<object, object_id_type, &object::id>>,
-         ordered_non_unique<tag<by_market_account_id>, member<market_address_object, account_id_type, &market_address_object::market_account_id>>,
+         ordered_unique<tag<by_market_account_id>,
+            composite_key<market_address_object,
+               member<market_address_object, account_id_type, &market_address_object::market_account_id>,
+               member<object, object_id_type, &object::id>
+            >
+         >,
          ordered_non_unique<tag<by_address>, member<market_address_object, address, &market_address_object::addr>>,
          ordered_non_unique<tag<by_datetime>, member<market_address_object, fc::time_point_sec, &market_address_object::create_datetime>>
       >
@@ -749,6 +815,33 @@ namespace graphene { namespace chain {
     */
    typedef generic_index<restricted_account_object, restricted_account_index_type> restricted_account_index;
 
+   /////////////////////////////////////
+
+   struct by_last_update;
+
+   /**
+    * @ingroup object_index
+    */
+   typedef multi_index_container<
+      account_online_object,
+      indexed_by<
+         ordered_unique< tag<by_id>, member< object, object_id_type, &object::id > >,
+         ordered_unique< tag<by_account>, member< account_online_object, account_id_type, &account_online_object::owner > >,
+         ordered_unique< tag<by_last_update>,
+            composite_key<
+               account_online_object,
+               member<account_online_object, uint32_t, &account_online_object::last_update_block>,
+               member<account_online_object, account_id_type, &account_online_object::owner>
+            >
+         >
+      >
+   > account_online_multi_index_type;
+
+   /**
+    * @ingroup object_index
+    */
+   typedef generic_index<account_online_object, account_online_multi_index_type> account_online_index;
+
 }} // namespace graphene::chain
 
 FC_REFLECT( graphene::chain::SimpleUnit, (rank)(id)(name)(balance));
@@ -768,6 +861,7 @@ MAP_OBJECT_ID_TO_TYPE( graphene::chain::account_balance_object )
 MAP_OBJECT_ID_TO_TYPE( graphene::chain::account_statistics_object )
 MAP_OBJECT_ID_TO_TYPE( graphene::chain::restricted_account_object )
 MAP_OBJECT_ID_TO_TYPE( graphene::chain::accounts_online_object )
+MAP_OBJECT_ID_TO_TYPE( graphene::chain::account_online_object )
 MAP_OBJECT_ID_TO_TYPE( graphene::chain::market_address_object )
 MAP_OBJECT_ID_TO_TYPE( graphene::chain::blind_transfer2_object )
 MAP_OBJECT_ID_TO_TYPE( graphene::chain::bonus_balances_object )
@@ -778,6 +872,7 @@ FC_REFLECT_TYPENAME( graphene::chain::account_balance_object )
 FC_REFLECT_TYPENAME( graphene::chain::account_statistics_object )
 FC_REFLECT_TYPENAME( graphene::chain::restricted_account_object )
 FC_REFLECT_TYPENAME( graphene::chain::accounts_online_object )
+FC_REFLECT_TYPENAME( graphene::chain::account_online_object )
 FC_REFLECT_TYPENAME( graphene::chain::market_address_object )
 FC_REFLECT_TYPENAME( graphene::chain::blind_transfer2_object )
 FC_REFLECT_TYPENAME( graphene::chain::bonus_balances_object )
@@ -788,6 +883,7 @@ GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::chain::account_balance_object
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::chain::account_statistics_object )
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::chain::restricted_account_object )
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::chain::accounts_online_object )
+GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::chain::account_online_object )
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::chain::market_address_object )
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::chain::blind_transfer2_object )
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::chain::bonus_balances_object )
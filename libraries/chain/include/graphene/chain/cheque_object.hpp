@@ -98,6 +98,25 @@ namespace graphene { namespace chain {
     */
    typedef generic_index<cheque_object, cheque_object_index_type> cheque_index;
 
+   /**
+    *  @brief This secondary index maps an account to the cheques it has drawn or has been paid from.
+    */
+   class cheque_account_index : public secondary_index
+   {
+      public:
+         virtual void object_inserted( const object& obj ) override;
+         virtual void object_removed( const object& obj ) override;
+         virtual void about_to_modify( const object& before ) override;
+         virtual void object_modified( const object& after  ) override;
+
+         map< account_id_type, set<cheque_id_type> > cheques_by_account;
+
+      protected:
+         set<account_id_type> get_accounts( const cheque_object& c )const;
+
+         set<account_id_type> before_accounts;
+   };
+
 }}
 
 MAP_OBJECT_ID_TO_TYPE(graphene::chain::cheque_object)
@@ -30,6 +30,7 @@
 #include <graphene/chain/fork_database.hpp>
 #include <graphene/chain/block_database.hpp>
 #include <graphene/chain/genesis_state.hpp>
+#include <graphene/chain/reader_writer_lock.hpp>
 #include <graphene/chain/evaluator.hpp>
 #include <graphene/chain/tree.hpp>
 
@@ -37,6 +38,7 @@
 #include <graphene/db/object.hpp>
 #include <graphene/db/simple_index.hpp>
 #include <fc/signals.hpp>
+#include <fc/thread/future.hpp>
 
 #include <fc/log/logger.hpp>
 
@@ -56,6 +58,7 @@ namespace graphene { namespace chain {
    class call_order_object;
    class fund_object;
    struct budget_record;
+   namespace detail { struct pending_transactions_restorer; }
 
    /**
     *   @class database
@@ -120,6 +123,12 @@ namespace graphene { namespace chain {
          void close(bool rewind = true);
          void set_history_size(int _history_size) { history_size = _history_size; }
 
+         /**
+          * Pushing and popping blocks and transactions holds the write lock, so a reader holding the shared lock
+          * sees the state between two of them, on any thread.
+          */
+         reader_writer_lock& state_lock()const { return _state_lock; }
+
          void enable_registrar_mode() { _registrar_mode_enabled = true; }
          bool registrar_mode_is_enabled() { return _registrar_mode_enabled; }
 
@@ -155,6 +164,24 @@ namespace graphene { namespace chain {
          ///@throws fc::exception if the proposed transaction fails to apply.
          processed_transaction push_proposal( const proposal_object& proposal );
 
+         /**
+          * Precomputes transaction ids and merkle digests and recovers signature keys of all transactions
+          * in the block on the worker thread pool, depending on the skip flags. The results are cached within
+          * the transactions, so that the subsequent push_block() only has to match them against authorities.
+          *
+          * @param block the block to preprocess
+          * @param skip the skip flags which will be used to push the block
+          * @return a future which resolves when all precomputations are done
+          */
+         fc::future<void> precompute_parallel( const signed_block& block, const uint32_t skip = skip_nothing )const;
+
+         /**
+          * Precomputes the id and the signature keys of a transaction on the worker thread pool.
+          * Waiting for the returned future lets the calling task yield, so bursts of incoming
+          * transactions are recovered concurrently.
+          */
+         fc::future<void> precompute_parallel( const precomputable_transaction& trx )const;
+
          signed_block generate_block(
             const fc::time_point_sec when,
             witness_id_type witness_id,
@@ -170,6 +197,15 @@ namespace graphene { namespace chain {
          void pop_block();
          void clear_pending();
 
+         /**
+          * Collects the ids of the objects modified or removed by the head block, provided that the head block
+          * was applied directly on top of @p previous_head and its undo state is still available.
+          *
+          * @return false if the changes are unknown, i.e. after a fork switch or with a disabled undo database
+          */
+         bool get_head_block_changes( const block_id_type& previous_head,
+                                      std::unordered_set<object_id_type>& changed )const;
+
          /**
           *  This method is used to track appied operations during the evaluation of a block, these
           *  operations should include any operation actually included in a transaction as well
@@ -327,6 +363,15 @@ namespace graphene { namespace chain {
          void process_bonus_balances(account_id_type account);
          void consider_mining_in_mature_balances();
 
+         /// @return true if online info was reported for at least one account
+         bool has_online_info() const;
+         /// @return online minutes of the account, 0 if none were reported for it
+         uint16_t get_online_minutes(account_id_type account) const;
+         /// Set online minutes of the account, does nothing if they are unchanged
+         void set_online_minutes(account_id_type account, uint16_t minutes);
+         void remove_online_info(account_id_type account);
+         void clear_online_info();
+
          void issue_referral();
 
          asset check_supply_overflow(asset value);
@@ -463,7 +508,7 @@ namespace graphene { namespace chain {
 
          /** when popping a block, the transactions that were removed get cached here so they
           * can be reapplied at the proper time */
-         std::deque< signed_transaction >       _popped_tx;
+         std::deque< processed_transaction >    _popped_tx;
 
          /**
           * @}
@@ -491,8 +536,17 @@ namespace graphene { namespace chain {
 
       private:
          void                  _apply_block( const signed_block& next_block );
+         void                  _apply_block_tail( const signed_block& next_block,
+                                                  const witness_object& signing_witness, bool maint_needed );
+         void                  apply_hardcoded_changes( uint32_t block_num );
+         void                  _push_applied_block( const signed_block& new_block,
+                                                    const witness_object& signing_witness, bool maint_needed,
+                                                    undo_database::session&& session );
          processed_transaction _apply_transaction( const signed_transaction& trx, bool need_apply_address_creation = true );
 
+         template<typename Trx>
+         void _precompute_parallel( const Trx* trx, const size_t count, const uint32_t skip )const;
+
          ///Steps involved in applying a new block
          ///@{
 
@@ -554,10 +608,17 @@ namespace graphene { namespace chain {
          std::map<account_id_type, tree<leaf_info2>::iterator> referral_map_v2;
 
          int history_size = 0;
+         mutable reader_writer_lock _state_lock;
          // any LTM-member can create accounts
          bool _registrar_mode_enabled = false;
 
+         friend struct detail::pending_transactions_restorer;
          vector< processed_transaction >        _pending_tx;
+         /// objects read by the authority and TaPoS checks of each transaction in _pending_tx,
+         /// empty if the checks were skipped when the transaction was pushed
+         vector< optional< flat_set<object_id_type> > > _pending_tx_dependencies;
+         /// objects read by the authority and TaPoS checks of the transaction being applied
+         optional< flat_set<object_id_type> >           _current_trx_reads;
          fork_database                          _fork_db;
 
          /**
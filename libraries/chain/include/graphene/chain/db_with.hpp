@@ -69,8 +69,10 @@ struct skip_flags_restorer
  */
 struct pending_transactions_restorer
 {
-   pending_transactions_restorer( database& db, std::vector<processed_transaction>&& pending_transactions )
-      : _db(db), _pending_transactions( std::move(pending_transactions) )
+   pending_transactions_restorer( database& db, std::vector<processed_transaction>&& pending_transactions,
+                                  std::vector< optional< flat_set<object_id_type> > >&& dependencies )
+      : _db(db), _pending_transactions( std::move(pending_transactions) ), _dependencies( std::move(dependencies) ),
+        _previous_head( db.head_block_id() )
    {
       _db.clear_pending();
    }
@@ -89,15 +91,35 @@ struct pending_transactions_restorer
          }
       }
       _db._popped_tx.clear();
-      for( const processed_transaction& tx : _pending_transactions )
+
+      // If exactly one block was applied on top of the previous head, the authority and TaPoS checks
+      // of a pending transaction are only repeated when the block changed an object they read.
+      // The operations are always evaluated again.
+      std::unordered_set<object_id_type> changed;
+      const bool incremental = _dependencies.size() == _pending_transactions.size()
+                               && _db.get_head_block_changes( _previous_head, changed );
+      const fc::time_point_sec now = _db.head_block_time();
+
+      for( size_t i = 0; i < _pending_transactions.size(); ++i )
       {
+         const processed_transaction& tx = _pending_transactions[i];
+         // expired and already included transactions would be rejected anyway
+         if( tx.expiration < now || _db.is_known_transaction( tx.id() ) )
+            continue;
          try
          {
-            if( !_db.is_known_transaction( tx.id() ) ) {
-               // since push_transaction() takes a signed_transaction,
-               // the operation_results field will be ignored.
+            // since push_transaction() takes a signed_transaction,
+            // the operation_results field will be ignored.
+            if( incremental && is_unaffected( _dependencies[i], changed ) )
+            {
+               node_property_object& npo = _db.node_properties();
+               skip_flags_restorer skip_restorer( npo, npo.skip_flags );
+               npo.skip_flags |= database::skip_authority_check | database::skip_tapos_check;
                _db._push_transaction( tx );
+               _db._pending_tx_dependencies.back() = std::move( _dependencies[i] );
             }
+            else
+               _db._push_transaction( tx );
          }
          catch( const fc::exception& e )
          {
@@ -109,8 +131,21 @@ struct pending_transactions_restorer
       }
    }
 
+   static bool is_unaffected( const optional< flat_set<object_id_type> >& dependencies,
+                              const std::unordered_set<object_id_type>& changed )
+   {
+      if( !dependencies.valid() )
+         return false;
+      for( const object_id_type& id : *dependencies )
+         if( changed.find( id ) != changed.end() )
+            return false;
+      return true;
+   }
+
    database& _db;
    std::vector< processed_transaction > _pending_transactions;
+   std::vector< optional< flat_set<object_id_type> > > _dependencies;
+   block_id_type _previous_head;
 };
 
 /**
@@ -136,14 +171,17 @@ void with_skip_flags(
  * then reset pending_transactions after callback is done.
  *
  * Pending transactions which no longer validate will be culled.
+ * @p dependencies lists the objects each pending transaction's
+ * authority and TaPoS checks depend on, see pending_transactions_restorer.
  */
 template< typename Lambda >
 void without_pending_transactions(
    database& db,
    std::vector<processed_transaction>&& pending_transactions,
+   std::vector< optional< flat_set<object_id_type> > >&& dependencies,
    Lambda callback )
 {
-    pending_transactions_restorer restorer( db, std::move(pending_transactions) );
+    pending_transactions_restorer restorer( db, std::move(pending_transactions), std::move(dependencies) );
     callback();
     return;
 }
@@ -20,7 +20,8 @@ namespace graphene { namespace chain {
     * @ingroup object
     * @ingroup implementation
     *
-    * This object contains historical data about a fund.
+    * This object contains historical data about a fund. Daily items themselves are stored
+    * as separate @ref fund_history_item_object entries, see @ref fund_history_item_index.
     */
    class fund_history_object: public db::abstract_object<fund_history_object>
    {
@@ -39,12 +40,56 @@ namespace graphene { namespace chain {
          share_type daily_payments_owner;
       };
 
-      std::vector<history_item> items;
-
    }; // fund_history_object
 
    /////////////////////////////////////////////////////////////////////////////////////////////////
 
+   /**
+    * @class fund_history_item_object
+    * @ingroup object
+    * @ingroup implementation
+    *
+    * Daily payments of a fund, one object per fund and maintenance time.
+    */
+   class fund_history_item_object: public db::abstract_object<fund_history_item_object>
+   {
+   public:
+      static const uint8_t space_id = implementation_ids;
+      static const uint8_t type_id = impl_fund_history_item_object_type;
+
+      fund_id_type fund;
+      fc::time_point create_datetime;
+      share_type daily_payments_without_owner;
+      share_type daily_payments_total;
+      share_type daily_payments_owner;
+
+      fund_history_object::history_item get_item() const
+      {
+         return { create_datetime, daily_payments_without_owner, daily_payments_total, daily_payments_owner };
+      }
+
+   }; // fund_history_item_object
+
+   struct by_fund_datetime;
+
+   typedef multi_index_container<
+      fund_history_item_object,
+      indexed_by<
+         ordered_unique<tag<by_id>, member<object, object_id_type, &object::id>>,
+         ordered_unique<tag<by_fund_datetime>,
+            composite_key<fund_history_item_object,
+               member<fund_history_item_object, fund_id_type, &fund_history_item_object::fund>,
+               member<fund_history_item_object, fc::time_point, &fund_history_item_object::create_datetime>,
+               member<object, object_id_type, &object::id>
+            >
+         >
+      >
+   > fund_history_item_multi_index_type;
+
+   typedef generic_index<fund_history_item_object, fund_history_item_multi_index_type> fund_history_item_index;
+
+   /////////////////////////////////////////////////////////////////////////////////////////////////
+
    /**
     * @class fund_statistics_object
     * @ingroup object
@@ -167,9 +212,24 @@ namespace graphene { namespace chain {
       fund_deposit_object,
          indexed_by<
             ordered_unique<tag<by_id>, member<object, object_id_type, &object::id>>,
-            ordered_non_unique<tag<by_account_id>, member<fund_deposit_object, account_id_type, &fund_deposit_object::account_id>>,
-            ordered_non_unique<tag<by_fund_id>, member<fund_deposit_object, fund_id_type, &fund_deposit_object::fund_id>>,
-            ordered_non_unique<tag<by_period>, member<fund_deposit_object, uint32_t, &fund_deposit_object::period>>
+            ordered_unique<tag<by_account_id>,
+               composite_key<fund_deposit_object,
+                  member<fund_deposit_object, account_id_type, &fund_deposit_object::account_id>,
+                  member<object, object_id_type, &object::id>
+               >
+            >,
+            ordered_unique<tag<by_fund_id>,
+               composite_key<fund_deposit_object,
+                  member<fund_deposit_object, fund_id_type, &fund_deposit_object::fund_id>,
+                  member<object, object_id_type, &object::id>
+               >
+            >,
+            ordered_unique<tag<by_period>,
+               composite_key<fund_deposit_object,
+                  member<fund_deposit_object, uint32_t, &fund_deposit_object::period>,
+                  member<object, object_id_type, &object::id>
+               >
+            >
          >
    > fund_deposit_object_index_type;
 
@@ -294,18 +354,21 @@ FC_REFLECT( graphene::chain::fund_history_object::history_item,
             (daily_payments_owner) )
 
 MAP_OBJECT_ID_TO_TYPE(graphene::chain::fund_history_object)
+MAP_OBJECT_ID_TO_TYPE(graphene::chain::fund_history_item_object)
 MAP_OBJECT_ID_TO_TYPE(graphene::chain::fund_statistics_object)
 MAP_OBJECT_ID_TO_TYPE(graphene::chain::fund_transaction_history_object)
 MAP_OBJECT_ID_TO_TYPE(graphene::chain::fund_deposit_object)
 MAP_OBJECT_ID_TO_TYPE(graphene::chain::fund_object)
 
 FC_REFLECT_TYPENAME( graphene::chain::fund_history_object )
+FC_REFLECT_TYPENAME( graphene::chain::fund_history_item_object )
 FC_REFLECT_TYPENAME( graphene::chain::fund_statistics_object )
 FC_REFLECT_TYPENAME( graphene::chain::fund_transaction_history_object )
 FC_REFLECT_TYPENAME( graphene::chain::fund_deposit_object )
 FC_REFLECT_TYPENAME( graphene::chain::fund_object )
 
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::chain::fund_history_object )
+GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::chain::fund_history_item_object )
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::chain::fund_statistics_object )
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::chain::fund_transaction_history_object )
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::chain::fund_deposit_object )
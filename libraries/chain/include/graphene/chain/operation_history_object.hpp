@@ -115,6 +115,7 @@ public:
    uint32_t                             sequence = 0; /// the operation position within the given account
    account_transaction_history_id_type  next;
    fc::time_point_sec                   block_time;
+   uint16_t                             op_type = 0; /// the tag of the operation, for typed history queries
 
    //std::pair<account_id_type,operation_history_id_type>  account_op()const  { return std::tie( account, operation_id ); }
    //std::pair<account_id_type,uint32_t>                   account_seq()const { return std::tie( account, sequence );     }
@@ -123,6 +124,7 @@ public:
 struct by_time;
 struct by_seq;
 struct by_op;
+struct by_type_seq;
 
 typedef multi_index_container<
    account_transaction_history_object,
@@ -140,19 +142,77 @@ typedef multi_index_container<
             member<account_transaction_history_object, account_id_type, &account_transaction_history_object::account>,
             member<account_transaction_history_object, operation_history_id_type, &account_transaction_history_object::operation_id>
          >
+      >,
+      ordered_unique<tag<by_type_seq>,
+         composite_key<account_transaction_history_object,
+            member<account_transaction_history_object, account_id_type, &account_transaction_history_object::account>,
+            member<account_transaction_history_object, uint16_t, &account_transaction_history_object::op_type>,
+            member<account_transaction_history_object, uint32_t, &account_transaction_history_object::sequence>
+         >
       >
    >
 > account_transaction_history_multi_index_type;
 
 typedef generic_index<account_transaction_history_object, account_transaction_history_multi_index_type> account_transaction_history_index;
 
+/////////////////////////////////////////////////////////////////////////
+
+/**
+ *  @brief the market address of a transfer in the history of an account
+ *  @ingroup implementation
+ *  @ingroup object
+ *
+ *  Only the few transfers with an address extension get one, next to their
+ *  account_transaction_history_object with the same account and sequence,
+ *  so that the transfers to an address can be found without walking the
+ *  whole history of the account.
+ */
+class account_address_history_object: public abstract_object<account_address_history_object>
+{
+public:
+   static const uint8_t space_id = implementation_ids;
+   static const uint8_t type_id  = impl_account_address_history_object_type;
+
+   account_id_type            account; /// the account this transfer applies to
+   string                     address; /// the market address of the transfer
+   uint32_t                   sequence = 0; /// the sequence of the transfer in the history of the account
+   operation_history_id_type  operation_id;
+};
+
+struct by_address_seq;
+
+typedef multi_index_container<
+   account_address_history_object,
+   indexed_by<
+      ordered_unique<tag<by_id>, member<object, object_id_type, &object::id>>,
+      ordered_unique<tag<by_seq>,
+         composite_key<account_address_history_object,
+            member<account_address_history_object, account_id_type, &account_address_history_object::account>,
+            member<account_address_history_object, uint32_t, &account_address_history_object::sequence>
+         >
+      >,
+      ordered_unique<tag<by_address_seq>,
+         composite_key<account_address_history_object,
+            member<account_address_history_object, account_id_type, &account_address_history_object::account>,
+            member<account_address_history_object, string, &account_address_history_object::address>,
+            member<account_address_history_object, uint32_t, &account_address_history_object::sequence>
+         >
+      >
+   >
+> account_address_history_multi_index_type;
+
+typedef generic_index<account_address_history_object, account_address_history_multi_index_type> account_address_history_index;
+
 } } // graphene::chain
 
 MAP_OBJECT_ID_TO_TYPE(graphene::chain::operation_history_object)
 MAP_OBJECT_ID_TO_TYPE(graphene::chain::account_transaction_history_object)
+MAP_OBJECT_ID_TO_TYPE(graphene::chain::account_address_history_object)
 
 FC_REFLECT_TYPENAME( graphene::chain::operation_history_object )
 FC_REFLECT_TYPENAME( graphene::chain::account_transaction_history_object )
+FC_REFLECT_TYPENAME( graphene::chain::account_address_history_object )
 
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::chain::operation_history_object )
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::chain::account_transaction_history_object )
+GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::chain::account_address_history_object )
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <fc/thread/mutex.hpp>
+#include <fc/thread/thread.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+namespace graphene { namespace chain {
+
+/**
+ * A reader/writer lock of the chain state. It satisfies the SharedMutex requirements, so std::unique_lock and
+ * std::shared_lock work with it.
+ *
+ * Writers run in fibers of the main thread, next to the p2p and RPC fibers, so nothing here blocks a thread: a
+ * writer queues on an fc::mutex, which is owned by a fiber rather than a thread, and then yields until the readers
+ * have left. The fiber holding the write lock may take it again, which lets push_block() pop blocks and
+ * generate_block() push one, while another fiber of the same thread waits for it. A writer waiting for the lock
+ * keeps new readers out, so a steady stream of readers cannot hold it off.
+ */
+class reader_writer_lock
+{
+   public:
+      void lock()
+      {
+         _write_mutex.lock();
+         if( _write_depth++ > 0 )
+            return;
+         _writing = true;
+         while( _readers.load() > 0 )
+            fc::usleep( fc::microseconds( 50 ) );
+      }
+
+      void unlock()
+      {
+         if( --_write_depth == 0 )
+            _writing = false;
+         _write_mutex.unlock();
+      }
+
+      void lock_shared()
+      {
+         for( ;; )
+         {
+            while( _writing.load() )
+               fc::usleep( fc::microseconds( 50 ) );
+            ++_readers;
+            // a writer that came in meanwhile either sees this reader or is seen here
+            if( !_writing.load() )
+               return;
+            --_readers;
+         }
+      }
+
+      void unlock_shared()
+      {
+         --_readers;
+      }
+
+   private:
+      fc::mutex               _write_mutex;
+      // only changed by the fiber holding _write_mutex
+      uint32_t                _write_depth = 0;
+      std::atomic<bool>       _writing{false};
+      std::atomic<uint32_t>   _readers{0};
+};
+
+} } // graphene::chain
@@ -41,6 +41,8 @@ class referral_tree {
     const account_mature_balance_index* mature_balances_idx;
     tree<leaf_info> form();
     tree<leaf_info> form_old();
+    /** same tree as form_old() for a non-zero root account, built from the referrals of its downline only */
+    tree<leaf_info> form_old_subtree(const account_referrer_index& referrers);
     std::list<referral_info> scan();
     std::list<referral_info> scan_old();
     referral_tree(const account_index& accs, const account_balance_index& bals,
@@ -60,6 +62,9 @@ class referral_tree {
     asset get_balance(account_id_type owner);
     void set_bonus_percents();
     void set_bonus_percents_new();
+
+    private:
+    void append_old(account_id_type account, tree<leaf_info>::iterator referrer);
 };
 
 }}
\ No newline at end of file
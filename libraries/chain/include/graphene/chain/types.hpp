@@ -55,4 +55,7 @@ GRAPHENE_DEFINE_IDS(chain, implementation_ids, impl_,
    (fund_history)                         // [idx: 24]
    (settings)
    (blind_transfer2)                      // [idx: 26]
+   (fund_history_item)
+   (account_online)                       // [idx: 28]
+   (account_address_history)
 )
@@ -127,7 +127,10 @@ FC_REFLECT_DERIVED_NO_TYPENAME( graphene::chain::operation_history_object, (grap
                     (op)(result)(block_num)(trx_in_block)(op_in_trx)(virtual_op)(block_time) )
 
 FC_REFLECT_DERIVED_NO_TYPENAME( graphene::chain::account_transaction_history_object, (graphene::chain::object),
-                    (account)(operation_id)(sequence)(next)(block_time) )
+                    (account)(operation_id)(sequence)(next)(block_time)(op_type) )
+
+FC_REFLECT_DERIVED_NO_TYPENAME( graphene::chain::account_address_history_object, (graphene::chain::object),
+                    (account)(address)(sequence)(operation_id) )
 
 FC_REFLECT_DERIVED_NO_TYPENAME(
    graphene::chain::special_authority_object,
@@ -239,6 +242,7 @@ GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::chain::global_property_obje
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::chain::account_properties_object )
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::chain::operation_history_object )
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::chain::account_transaction_history_object )
+GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::chain::account_address_history_object )
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::chain::special_authority_object )
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::chain::transaction_history_object )
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::chain::withdraw_permission_object )
@@ -1,6 +1,8 @@
 
 #include <graphene/chain/tree.hpp>
 
+#include <algorithm>
+
 namespace graphene { namespace chain {
 
   void leaf_info::add_child_balance_old(chain::account_id_type account_id, int64_t balance, uint32_t level) {
@@ -250,26 +252,61 @@ namespace graphene { namespace chain {
            referrer = referrer_from_map->second;
         }
 
-        const uint64_t account_balance = get_balance(account->get_id()).amount.value;
-        auto account_pos = tree_data.append_child(referrer, leaf_info(account->get_id(), account_balance));
-        referral_map.insert(
-                std::pair<account_id_type, tree<leaf_info>::iterator>(account->get_id(), account_pos));
+        append_old(account->get_id(), referrer);
+     }
+     set_bonus_percents();
+     return tree_data;
+  }
 
-        int level = 1;
-        for (auto &current_node = account_pos;; level++) {
-           const auto &parent_node = tree_data.parent(current_node);
-           if (parent_node == nullptr) break;
+  tree<leaf_info> referral_tree::form_old_subtree(const account_referrer_index& referrers) {
+     if (root_account == account_id_type())
+        return form_old();
 
-//           uint64_t current_balance = get_balance(current_node->account_id).amount.value;
-//           (void)current_balance;
-           parent_node->add_child_balance_old(account->id, account_balance, level);
-           current_node = parent_node;
+     // form_old() visits the accounts by id and skips those whose referrer is not in the tree yet
+     std::vector<std::pair<account_id_type, account_id_type>> downline;
+     std::set<account_id_type> visited = { root_account };
+     std::vector<account_id_type> pending = { root_account };
+     while (!pending.empty()) {
+        const account_id_type referrer = pending.back();
+        pending.pop_back();
+        auto referred = referrers.referred_by.find(referrer);
+        if (referred == referrers.referred_by.end())
+           continue;
+        for (const account_id_type& account: referred->second) {
+           if (account == account_id_type())
+              continue;
+           downline.emplace_back(account, referrer);
+           if (visited.insert(account).second)
+              pending.push_back(account);
         }
      }
+     std::sort(downline.begin(), downline.end());
+
+     for (const auto& account: downline) {
+        auto referrer_from_map = referral_map.find(account.second);
+        if (referrer_from_map == referral_map.end())
+           continue;
+        append_old(account.first, referrer_from_map->second);
+     }
      set_bonus_percents();
      return tree_data;
   }
 
+  void referral_tree::append_old(account_id_type account, tree<leaf_info>::iterator referrer) {
+     const uint64_t account_balance = get_balance(account).amount.value;
+     auto account_pos = tree_data.append_child(referrer, leaf_info(account, account_balance));
+     referral_map.insert(std::pair<account_id_type, tree<leaf_info>::iterator>(account, account_pos));
+
+     int level = 1;
+     for (auto &current_node = account_pos;; level++) {
+        const auto &parent_node = tree_data.parent(current_node);
+        if (parent_node == nullptr) break;
+
+        parent_node->add_child_balance_old(account, account_balance, level);
+        current_node = parent_node;
+     }
+  }
+
   std::list<referral_info> referral_tree::scan_old() {
      std::list<referral_info> operations_storage;
      for (auto &leaf: tree_data) {
@@ -90,6 +90,13 @@ namespace graphene { namespace db {
          void modify( const T& obj, const Lambda& m ) {
             get_mutable_index(obj.id).modify(obj,m);
          }
+         /// Consumes the next id of the index of T without creating an object
+         template<typename T>
+         void skip_next_id() {
+            auto& idx = get_mutable_index<T>();
+            _undo_db.on_skip_id( idx.get_next_id() );
+            idx.use_next_id();
+         }
 
          ///@}
 
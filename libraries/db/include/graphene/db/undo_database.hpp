@@ -91,6 +91,11 @@ public:
     * This should be called just after an object is created
     */
    void on_create( const object& obj );
+   /**
+    * This should be called just before an index hands out @p next_id without creating an object, so that
+    * undoing restores the index's next id
+    */
+   void on_skip_id( object_id_type next_id );
    /**
     * This should be called just before an object is modified
     *
@@ -72,6 +72,18 @@ void undo_database::on_create( const object& obj )
       state.old_index_next_ids[index_id] = obj.id;
    state.new_ids.insert(obj.id);
 }
+void undo_database::on_skip_id( object_id_type next_id )
+{
+   if( _disabled ) return;
+
+   if( _stack.empty() )
+      _stack.emplace_back();
+   auto& state = _stack.back();
+   auto index_id = object_id_type( next_id.space(), next_id.type(), 0 );
+   auto itr = state.old_index_next_ids.find( index_id );
+   if( itr == state.old_index_next_ids.end() )
+      state.old_index_next_ids[index_id] = next_id;
+}
 void undo_database::on_modify( const object& obj )
 {
    if( _disabled ) return;
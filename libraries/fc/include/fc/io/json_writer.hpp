@@ -0,0 +1,227 @@
+#pragma once
+#include <fc/io/json.hpp>
+#include <fc/reflect/variant.hpp>
+#include <fc/safe.hpp>
+#include <fc/static_variant.hpp>
+#include <fc/variant_object.hpp>
+#include <fc/container/flat.hpp>
+
+#include <cstring>
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fc
+{
+   namespace detail
+   {
+      /** true_type if the to_variant() that fc::variant would call for T is the member-wise one of reflected types */
+      template<typename T>
+      auto uses_reflected_to_variant( int ) -> std::is_same< decltype( to_variant( std::declval<const T&>(),
+                                                                                     std::declval<variant&>(),
+                                                                                     uint32_t() ) ),
+                                                             reflected_to_variant >;
+      template<typename T>
+      std::false_type uses_reflected_to_variant( ... );
+   }
+
+   /**
+    *  Writes JSON straight from reflected types into a string, without building the intermediate
+    *  fc::variant tree that json::to_string( variant(v) ) needs.
+    *
+    *  The output is byte-identical to json::to_string( variant( v, max_depth ), format, max_depth ).
+    *  Containers, optionals, static_variants and reflected structs and enums are written directly;
+    *  everything else (ids, keys, hashes, times...) goes through its to_variant(), and so do reflected types
+    *  whose to_variant() is not the member-wise one.
+    */
+   class json_writer
+   {
+      public:
+         json_writer( std::string& out, json::output_formatting format = json::stringify_large_ints_and_doubles );
+
+         template<typename T>
+         static std::string to_string( const T& v, json::output_formatting format, uint32_t max_depth )
+         {
+            std::string result;
+            json_writer( result, format ).write( v, max_depth );
+            return result;
+         }
+
+         void write( bool v, uint32_t max_depth );
+         void write( int8_t v, uint32_t max_depth )   { write_int( v ); }
+         void write( int16_t v, uint32_t max_depth )  { write_int( v ); }
+         void write( int32_t v, uint32_t max_depth )  { write_int( v ); }
+         void write( int64_t v, uint32_t max_depth )  { write_int( v ); }
+         void write( uint8_t v, uint32_t max_depth )  { write_uint( v ); }
+         void write( uint16_t v, uint32_t max_depth ) { write_uint( v ); }
+         void write( uint32_t v, uint32_t max_depth ) { write_uint( v ); }
+         void write( uint64_t v, uint32_t max_depth ) { write_uint( v ); }
+         void write( double v, uint32_t max_depth );
+         void write( float v, uint32_t max_depth )    { write( double( v ), max_depth ); }
+         void write( const std::string& v, uint32_t max_depth );
+         void write( const std::vector<char>& v, uint32_t max_depth );
+         void write( const variant& v, uint32_t max_depth );
+         void write( const variant_object& v, uint32_t max_depth );
+         void write( const mutable_variant_object& v, uint32_t max_depth );
+
+         template<typename T>
+         void write( const safe<T>& v, uint32_t max_depth )
+         {
+            write( static_cast<T>( v.value ), max_depth );
+         }
+
+         template<typename T>
+         void write( const optional<T>& v, uint32_t max_depth )
+         {
+            FC_ASSERT( max_depth > 0, "Recursion depth exceeded!" );
+            if( v.valid() )
+               write( *v, max_depth - 1 );
+            else
+               _out += "null";
+         }
+
+         template<typename T>
+         void write( const std::vector<T>& v, uint32_t max_depth ) { write_array( v, max_depth ); }
+         template<typename T>
+         void write( const std::deque<T>& v, uint32_t max_depth )  { write_array( v, max_depth ); }
+         template<typename T>
+         void write( const std::set<T>& v, uint32_t max_depth )    { write_array( v, max_depth ); }
+         template<typename K, typename T>
+         void write( const std::map<K,T>& v, uint32_t max_depth )  { write_array( v, max_depth ); }
+         template<typename T, typename... A>
+         void write( const flat_set<T,A...>& v, uint32_t max_depth ) { write_array( v, max_depth ); }
+         template<typename K, typename... T>
+         void write( const flat_map<K,T...>& v, uint32_t max_depth ) { write_array( v, max_depth ); }
+
+         template<typename A, typename B>
+         void write( const std::pair<A,B>& v, uint32_t max_depth )
+         {
+            FC_ASSERT( max_depth > 0, "Recursion depth exceeded!" );
+            _out += '[';
+            write( v.first, max_depth - 1 );
+            _out += ',';
+            write( v.second, max_depth - 1 );
+            _out += ']';
+         }
+
+         template<typename... T>
+         void write( const static_variant<T...>& v, uint32_t max_depth )
+         {
+            FC_ASSERT( max_depth > 0, "Recursion depth exceeded!" );
+            _out += '[';
+            write( int64_t( v.which() ), max_depth - 1 );
+            _out += ',';
+            v.visit( static_variant_visitor( *this, max_depth - 1 ) );
+            _out += ']';
+         }
+
+         /** reflected structs and enums are written directly, all other types through their to_variant() */
+         template<typename T>
+         void write( const T& v, uint32_t max_depth )
+         {
+            const bool reflected = fc::reflector<T>::is_defined::value
+                                   && decltype( detail::uses_reflected_to_variant<T>( 0 ) )::value;
+            write_value( v, max_depth, std::integral_constant<bool, reflected>(), std::is_enum<T>() );
+         }
+
+      private:
+         template<typename T>
+         class member_visitor
+         {
+            public:
+               member_visitor( json_writer& w, const T& v, uint32_t max_depth )
+                  : _writer(w), _val(v), _max_depth(max_depth) {}
+
+               template<typename Member, class Class, Member (Class::*member)>
+               void operator()( const char* name )const
+               {
+                  add( name, _val.*member );
+               }
+
+            private:
+               template<typename M>
+               void add( const char* name, const optional<M>& v )const
+               {
+                  if( v.valid() )
+                     add( name, *v );
+               }
+               template<typename M>
+               void add( const char* name, const M& v )const
+               {
+                  if( !_first )
+                     _writer._out += ',';
+                  _first = false;
+                  _writer.write_escaped( name, strlen( name ) );
+                  _writer._out += ':';
+                  _writer.write( v, _max_depth );
+               }
+
+               json_writer&   _writer;
+               const T&       _val;
+               const uint32_t _max_depth;
+               mutable bool   _first = true;
+         };
+
+         struct static_variant_visitor
+         {
+            typedef void result_type;
+            static_variant_visitor( json_writer& w, uint32_t max_depth ) : _writer(w), _max_depth(max_depth) {}
+
+            template<typename T>
+            void operator()( const T& v )const { _writer.write( v, _max_depth ); }
+
+            json_writer&   _writer;
+            const uint32_t _max_depth;
+         };
+
+         template<typename T>
+         void write_value( const T& v, uint32_t max_depth, std::true_type reflected, std::false_type is_enum )
+         {
+            FC_ASSERT( max_depth > 0, "Recursion depth exceeded!" );
+            _out += '{';
+            fc::reflector<T>::visit( member_visitor<T>( *this, v, max_depth - 1 ) );
+            _out += '}';
+         }
+
+         template<typename T>
+         void write_value( const T& v, uint32_t max_depth, std::true_type reflected, std::true_type is_enum )
+         {
+            const std::string name = fc::reflector<T>::to_fc_string( v );
+            write_escaped( name.data(), name.size() );
+         }
+
+         template<typename T, typename IsEnum>
+         void write_value( const T& v, uint32_t max_depth, std::false_type reflected, IsEnum )
+         {
+            write( variant( v, max_depth ), max_depth );
+         }
+
+         template<typename Container>
+         void write_array( const Container& c, uint32_t max_depth )
+         {
+            FC_ASSERT( max_depth > 0, "Recursion depth exceeded!" );
+            _out += '[';
+            bool first = true;
+            for( const auto& item : c )
+            {
+               if( !first )
+                  _out += ',';
+               first = false;
+               write( item, max_depth - 1 );
+            }
+            _out += ']';
+         }
+
+         void write_int( int64_t v );
+         void write_uint( uint64_t v );
+         void write_escaped( const char* str, size_t len );
+
+         std::string&                   _out;
+         const json::output_formatting  _format;
+   };
+
+} // fc
@@ -22,7 +22,11 @@ namespace fc { namespace http {
       public:
          virtual ~websocket_connection(){}
          virtual void send_message( const std::string& message ) = 0;
+         /** sends the message in a binary frame, which is not checked for valid UTF-8 */
+         virtual void send_binary_message( const std::string& message ) { send_message( message ); }
          virtual void close( int64_t code, const std::string& reason  ){};
+         /** bytes accepted by send_message() that are not written to the socket yet */
+         virtual size_t get_buffered_amount()const { return 0; }
          void on_message( const std::string& message ) { _on_message(message); }
          fc::http::reply on_http( const std::string& message ) { return _on_http(message); }
 
@@ -4,8 +4,14 @@
 
 namespace fc
 {
+   /**
+    * Returned by the to_variant() of reflected types, so that json_writer can tell it apart from a to_variant()
+    * written for a particular type, which returns void.
+    */
+   struct reflected_to_variant {};
+
    template<typename T>
-   void to_variant( const T& o, variant& v, uint32_t max_depth );
+   reflected_to_variant to_variant( const T& o, variant& v, uint32_t max_depth );
    template<typename T>
    void from_variant( const variant& v, T& o, uint32_t max_depth );
 
@@ -99,9 +105,10 @@ namespace fc
 
 
    template<typename T>
-   void to_variant( const T& o, variant& v, uint32_t max_depth )
+   reflected_to_variant to_variant( const T& o, variant& v, uint32_t max_depth )
    {
       if_enum<T>::to_variant( o, v, max_depth );
+      return reflected_to_variant();
    }
 
    template<typename T>
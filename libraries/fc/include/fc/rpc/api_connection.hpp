@@ -2,6 +2,7 @@
 #include <fc/variant.hpp>
 #include <fc/optional.hpp>
 #include <fc/api.hpp>
+#include <fc/io/json_writer.hpp>
 #include <boost/any.hpp>
 #include <memory>
 #include <vector>
@@ -131,6 +132,16 @@ namespace fc {
             return _methods[method_id](args);
          }
 
+         /** like call(), but returns the result as JSON text, written straight from the result type if possible */
+         std::string call_json( const string& name, const variants& args )
+         {
+            auto itr = _by_name.find(name);
+            if( itr == _by_name.end() )
+               FC_THROW_EXCEPTION( method_not_found_exception, "No method with name '${name}'",
+                                   ("name",name)("api",_by_name) );
+            return _json_methods[itr->second](args);
+         }
+
          std::weak_ptr< fc::api_connection > get_connection()
          {
             return _api_connection;
@@ -218,9 +229,33 @@ namespace fc {
             template<typename ... Args>
             std::function<variant(const fc::variants&)> to_generic( const std::function<void(Args...)>& f )const;
 
+            template<typename R, typename ... Args>
+            std::function<std::string(const fc::variants&)> to_json_generic( const std::function<R(Args...)>& f )const;
+
+            template<typename Interface, typename Adaptor, typename ... Args>
+            std::function<std::string(const fc::variants&)> to_json_generic(
+                  const std::function<api<Interface,Adaptor>(Args...)>& f )const;
+
+            template<typename Interface, typename Adaptor, typename ... Args>
+            std::function<std::string(const fc::variants&)> to_json_generic(
+                  const std::function<fc::optional<api<Interface,Adaptor>>(Args...)>& f )const;
+
+            template<typename ... Args>
+            std::function<std::string(const fc::variants&)> to_json_generic(
+                  const std::function<fc::api_ptr(Args...)>& f )const;
+
+            template<typename ... Args>
+            std::function<std::string(const fc::variants&)> to_json_generic(
+                  const std::function<void(Args...)>& f )const;
+
+            /** serializes the variant returned by a generic method */
+            std::function<std::string(const fc::variants&)> to_json(
+                  const std::function<variant(const fc::variants&)>& f )const;
+
             template<typename Result, typename... Args>
             void operator()( const char* name, std::function<Result(Args...)>& memb )const {
                _api._methods.emplace_back( to_generic( memb ) );
+               _api._json_methods.emplace_back( to_json_generic( memb ) );
                _api._by_name[name] = _api._methods.size() - 1;
             }
 
@@ -233,6 +268,7 @@ namespace fc {
          boost::any                                              _api;
          std::map< std::string, uint32_t >                       _by_name;
          std::vector< std::function<variant(const variants&)> >  _methods;
+         std::vector< std::function<std::string(const variants&)> > _json_methods;
    }; // class generic_api
 
 
@@ -262,6 +298,12 @@ namespace fc {
             FC_ASSERT( _local_apis.size() > api_id );
             return _local_apis[api_id]->call( method_name, args );
          }
+         std::string receive_call_json( api_id_type api_id, const string& method_name,
+                                        const variants& args = variants() )const
+         {
+            FC_ASSERT( _local_apis.size() > api_id );
+            return _local_apis[api_id]->call_json( method_name, args );
+         }
          variant receive_callback( uint64_t callback_id,  const variants& args = variants() )const
          {
             FC_ASSERT( _local_callbacks.size() > callback_id );
@@ -491,6 +533,59 @@ namespace fc {
       };
    }
 
+   template<typename R, typename ... Args>
+   std::function<std::string(const fc::variants&)> generic_api::api_visitor::to_json_generic(
+                                                   const std::function<R(Args...)>& f )const
+   {
+      auto con = _api_con.lock();
+      FC_ASSERT( con, "not connected" );
+      uint32_t max_depth = con->_max_conversion_depth;
+      generic_api* gapi = &_api;
+      return [f,gapi,max_depth]( const variants& args ) {
+         return json_writer::to_string( gapi->call_generic( f, args.begin(), args.end(), max_depth ),
+                                        json::stringify_large_ints_and_doubles, max_depth );
+      };
+   }
+
+   template<typename Interface, typename Adaptor, typename ... Args>
+   std::function<std::string(const fc::variants&)> generic_api::api_visitor::to_json_generic(
+                                                   const std::function<fc::api<Interface,Adaptor>(Args...)>& f )const
+   {
+      return to_json( to_generic( f ) );
+   }
+
+   template<typename Interface, typename Adaptor, typename ... Args>
+   std::function<std::string(const fc::variants&)> generic_api::api_visitor::to_json_generic(
+                                   const std::function<fc::optional<fc::api<Interface,Adaptor>>(Args...)>& f )const
+   {
+      return to_json( to_generic( f ) );
+   }
+
+   template<typename ... Args>
+   std::function<std::string(const fc::variants&)> generic_api::api_visitor::to_json_generic(
+                                                   const std::function<fc::api_ptr(Args...)>& f )const
+   {
+      return to_json( to_generic( f ) );
+   }
+
+   template<typename ... Args>
+   std::function<std::string(const fc::variants&)> generic_api::api_visitor::to_json_generic(
+                                                   const std::function<void(Args...)>& f )const
+   {
+      return to_json( to_generic( f ) );
+   }
+
+   inline std::function<std::string(const fc::variants&)> generic_api::api_visitor::to_json(
+                                                          const std::function<variant(const fc::variants&)>& f )const
+   {
+      auto con = _api_con.lock();
+      FC_ASSERT( con, "not connected" );
+      uint32_t max_depth = con->_max_conversion_depth;
+      return [f,max_depth]( const variants& args ) {
+         return json::to_string( f( args ), json::stringify_large_ints_and_doubles, max_depth );
+      };
+   }
+
    /**
     * It is slightly unclean tight coupling to have this method in the api class.
     * It breaks encapsulation by requiring an api class method to have a pointer
@@ -32,6 +32,8 @@ namespace fc { namespace rpc {
       optional<std::string>  jsonrpc;
       optional<fc::variant>  result;
       optional<error_object> error;
+      /// the result already serialized to JSON, used instead of result when sending JSON; not reflected
+      optional<std::string>  result_json;
    };
 
    class state
@@ -43,6 +45,7 @@ namespace fc { namespace rpc {
          void add_method( const std::string& name, method m );
          void remove_method( const std::string& name );
 
+         bool    has_method( const string& method_name )const;
          variant local_call( const string& method_name, const variants& args );
          void    handle_reply( const response& response );
 
@@ -5,6 +5,16 @@
 
 namespace fc { namespace rpc {
 
+   /**
+    * First byte of a message packed with fc::raw instead of JSON. Neither value can start a JSON text,
+    * so both encodings can share one connection.
+    */
+   enum binary_message_type : char
+   {
+      binary_response = 0,
+      binary_request  = 1
+   };
+
    class websocket_api_connection : public api_connection
    {
       public:
@@ -23,13 +33,27 @@ namespace fc { namespace rpc {
             uint64_t callback_id,
             variants args = variants() ) override;
 
+         /**
+          * Asks the remote side to send its replies, notices and callbacks packed with fc::raw from now on.
+          * Requests sent from this side stay JSON.
+          */
+         void enable_binary_mode();
+
       protected:
          response on_message( const std::string& message );
+         response on_binary_message( const std::string& message );
          response on_request( const variant& message );
          void     on_response( const variant& message );
 
+         api_id_type resolve_api_id( const variant& api );
+         std::string local_call_json( const string& method_name, const variants& params );
+
+         void send_reply( const response& reply );
+         void send_request( const request& req );
+
          std::shared_ptr<fc::http::websocket_connection>  _connection;
          fc::rpc::state                                   _rpc_state;
+         bool                                             _send_binary = false;
    };
 
 } } // namespace fc::rpc
@@ -0,0 +1,152 @@
+#include <fc/io/json_writer.hpp>
+#include <fc/string.hpp>
+
+namespace fc
+{
+   json_writer::json_writer( std::string& out, json::output_formatting format )
+      : _out(out), _format(format) {}
+
+   void json_writer::write( bool v, uint32_t max_depth )
+   {
+      _out += v ? "true" : "false";
+   }
+
+   void json_writer::write_int( int64_t v )
+   {
+      if( _format == json::stringify_large_ints_and_doubles && ( v > INT32_MAX || v < INT32_MIN ) )
+      {
+         _out += '"';
+         _out += fc::to_string( v );
+         _out += '"';
+      }
+      else
+         _out += fc::to_string( v );
+   }
+
+   void json_writer::write_uint( uint64_t v )
+   {
+      if( _format == json::stringify_large_ints_and_doubles && v > 0xffffffff )
+      {
+         _out += '"';
+         _out += fc::to_string( v );
+         _out += '"';
+      }
+      else
+         _out += fc::to_string( v );
+   }
+
+   void json_writer::write( double v, uint32_t max_depth )
+   {
+      if( _format == json::stringify_large_ints_and_doubles )
+      {
+         _out += '"';
+         _out += fc::to_string( v );
+         _out += '"';
+      }
+      else
+         _out += fc::to_string( v );
+   }
+
+   void json_writer::write( const std::string& v, uint32_t max_depth )
+   {
+      write_escaped( v.data(), v.size() );
+   }
+
+   void json_writer::write( const std::vector<char>& v, uint32_t max_depth )
+   {
+      write( variant( v, max_depth ), max_depth );
+   }
+
+   void json_writer::write( const variant& v, uint32_t max_depth )
+   {
+      FC_ASSERT( max_depth > 0, "Too many nested objects!" );
+      switch( v.get_type() )
+      {
+         case variant::null_type:
+            _out += "null";
+            return;
+         case variant::int64_type:
+            write_int( v.as_int64() );
+            return;
+         case variant::uint64_type:
+            write_uint( v.as_uint64() );
+            return;
+         case variant::double_type:
+            write( v.as_double(), max_depth );
+            return;
+         case variant::bool_type:
+            write( v.as_bool(), max_depth );
+            return;
+         case variant::string_type:
+            write( v.get_string(), max_depth );
+            return;
+         case variant::blob_type:
+            write( v.as_string(), max_depth );
+            return;
+         case variant::array_type:
+            write_array( v.get_array(), max_depth );
+            return;
+         case variant::object_type:
+            write( v.get_object(), max_depth - 1 );
+            return;
+         default:
+            FC_THROW_EXCEPTION( fc::invalid_arg_exception, "Unsupported variant type: ${type}", ( "type", v.get_type() ) );
+      }
+   }
+
+   void json_writer::write( const variant_object& v, uint32_t max_depth )
+   {
+      _out += '{';
+      bool first = true;
+      for( const auto& entry : v )
+      {
+         if( !first )
+            _out += ',';
+         first = false;
+         write_escaped( entry.key().data(), entry.key().size() );
+         _out += ':';
+         write( entry.value(), max_depth );
+      }
+      _out += '}';
+   }
+
+   void json_writer::write( const mutable_variant_object& v, uint32_t max_depth )
+   {
+      FC_ASSERT( max_depth > 0, "Too many nested objects!" );
+      write( variant_object( v ), max_depth - 1 );
+   }
+
+   /** same escaping as json::to_string(), with runs of plain characters copied at once */
+   void json_writer::write_escaped( const char* str, size_t len )
+   {
+      static const char hex[] = "0123456789abcdef";
+      _out += '"';
+      const char* plain = str;
+      const char* end = str + len;
+      for( const char* itr = str; itr != end; ++itr )
+      {
+         const char c = *itr;
+         if( static_cast<unsigned char>(c) >= 0x20 && c != '"' && c != '\\' )
+            continue;
+         _out.append( plain, itr );
+         plain = itr + 1;
+         switch( c )
+         {
+            case '\b': _out += "\\b"; break;
+            case '\f': _out += "\\f"; break;
+            case '\n': _out += "\\n"; break;
+            case '\r': _out += "\\r"; break;
+            case '\t': _out += "\\t"; break;
+            case '\\': _out += "\\\\"; break;
+            case '"':  _out += "\\\""; break;
+            default:
+               _out += "\\u00";
+               _out += hex[ ( c >> 4 ) & 0x0f ];
+               _out += hex[ c & 0x0f ];
+         }
+      }
+      _out.append( plain, end );
+      _out += '"';
+   }
+
+} // fc
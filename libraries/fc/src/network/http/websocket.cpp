@@ -199,11 +199,23 @@ namespace fc { namespace http {
                auto ec = _ws_connection->send( message );
                FC_ASSERT( !ec, "websocket send failed: ${msg}", ("msg",ec.message() ) );
             }
+            virtual void send_binary_message( const std::string& message )override
+            {
+               ilog( "[OUT] ${remote_endpoint} ${size} bytes binary",
+                     ("remote_endpoint",_remote_endpoint) ("size",message.size()) );
+               auto ec = _ws_connection->send( message, websocketpp::frame::opcode::binary );
+               FC_ASSERT( !ec, "websocket send failed: ${msg}", ("msg",ec.message() ) );
+            }
             virtual void close( int64_t code, const std::string& reason  )override
             {
                _ws_connection->close(code,reason);
             }
 
+            virtual size_t get_buffered_amount()const override
+            {
+               return _ws_connection->get_buffered_amount();
+            }
+
             virtual std::string get_request_header(const std::string& key)override
             {
               return _ws_connection->get_request_header(key);
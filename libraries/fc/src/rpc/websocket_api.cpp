@@ -1,9 +1,51 @@
 #include <fc/reflect/variant.hpp>
 #include <fc/rpc/websocket_api.hpp>
 #include <fc/io/json.hpp>
+#include <fc/io/json_writer.hpp>
+#include <fc/io/raw.hpp>
+#include <fc/io/raw_variant.hpp>
 
 namespace fc { namespace rpc {
 
+namespace {
+
+template<typename T>
+std::string pack_message( binary_message_type type, const T& message, uint32_t max_depth )
+{
+   const std::vector<char> packed = fc::raw::pack( message, max_depth );
+   std::string result( 1, type );
+   result.append( packed.begin(), packed.end() );
+   return result;
+}
+
+/** the reflected members of the response in their order, with the pre-serialized result spliced in */
+std::string response_to_json( const response& reply, uint32_t max_depth )
+{
+   if( !reply.result_json )
+      return fc::json::to_string( reply, fc::json::stringify_large_ints_and_doubles, max_depth );
+
+   std::string json( "{" );
+   fc::json_writer writer( json );
+   if( reply.id )
+   {
+      json += "\"id\":";
+      writer.write( *reply.id, max_depth - 1 );
+      json += ',';
+   }
+   if( reply.jsonrpc )
+   {
+      json += "\"jsonrpc\":";
+      writer.write( *reply.jsonrpc, max_depth - 1 );
+      json += ',';
+   }
+   json += "\"result\":";
+   json += *reply.result_json;
+   json += '}';
+   return json;
+}
+
+} // anonymous namespace
+
 websocket_api_connection::~websocket_api_connection()
 {
 }
@@ -16,17 +58,8 @@ websocket_api_connection::websocket_api_connection( const std::shared_ptr<fc::ht
    _rpc_state.add_method( "call", [this]( const variants& args ) -> variant
    {
       FC_ASSERT( args.size() == 3 && args[2].is_array() );
-      api_id_type api_id;
-      if( args[0].is_string() )
-      {
-         variant subresult = this->receive_call( 1, args[0].as_string() );
-         api_id = subresult.as_uint64();
-      }
-      else
-         api_id = args[0].as_uint64();
-
       return this->receive_call(
-         api_id,
+         resolve_api_id( args[0] ),
          args[1].as_string(),
          args[2].get_array() );
    } );
@@ -45,6 +78,13 @@ websocket_api_connection::websocket_api_connection( const std::shared_ptr<fc::ht
       return variant();
    } );
 
+   _rpc_state.add_method( "binary", [this]( const variants& args ) -> variant
+   {
+      FC_ASSERT( args.size() == 1 );
+      _send_binary = args[0].as_bool();
+      return _send_binary;
+   } );
+
    _rpc_state.on_unhandled( [&]( const std::string& method_name, const variants& args )
    {
       return this->receive_call( 0, method_name, args );
@@ -53,8 +93,7 @@ websocket_api_connection::websocket_api_connection( const std::shared_ptr<fc::ht
    _connection->on_message_handler( [this]( const std::string& msg ){
        response reply = on_message(msg);
        if( _connection && ( reply.id || reply.result || reply.error || reply.jsonrpc ) )
-          _connection->send_message( fc::json::to_string( reply, fc::json::stringify_large_ints_and_doubles,
-                                                          _max_conversion_depth ) );
+          send_reply( reply );
    } );
    _connection->on_http_handler( [this]( const std::string& msg ){
        response reply = on_message(msg);
@@ -67,8 +106,7 @@ websocket_api_connection::websocket_api_connection( const std::shared_ptr<fc::ht
              result.status = fc::http::reply::BadRequest;
        }
        if( reply.id || reply.result || reply.error || reply.jsonrpc )
-          result.body_as_string = fc::json::to_string( reply, fc::json::stringify_large_ints_and_doubles,
-                                                       _max_conversion_depth );
+          result.body_as_string = response_to_json( reply, _max_conversion_depth );
        else
           result.status = fc::http::reply::NoContent;
 
@@ -89,9 +127,7 @@ variant websocket_api_connection::send_call(
       return variant(); // TODO return an error?
 
    auto request = _rpc_state.start_remote_call( "call", { api_id, std::move(method_name), std::move(args) } );
-   _connection->send_message( fc::json::to_string( fc::variant( request, _max_conversion_depth ),
-                                                   fc::json::stringify_large_ints_and_doubles,
-                                                   _max_conversion_depth ) );
+   send_request( request );
    return _rpc_state.wait_for_response( *request.id );
 }
 
@@ -103,9 +139,7 @@ variant websocket_api_connection::send_callback(
       return variant(); // TODO return an error?
 
    auto request = _rpc_state.start_remote_call( "callback", { callback_id, std::move(args) } );
-   _connection->send_message( fc::json::to_string( fc::variant( request, _max_conversion_depth ),
-                                                   fc::json::stringify_large_ints_and_doubles,
-                                                   _max_conversion_depth ) );
+   send_request( request );
    return _rpc_state.wait_for_response( *request.id );
 }
 
@@ -117,13 +151,78 @@ void websocket_api_connection::send_notice(
       return;
 
    fc::rpc::request req{ optional<uint64_t>(), "notice", { callback_id, std::move(args) } };
-   _connection->send_message( fc::json::to_string( fc::variant( req, _max_conversion_depth ),
-                                                   fc::json::stringify_large_ints_and_doubles,
-                                                   _max_conversion_depth ) );
+   send_request( req );
+}
+
+void websocket_api_connection::enable_binary_mode()
+{
+   FC_ASSERT( _connection, "The connection is closed" );
+
+   auto request = _rpc_state.start_remote_call( "binary", { true } );
+   send_request( request );
+   _rpc_state.wait_for_response( *request.id );
+}
+
+api_id_type websocket_api_connection::resolve_api_id( const variant& api )
+{
+   if( api.is_string() )
+      return this->receive_call( 1, api.as_string() ).as_uint64();
+   return api.as_uint64();
+}
+
+std::string websocket_api_connection::local_call_json( const string& method_name, const variants& params )
+{
+   if( method_name == "call" )
+   {
+      FC_ASSERT( params.size() == 3 && params[2].is_array() );
+      return this->receive_call_json( resolve_api_id( params[0] ), params[1].as_string(), params[2].get_array() );
+   }
+   return this->receive_call_json( 0, method_name, params );
+}
+
+void websocket_api_connection::send_reply( const response& reply )
+{
+   if( _send_binary )
+      _connection->send_binary_message( pack_message( binary_response, reply, _max_conversion_depth ) );
+   else
+      _connection->send_message( response_to_json( reply, _max_conversion_depth ) );
+}
+
+void websocket_api_connection::send_request( const request& req )
+{
+   if( _send_binary )
+      _connection->send_binary_message( pack_message( binary_request, req, _max_conversion_depth ) );
+   else
+      _connection->send_message( fc::json::to_string( fc::variant( req, _max_conversion_depth ),
+                                                      fc::json::stringify_large_ints_and_doubles,
+                                                      _max_conversion_depth ) );
+}
+
+response websocket_api_connection::on_binary_message( const std::string& message )
+{
+   try
+   {
+      if( message[0] == binary_response )
+      {
+         _rpc_state.handle_reply( fc::raw::unpack<response>( message.data() + 1, message.size() - 1,
+                                                             _max_conversion_depth ) );
+         return response();
+      }
+      return on_request( fc::variant( fc::raw::unpack<request>( message.data() + 1, message.size() - 1,
+                                                                 _max_conversion_depth ),
+                                      _max_conversion_depth ) );
+   }
+   catch( const fc::exception& e )
+   {
+      return response( variant(), { -32700, "Invalid binary message", variant( e, _max_conversion_depth ) }, "2.0" );
+   }
 }
 
 response websocket_api_connection::on_message( const std::string& message )
 {
+   if( !message.empty() && ( message[0] == binary_response || message[0] == binary_request ) )
+      return on_binary_message( message );
+
    variant var;
    try
    {
@@ -196,7 +295,15 @@ response websocket_api_connection::on_request( const variant& var )
       auto start = time_point::now();
 #endif
 
-      auto result = _rpc_state.local_call( call.method, call.params );
+      // API calls answered in JSON are written straight from their result types
+      const bool direct_json = has_id && !_send_binary
+                               && ( call.method == "call" || !_rpc_state.has_method( call.method ) );
+      variant result;
+      optional<std::string> result_json;
+      if( direct_json )
+         result_json = local_call_json( call.method, call.params );
+      else
+         result = _rpc_state.local_call( call.method, call.params );
 
 #ifdef LOG_LONG_API
       auto end = time_point::now();
@@ -210,7 +317,11 @@ response websocket_api_connection::on_request( const variant& var )
 #endif
 
       if( has_id )
-         return response( call.id, result, call.jsonrpc );
+      {
+         response reply( call.id, result, call.jsonrpc );
+         reply.result_json = std::move( result_json );
+         return reply;
+      }
    }
    catch ( const fc::method_not_found_exception& e )
    {
@@ -1,5 +1,7 @@
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
+
 #include <fc/api.hpp>
 #include <fc/io/json.hpp>
 #include <fc/log/logger.hpp>
@@ -101,6 +103,76 @@ BOOST_AUTO_TEST_CASE(login_test) {
    } FC_LOG_AND_RETHROW()
 }
 
+namespace {
+
+/** remembers the first byte of every message received */
+class recording_api_connection : public websocket_api_connection
+{
+   public:
+      recording_api_connection( const websocket_connection_ptr& c, uint32_t max_depth )
+         : websocket_api_connection( c, max_depth )
+      {
+         c->on_message_handler( [this]( const std::string& msg ){
+            first_bytes.push_back( msg.empty() ? '?' : msg[0] );
+            response reply = on_message( msg );
+            if( _connection && ( reply.id || reply.result || reply.error || reply.jsonrpc ) )
+               send_reply( reply );
+         });
+      }
+
+      std::vector<char> first_bytes;
+};
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE(binary_mode_test) {
+   try {
+      fc::api<fc::test::calculator> calc_api( std::make_shared<fc::test::some_calculator>() );
+
+      auto server = std::make_shared<fc::http::websocket_server>("");
+      server->on_connection([&]( const websocket_connection_ptr& c ){
+               auto wsc = std::make_shared<websocket_api_connection>(c, MAX_DEPTH);
+               auto login = std::make_shared<fc::test::login_api>();
+               login->calc = calc_api;
+               wsc->register_api(fc::api<fc::test::login_api>(login));
+               c->set_session_data( wsc );
+          });
+
+      server->listen( 0 );
+      auto listen_port = server->get_listening_port();
+      server->start_accept();
+
+      auto client = std::make_shared<fc::http::websocket_client>();
+      auto con  = client->connect( "ws://localhost:" + std::to_string(listen_port) );
+      server->stop_listening();
+
+      auto apic = std::make_shared<recording_api_connection>(con, MAX_DEPTH);
+      apic->enable_binary_mode();
+      apic->first_bytes.clear();
+
+      auto remote_login_api = apic->get_remote_api<fc::test::login_api>();
+      auto remote_calc = remote_login_api->get_calc();
+      bool remote_triggered = false;
+      remote_calc->on_result( [&remote_triggered]( uint32_t r ) { remote_triggered = true; } );
+      BOOST_CHECK_EQUAL(remote_calc->add( 4, 5 ), 9);
+      BOOST_CHECK(remote_triggered);
+      BOOST_CHECK_EQUAL(remote_calc->sub( 9, 5 ), 4);
+
+      // every message after the reply to "binary" was packed, including the callback
+      BOOST_REQUIRE_GE( apic->first_bytes.size(), 4u );
+      for( char c : apic->first_bytes )
+         BOOST_CHECK( c == fc::rpc::binary_response || c == fc::rpc::binary_request );
+      BOOST_CHECK( std::find( apic->first_bytes.begin(), apic->first_bytes.end(), fc::rpc::binary_request )
+                   != apic->first_bytes.end() );
+
+      client->synchronous_close();
+      server->close();
+      fc::usleep(fc::milliseconds(50));
+      client.reset();
+      server.reset();
+   } FC_LOG_AND_RETHROW()
+}
+
 BOOST_AUTO_TEST_CASE(optionals_test) {
    try {
       auto optionals = std::make_shared<fc::test::optionals_api>();
@@ -8,10 +8,44 @@
 #include <fc/io/fstream.hpp>
 #include <fc/io/iostream.hpp>
 #include <fc/io/json.hpp>
+#include <fc/io/json_writer.hpp>
 #include <fc/io/sstream.hpp>
+#include <fc/static_variant.hpp>
+#include <fc/time.hpp>
 
 #include <fstream>
 
+namespace fc { namespace test {
+
+enum writer_color { red, green };
+
+struct writer_leaf
+{
+   std::string             name;
+   int64_t                 big = 0;
+   optional<uint32_t>      maybe;
+};
+
+struct writer_tree
+{
+   writer_color                                   color = red;
+   std::vector<writer_leaf>                       leaves;
+   flat_map<std::string, uint64_t>                totals;
+   std::set<int16_t>                              small;
+   static_variant<writer_leaf, std::string>       either;
+   std::vector<char>                              bytes;
+   std::pair<bool, double>                        flag;
+   time_point_sec                                 when;
+   variant                                        extra;
+   optional<writer_leaf>                          missing;
+};
+
+} } // fc::test
+
+FC_REFLECT_ENUM( fc::test::writer_color, (red)(green) )
+FC_REFLECT( fc::test::writer_leaf, (name)(big)(maybe) )
+FC_REFLECT( fc::test::writer_tree, (color)(leaves)(totals)(small)(either)(bytes)(flag)(when)(extra)(missing) )
+
 BOOST_AUTO_TEST_SUITE(json_tests)
 
 static void replace_some( std::string& str )
@@ -332,6 +366,37 @@ BOOST_AUTO_TEST_CASE(recursion_test)
    BOOST_CHECK_THROW( fc::json::to_string( nested, fc::json::stringify_large_ints_and_doubles, 9 ), fc::assert_exception );
 }
 
+BOOST_AUTO_TEST_CASE(json_writer_test)
+{
+   fc::test::writer_tree tree;
+   tree.color = fc::test::green;
+   tree.leaves.push_back( { "plain", 42, fc::optional<uint32_t>() } );
+   tree.leaves.push_back( { "tab\tquote\"back\\slash\x01\x1f\x7f", int64_t(0x100000000LL), 0xffffffffu } );
+   tree.leaves.push_back( { "", -int64_t(0x100000000LL), 7u } );
+   tree.totals["a"] = 1;
+   tree.totals["b"] = uint64_t(0x100000000ULL);
+   tree.small = { -3, 0, 300 };
+   tree.either = std::string( "right" );
+   tree.bytes = { '\x00', '\x7f', '\xff' };
+   tree.flag = { true, 0.25 };
+   tree.when = fc::time_point_sec( 1500000000 );
+   tree.extra = fc::mutable_variant_object( "x", 1 )( "y", fc::variants{ fc::variant(), "z" } );
+
+   for( auto format : { fc::json::stringify_large_ints_and_doubles, fc::json::legacy_generator } )
+   {
+      BOOST_CHECK_EQUAL( fc::json::to_string( fc::variant( tree, 20 ), format, 20 ),
+                         fc::json_writer::to_string( tree, format, 20 ) );
+      tree.either = tree.leaves[1];
+      BOOST_CHECK_EQUAL( fc::json::to_string( fc::variant( tree, 20 ), format, 20 ),
+                         fc::json_writer::to_string( tree, format, 20 ) );
+   }
+   BOOST_CHECK_EQUAL( fc::json::to_string( fc::variant( tree.leaves, 20 ) ),
+                      fc::json_writer::to_string( tree.leaves, fc::json::stringify_large_ints_and_doubles, 20 ) );
+
+   BOOST_CHECK_THROW( fc::json_writer::to_string( tree, fc::json::stringify_large_ints_and_doubles, 2 ),
+                      fc::assert_exception );
+}
+
 BOOST_AUTO_TEST_CASE(rethrow_test)
 {
    fc::variants biggie;
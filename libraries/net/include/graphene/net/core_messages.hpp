@@ -41,6 +41,7 @@
 
 namespace graphene { namespace net {
   using graphene::chain::signed_transaction;
+  using graphene::chain::precomputable_transaction;
   using graphene::chain::block_id_type;
   using graphene::chain::transaction_id_type;
   using graphene::chain::signed_block;
@@ -95,7 +96,7 @@ namespace graphene { namespace net {
    {
       static const core_message_type_enum type;
 
-      signed_transaction trx;
+      precomputable_transaction trx;
       trx_message() {}
       trx_message(signed_transaction transaction) :
         trx(std::move(transaction))
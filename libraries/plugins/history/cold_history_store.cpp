@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <graphene/history/cold_history_store.hpp>
+
+#include <fc/io/fstream.hpp>
+#include <fc/io/raw.hpp>
+
+#include <algorithm>
+
+namespace graphene { namespace history {
+
+namespace {
+
+/// one record of index.log, made of fixed-size fields only
+struct index_record
+{
+   uint64_t account = 0;
+   uint32_t sequence = 0;
+   uint16_t op_type = 0;
+   uint64_t operation_id = 0;
+   uint64_t offset = 0;
+};
+
+} // anonymous namespace
+
+} } // graphene::history
+
+FC_REFLECT( graphene::history::index_record, (account)(sequence)(op_type)(operation_id)(offset) )
+
+namespace graphene { namespace history {
+
+cold_history_store::~cold_history_store()
+{
+   close();
+}
+
+void cold_history_store::open( const fc::path& dir )
+{ try {
+   close();
+   fc::create_directories( dir );
+   const fc::path log_path = dir / "operations.log";
+   const fc::path index_path = dir / "index.log";
+
+   _log_size = fc::exists( log_path ) ? fc::file_size( log_path ) : 0;
+   if( fc::exists( index_path ) )
+   {
+      std::string data;
+      fc::read_file_contents( index_path, data );
+      const size_t record_size = fc::raw::pack_size( index_record() );
+      // a record cut by a crash and the records of operations missing from the log are dropped
+      size_t valid = 0;
+      fc::datastream<const char*> ds( data.data(), data.size() - data.size() % record_size );
+      while( ds.remaining() > 0 )
+      {
+         index_record record;
+         fc::raw::unpack( ds, record );
+         if( record.offset >= _log_size )
+            break;
+         entry e;
+         e.sequence = record.sequence;
+         e.op_type = record.op_type;
+         e.operation_id = operation_history_id_type( record.operation_id );
+         e.offset = record.offset;
+         vector<entry>& account_entries = _entries[account_id_type( record.account )];
+         if( account_entries.empty() || account_entries.back().sequence < e.sequence )
+            account_entries.push_back( e );
+         valid += record_size;
+         ++_size;
+      }
+      if( valid != data.size() )
+         fc::resize_file( index_path, valid );
+   }
+
+   _log.open( log_path.generic_string(), std::ofstream::binary | std::ofstream::out | std::ofstream::app );
+   _index.open( index_path.generic_string(), std::ofstream::binary | std::ofstream::out | std::ofstream::app );
+   _reader.open( log_path.generic_string(), std::ifstream::binary | std::ifstream::in );
+   FC_ASSERT( _log && _index && _reader, "Unable to open the cold history store in ${dir}", ("dir", dir) );
+} FC_CAPTURE_AND_RETHROW( (dir) ) }
+
+void cold_history_store::close()
+{
+   if( !is_open() )
+      return;
+   flush();
+   _log.close();
+   _index.close();
+   _reader.close();
+   _entries.clear();
+   _log_size = 0;
+   _size = 0;
+}
+
+void cold_history_store::append( account_id_type account, uint32_t sequence, const operation_history_object& op )
+{
+   vector<entry>& account_entries = _entries[account];
+   if( !account_entries.empty() && account_entries.back().sequence >= sequence )
+      return;
+
+   const vector<char> packed = fc::raw::pack( op );
+   const uint32_t packed_size = packed.size();
+   _log.write( reinterpret_cast<const char*>( &packed_size ), sizeof( packed_size ) );
+   _log.write( packed.data(), packed.size() );
+
+   entry e;
+   e.sequence = sequence;
+   e.op_type = op.op.which();
+   e.operation_id = op.id;
+   e.offset = _log_size;
+
+   index_record record;
+   record.account = account.instance.value;
+   record.sequence = e.sequence;
+   record.op_type = e.op_type;
+   record.operation_id = e.operation_id.instance.value;
+   record.offset = e.offset;
+   const vector<char> packed_record = fc::raw::pack( record );
+   _index.write( packed_record.data(), packed_record.size() );
+
+   _log_size += sizeof( packed_size ) + packed.size();
+   account_entries.push_back( e );
+   ++_size;
+}
+
+bool cold_history_store::flush()
+{
+   // the log goes first, so that the index never refers to operations missing from it
+   _log.flush();
+   _index.flush();
+   return _log && _index;
+}
+
+const vector<cold_history_store::entry>& cold_history_store::entries( account_id_type account )const
+{
+   static const vector<entry> empty;
+   auto itr = _entries.find( account );
+   return itr == _entries.end() ? empty : itr->second;
+}
+
+vector<cold_history_store::entry> cold_history_store::operation_entries()const
+{
+   vector<entry> result;
+   result.reserve( _size );
+   for( const auto& account_entries : _entries )
+      result.insert( result.end(), account_entries.second.begin(), account_entries.second.end() );
+
+   // an operation trimmed from the history of several accounts is stored once for each of them
+   auto by_operation = []( const entry& a, const entry& b ) { return a.operation_id < b.operation_id; };
+   std::sort( result.begin(), result.end(), by_operation );
+   result.erase( std::unique( result.begin(), result.end(), []( const entry& a, const entry& b ) {
+                    return a.operation_id == b.operation_id;
+                 } ), result.end() );
+   return result;
+}
+
+operation_history_object cold_history_store::read( const entry& item )const
+{ try {
+   std::lock_guard<std::mutex> guard( _reader_mutex );
+   _reader.clear();
+   _reader.seekg( item.offset );
+   uint32_t packed_size = 0;
+   _reader.read( reinterpret_cast<char*>( &packed_size ), sizeof( packed_size ) );
+   vector<char> packed( packed_size );
+   _reader.read( packed.data(), packed.size() );
+   FC_ASSERT( _reader, "Unable to read from the cold history store" );
+   return fc::raw::unpack<operation_history_object>( packed );
+} FC_CAPTURE_AND_RETHROW( (item) ) }
+
+} } // graphene::history
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <graphene/history/history_export.hpp>
+
+#include <fc/io/json.hpp>
+#include <fc/io/raw.hpp>
+#include <fc/thread/parallel.hpp>
+
+#include <algorithm>
+
+namespace graphene { namespace history {
+
+namespace {
+
+const size_t batch_size = 20000;
+const size_t chunk_size = 1000;
+
+std::string serialize( const vector<operation_history_object>& ops, size_t first, size_t count,
+                       history_export_format format )
+{
+   std::string result;
+   for( size_t i = first; i < first + count; ++i )
+   {
+      if( format == history_export_format::json )
+      {
+         result += fc::json::to_string( fc::variant( ops[i], GRAPHENE_MAX_NESTED_OBJECTS ) );
+         result += '\n';
+      }
+      else
+      {
+         const vector<char> packed = fc::raw::pack( ops[i] );
+         const uint32_t packed_size = packed.size();
+         result.append( reinterpret_cast<const char*>( &packed_size ), sizeof( packed_size ) );
+         result.append( packed.data(), packed.size() );
+      }
+   }
+   return result;
+}
+
+} // anonymous namespace
+
+uint64_t export_operation_history( const database& db, std::ostream& out, uint32_t first_block, uint32_t last_block,
+                                   history_export_format format, const cold_history_store* cold_store )
+{ try {
+   if( last_block == 0 )
+      last_block = db.head_block_num();
+
+   const auto& hist_idx = db.get_index_type<operation_history_index>().indices();
+   const auto& by_id_idx = hist_idx.get<by_id>();
+
+   // start from the first operation at the time of the first block instead of scanning all older ones
+   auto itr = by_id_idx.begin();
+   if( first_block > 1 )
+   {
+      optional<signed_block> block = db.fetch_block_by_number( first_block );
+      if( block.valid() )
+         itr = hist_idx.project<by_id>( hist_idx.get<by_time>().lower_bound( block->timestamp ) );
+   }
+
+   // The operations trimmed from memory are merged in by id from the cold store. Both are ordered by block as well,
+   // so the first cold operation of the first block is found by reading O(log n) of them.
+   typedef cold_history_store::entry cold_entry;
+   vector<cold_entry> cold_entries;
+   if( cold_store != nullptr )
+      cold_entries = cold_store->operation_entries();
+   auto cold_itr = std::partition_point( cold_entries.begin(), cold_entries.end(), [&]( const cold_entry& e ) {
+      return cold_store->read( e ).block_num < first_block;
+   });
+
+   // the objects of a batch are copied, so that blocks applied while waiting for the workers cannot change them
+   uint64_t exported = 0;
+   bool memory_left = ( itr != by_id_idx.end() );
+   object_id_type next_id = memory_left ? itr->id : object_id_type();
+   bool done = !memory_left && cold_itr == cold_entries.end();
+   size_t previous_size = 0;
+   vector< fc::future<std::string> > previous_chunks;
+   while( !done || !previous_chunks.empty() )
+   {
+      auto batch = std::make_shared< vector<operation_history_object> >();
+      vector< fc::future<std::string> > chunks;
+      if( !done )
+      {
+         batch->reserve( batch_size );
+         itr = memory_left ? by_id_idx.lower_bound( next_id ) : by_id_idx.end();
+         while( batch->size() < batch_size )
+         {
+            // the cold store keeps the operations still referred to by another account in memory as well
+            while( cold_itr != cold_entries.end() && itr != by_id_idx.end()
+                   && cold_itr->operation_id.instance.value == itr->id.instance() )
+               ++cold_itr;
+
+            const bool from_memory = itr != by_id_idx.end()
+               && ( cold_itr == cold_entries.end() || itr->id.instance() < cold_itr->operation_id.instance.value );
+            if( from_memory )
+            {
+               if( itr->block_num > last_block )
+                  break;
+               if( itr->block_num >= first_block )
+                  batch->push_back( *itr );
+               ++itr;
+            }
+            else if( cold_itr != cold_entries.end() )
+            {
+               operation_history_object op = cold_store->read( *cold_itr );
+               if( op.block_num > last_block )
+                  break;
+               batch->push_back( std::move( op ) );
+               ++cold_itr;
+            }
+            else
+               break;
+         }
+         memory_left = ( itr != by_id_idx.end() );
+         if( memory_left )
+            next_id = itr->id;
+         done = ( batch->size() < batch_size );
+
+         for( size_t first = 0; first < batch->size(); first += chunk_size )
+         {
+            const size_t count = std::min( chunk_size, batch->size() - first );
+            chunks.push_back( fc::do_parallel( [batch,first,count,format] () {
+               return serialize( *batch, first, count, format );
+            }) );
+         }
+      }
+
+      for( auto& chunk : previous_chunks )
+      {
+         const std::string data = chunk.wait();
+         out.write( data.data(), data.size() );
+      }
+      FC_ASSERT( out, "Unable to write the exported operations" );
+      exported += previous_size;
+
+      previous_size = batch->size();
+      previous_chunks = std::move( chunks );
+   }
+   out.flush();
+   return exported;
+} FC_CAPTURE_AND_RETHROW( (first_block)(last_block) ) }
+
+} } // graphene::history
@@ -39,6 +39,8 @@
 
 #include <fc/thread/thread.hpp>
 
+#include <boost/filesystem/path.hpp>
+
 namespace graphene { namespace history {
 
 namespace detail
@@ -63,219 +65,364 @@ class history_plugin_impl
 
       history_plugin& _self;
       flat_set<account_id_type> _tracked_accounts;
+
+      /// the number of history entries kept per account, 0 to keep all of them
+      uint64_t _max_ops_per_account = 0;
+      flat_map<account_id_type, uint64_t> _max_ops_per_account_overrides;
+      /// keeps the trimmed entries when it is open
+      cold_history_store _cold_store;
+
+   private:
+      /** collects the accounts and funds whose history the operation @p op belongs to */
+      void get_impacted( const operation_history_object& op, flat_set<account_id_type>& impacted_acc,
+                         flat_set<fund_id_type>& impacted_funds );
+
+      /** removes the oldest history entries of an account beyond its configured limit */
+      void trim_account_history( const account_statistics_object& stats_obj );
+
+      /** trims the accounts whose entries were kept beyond the limit until their blocks became irreversible */
+      void trim_pending_accounts();
+
+      /** writes the entries moved to the cold store to disk, and stops using the store if that fails */
+      void flush_cold_store();
+
+      /** removes a history entry of an account, together with the market address of its transfer if it has one */
+      void remove_account_history( const account_transaction_history_object& entry );
+
+      /** removes the operation if no account or fund history refers to it anymore */
+      void remove_if_unreferenced( const operation_history_object& op );
+
+      /** links @p oho into the history of an account */
+      void add_account_history( account_id_type account_id, const operation_history_object& oho,
+                                const string& address );
+
+      /** links @p oho into the history of a fund */
+      void add_fund_history( fund_id_type fund_id, const operation_history_object& oho );
+
+      /** removes the history entries of the untracked accounts, between HARDFORK_617_TIME and HARDFORK_620_TIME */
+      void clear_untracked_history();
+
+      /// accounts with entries beyond the limit in blocks which were reversible when the account was trimmed
+      flat_set<account_id_type> _pending_trim_accounts;
+
+      // scratch buffers of update_histories(), reused for every operation
+      flat_set<account_id_type> _impacted_acc;
+      flat_set<account_id_type> _linked_acc;
+      flat_set<fund_id_type>    _impacted_funds;
+      vector<authority>         _other_authorities;
 };
 
 history_plugin_impl::~history_plugin_impl() {
    return;
 }
 
-void history_plugin_impl::update_histories(const signed_block& b)
+void history_plugin_impl::get_impacted( const operation_history_object& op, flat_set<account_id_type>& impacted_acc,
+                                        flat_set<fund_id_type>& impacted_funds )
 {
-   graphene::chain::database& db = database();
-   const vector<optional<operation_history_object>>& hist = db.get_applied_operations();
+   vector<authority>& other = _other_authorities;
+   other.clear();
+   operation_get_required_authorities(op.op, impacted_acc, impacted_acc, other);
+
+//   //////// hidden operations
+//   if ( (op.op.which() == operation::tag<blind_transfer2_operation>::value)
+//         || (op.op.which() == operation::tag<cheque_create_operation>::value)
+//         || (op.op.which() == operation::tag<cheque_use_operation>::value)
+//         || (op.op.which() == operation::tag<cheque_undo_operation>::value) ) {
+//      impacted_acc.clear();
+//   }
+
+   if (op.op.which() == operation::tag<account_create_operation>::value) {
+      impacted_acc.insert( op.result.get<object_id_type>() );
+   }
+   else if (op.op.which() == operation::tag<fund_create_operation>::value) {
+      impacted_funds.insert( op.result.get<object_id_type>() );
+   }
+   else {
+      graphene::app::operation_get_impacted_items(op.op, impacted_acc, impacted_funds, &database());
+   }
 
-   for (const optional<operation_history_object>& o_op: hist)
+   for (auto& a: other)
    {
-      // add to the operation history index
-      const auto& oho = db.create<operation_history_object>([&](operation_history_object& h)
+      for (std::pair<account_id_type,weight_type>& item_pair: a.account_auths) {
+         impacted_acc.insert(item_pair.first);
+      }
+   }
+}
+
+void history_plugin_impl::trim_account_history( const account_statistics_object& stats_obj )
+{
+   graphene::chain::database& db = database();
+   // issue_bonuses_old() walks the account histories until HARDFORK_617_TIME
+   if (db.head_block_time() <= HARDFORK_617_TIME)
+      return;
+
+   uint64_t max_ops = _max_ops_per_account;
+   auto override_itr = _max_ops_per_account_overrides.find(stats_obj.owner);
+   if (override_itr != _max_ops_per_account_overrides.end())
+      max_ops = override_itr->second;
+   if (max_ops == 0 || stats_obj.total_ops <= max_ops)
+      return;
+
+   // entries with a sequence up to this one are beyond the limit
+   const uint64_t last_removed = stats_obj.total_ops - max_ops;
+   // The cold store cannot be undone, so it only receives the entries of irreversible blocks. The other ones are
+   // kept in memory until their blocks become irreversible.
+   const uint32_t last_irreversible = db.get_dynamic_global_properties().last_irreversible_block_num;
+   const auto& by_seq_idx = db.get_index_type<account_transaction_history_index>().indices().get<by_seq>();
+   auto itr = by_seq_idx.lower_bound( boost::make_tuple( stats_obj.owner ) );
+   while (itr != by_seq_idx.end() && itr->account == stats_obj.owner && itr->sequence <= last_removed)
+   {
+      const operation_history_object* op = db.find(itr->operation_id);
+      if (op != nullptr && _cold_store.is_open())
       {
-         if (o_op.valid())
+         if (op->block_num > last_irreversible)
          {
-            h.op = (*o_op).op;
-            h.result = (*o_op).result;
-            h.block_num = (*o_op).block_num;
-            h.trx_in_block = (*o_op).trx_in_block;
-            h.op_in_trx = (*o_op).op_in_trx;
-            h.virtual_op = (*o_op).virtual_op;
-            h.block_time = b.timestamp;
+            _pending_trim_accounts.insert(stats_obj.owner);
+            break;
          }
+         _cold_store.append(stats_obj.owner, itr->sequence, *op);
+      }
+      const account_transaction_history_object& oldest = *itr++;
+      remove_account_history(oldest);
+      if (op != nullptr)
+         remove_if_unreferenced(*op);
+   }
+
+   // the oldest remaining entry ends the linked list of the account
+   if (itr != by_seq_idx.end() && itr->account == stats_obj.owner && itr->next != account_transaction_history_id_type())
+   {
+      db.modify(*itr, [&](account_transaction_history_object& obj) {
+         obj.next = account_transaction_history_id_type();
       });
+   }
+}
 
-      if (!o_op.valid())
+void history_plugin_impl::trim_pending_accounts()
+{
+   graphene::chain::database& db = database();
+   const flat_set<account_id_type> accounts = std::move(_pending_trim_accounts);
+   _pending_trim_accounts.clear();
+   for (const account_id_type& account_id: accounts)
+      trim_account_history(account_id(db).statistics(db));
+}
+
+void history_plugin_impl::flush_cold_store()
+{
+   if (!_cold_store.is_open())
+      return;
+   if (!_cold_store.flush())
+   {
+      // a failing disk must not make the node reject blocks, the trimmed entries are dropped from now on
+      elog( "Unable to write to the cold history store, trimmed account history is no longer kept" );
+      _cold_store.close();
+   }
+}
+
+void history_plugin_impl::remove_account_history( const account_transaction_history_object& entry )
+{
+   graphene::chain::database& db = database();
+   const auto& by_seq_idx = db.get_index_type<account_address_history_index>().indices().get<by_seq>();
+   auto itr = by_seq_idx.find( boost::make_tuple( entry.account, entry.sequence ) );
+   if (itr != by_seq_idx.end())
+      db.remove(*itr);
+   db.remove(entry);
+}
+
+void history_plugin_impl::remove_if_unreferenced( const operation_history_object& op )
+{
+   graphene::chain::database& db = database();
+   const auto& acc_idx = dynamic_cast<const primary_index<account_transaction_history_index>&>(
+      db.get_index_type<account_transaction_history_index>() );
+   const auto& fund_idx = dynamic_cast<const primary_index<fund_transaction_history_index>&>(
+      db.get_index_type<fund_transaction_history_index>() );
+
+   if (acc_idx.get_secondary_index<operation_reference_index<account_transaction_history_object>>().is_referenced(op.id))
+      return;
+   if (fund_idx.get_secondary_index<operation_reference_index<fund_transaction_history_object>>().is_referenced(op.id))
+      return;
+   db.remove(op);
+}
+
+/// Returns the market address a transfer was sent to, or an empty string for other operations
+static string transfer_address( const operation& op )
+{
+   if( op.which() != operation::tag<transfer_operation>::value )
+      return string();
+   for( const auto& ext : op.get<transfer_operation>().extensions )
+      if( ext.which() == asset_ext_type::value_type::tag<string>::value )
+         return ext.get<string>();
+   return string();
+}
+
+void history_plugin_impl::add_account_history( account_id_type account_id, const operation_history_object& oho,
+                                               const string& address )
+{
+   graphene::chain::database& db = database();
+   // we don't do index_account_keys here anymore, because
+   // that indexing now happens in observers' post_evaluate()
+   const auto& stats_obj = account_id(db).statistics(db);
+   const auto& ath = db.create<account_transaction_history_object>([&]( account_transaction_history_object& obj)
+   {
+      obj.operation_id = oho.id;
+      obj.account      = account_id;
+      obj.sequence     = stats_obj.total_ops+1;
+      obj.next         = stats_obj.most_recent_op;
+      obj.block_time   = oho.block_time;
+      obj.op_type      = oho.op.which();
+   });
+   if (!address.empty())
+   {
+      db.create<account_address_history_object>([&]( account_address_history_object& obj)
       {
-         ilog( "removing failed operation with ID: ${id}", ("id", oho.id) );
-         db.remove( oho );
+         obj.account      = account_id;
+         obj.address      = address;
+         obj.sequence     = ath.sequence;
+         obj.operation_id = oho.id;
+      });
+   }
+   db.modify(stats_obj, [&]( account_statistics_object& obj)
+   {
+      obj.most_recent_op = ath.id;
+      obj.total_ops = ath.sequence;
+   });
+   trim_account_history(stats_obj);
+}
+
+void history_plugin_impl::add_fund_history( fund_id_type fund_id, const operation_history_object& oho )
+{
+   graphene::chain::database& db = database();
+   const auto& stats_obj = fund_id(db).statistics_id(db);
+   const auto& ath = db.create<fund_transaction_history_object>([&](fund_transaction_history_object& obj)
+   {
+      obj.operation_id = oho.id;
+      obj.fund         = fund_id;
+      obj.sequence     = stats_obj.total_ops+1;
+      obj.next         = stats_obj.most_recent_op;
+      obj.block_time   = oho.block_time;
+   });
+   db.modify(stats_obj, [&](fund_statistics_object& obj)
+   {
+      obj.most_recent_op = ath.id;
+      obj.total_ops = ath.sequence;
+   });
+}
+
+void history_plugin_impl::clear_untracked_history()
+{
+   graphene::chain::database& db = database();
+   const auto& by_time_idx = db.get_index_type<account_transaction_history_index>().indices().get<by_time>();
+   const auto& op_idx = db.get_index_type<operation_history_index>().indices().get<by_id>();
+   auto history_index = by_time_idx.lower_bound(db.head_block_time());
+   auto begin_iter = by_time_idx.begin();
+   while (begin_iter != history_index)
+   {
+      const account_transaction_history_object& entry = *begin_iter++;
+      /**
+       * we cant' erase old operation_history_object if it
+       * belongs to our tracked_accounts
+       */
+      if (_tracked_accounts.find(entry.account) != _tracked_accounts.end())
          continue;
+
+      auto idx = op_idx.find(entry.operation_id);
+      if (idx != op_idx.end())
+      {
+         flat_set<account_id_type> impacted_acc_tmp;
+         flat_set<fund_id_type> impacted_funds_tmp;
+         get_impacted(*idx, impacted_acc_tmp, impacted_funds_tmp);
+
+         bool can_erase_obj = true;
+         for (const account_id_type& item_id: impacted_acc_tmp)
+         {
+            if (_tracked_accounts.find(item_id) != _tracked_accounts.end())
+            {
+               can_erase_obj = false;
+               break;
+            }
+         }
+         if (can_erase_obj) {
+            db.remove(*idx);
+         }
       }
+      remove_account_history(entry);
+   }
+}
 
+void history_plugin_impl::update_histories(const signed_block& b)
+{
+   graphene::chain::database& db = database();
+   const vector<optional<operation_history_object>>& hist = db.get_applied_operations();
+
+   // the history of every impacted account is kept until HARDFORK_617_TIME, even if only some accounts are tracked
+   const bool track_all = _tracked_accounts.empty() || (db.head_block_time() <= HARDFORK_617_TIME);
+   // operations no tracked account refers to are kept until HARDFORK_620_TIME
+   const bool keep_untracked = track_all || (db.head_block_time() <= HARDFORK_620_TIME);
+
+   for (const optional<operation_history_object>& o_op: hist)
+   {
+      // failed operations are not stored, but still use up an id so the ids of the stored ones do not change
+      if (!o_op.valid())
+      {
+         db.skip_next_id<operation_history_object>();
+         continue;
+      }
       const operation_history_object& op = *o_op;
 
       // get the set of accounts this operation applies to
-      flat_set<account_id_type> impacted_acc;
-      flat_set<fund_id_type> impacted_funds;
-
-      vector<authority> other;
-      operation_get_required_authorities(op.op, impacted_acc, impacted_acc, other);
-
-//      //////// hidden operations
-//      if ( (op.op.which() == operation::tag<blind_transfer2_operation>::value)
-//            || (op.op.which() == operation::tag<cheque_create_operation>::value)
-//            || (op.op.which() == operation::tag<cheque_use_operation>::value)
-//            || (op.op.which() == operation::tag<cheque_undo_operation>::value) ) {
-//         impacted_acc.clear();
-//      }
-
-      if (op.op.which() == operation::tag<account_create_operation>::value) {
-         impacted_acc.insert( oho.result.get<object_id_type>() );
-      }
-      else if (op.op.which() == operation::tag<fund_create_operation>::value) {
-         impacted_funds.insert( oho.result.get<object_id_type>() );
-      }
-      else {
-         graphene::app::operation_get_impacted_items(op.op, impacted_acc, impacted_funds, &db);
-      }
+      _impacted_acc.clear();
+      _impacted_funds.clear();
+      get_impacted(op, _impacted_acc, _impacted_funds);
 
-      for (auto& a: other)
+      // the accounts whose history the operation is linked into
+      const flat_set<account_id_type>* linked_acc = &_impacted_acc;
+      if (!track_all)
       {
-         for (std::pair<account_id_type,weight_type>& item_pair: a.account_auths) {
-            impacted_acc.insert(item_pair.first);
-         }
+         _linked_acc.clear();
+         std::set_intersection(_impacted_acc.begin(), _impacted_acc.end(),
+                               _tracked_accounts.begin(), _tracked_accounts.end(),
+                               std::inserter(_linked_acc, _linked_acc.end()));
+         linked_acc = &_linked_acc;
       }
 
-      // for each operation this account applies to that is in the config link it into the history
-      if ( (_tracked_accounts.size() == 0)
-           || ((_tracked_accounts.size() > 0) && (db.head_block_time() <= HARDFORK_617_TIME)) )
+      if (linked_acc->empty() && !keep_untracked)
       {
-         for (auto& account_id: impacted_acc)
-         {
-            // we don't do index_account_keys here anymore, because
-            // that indexing now happens in observers' post_evaluate()
-
-            // add history
-            const auto& stats_obj = account_id(db).statistics(db);
-            const auto& ath = db.create<account_transaction_history_object>([&]( account_transaction_history_object& obj)
-            {
-               obj.operation_id = oho.id;
-               obj.account      = account_id;
-               obj.sequence     = stats_obj.total_ops+1;
-               obj.next         = stats_obj.most_recent_op;
-               obj.block_time   = b.timestamp;
-            });
-            db.modify(stats_obj, [&]( account_statistics_object& obj)
-            {
-               obj.most_recent_op = ath.id;
-               obj.total_ops = ath.sequence;
-            });
-         }
+         // nobody would refer to the operation, so it is not stored at all
+         db.skip_next_id<operation_history_object>();
+         continue;
       }
-      // _tracked_accounts.size() > 0
-      else
+
+      // add to the operation history index
+      const auto& oho = db.create<operation_history_object>([&](operation_history_object& h)
       {
-         bool acc_found = false;
-         for (auto account_id: _tracked_accounts)
-         {
-            if (impacted_acc.find(account_id) != impacted_acc.end())
-            {
-               acc_found = true;
-
-               // add history
-               const auto& stats_obj = account_id(db).statistics(db);
-               const auto& ath = db.create<account_transaction_history_object>([&](account_transaction_history_object& obj)
-                  {
-                     obj.operation_id = oho.id;
-                     obj.account      = account_id;
-                     obj.sequence     = stats_obj.total_ops+1;
-                     obj.next         = stats_obj.most_recent_op;
-                     obj.block_time   = b.timestamp;
-                  });
-               db.modify( stats_obj, [&]( account_statistics_object& obj)
-               {
-                  obj.most_recent_op = ath.id;
-                  obj.total_ops = ath.sequence;
-               });
-            }
-         }
-         if (!acc_found && (db.head_block_time() > HARDFORK_620_TIME))
-         {
-            // removing of unnecessary operation_history_object
-            db.remove(oho);
-         }
+         h.op = op.op;
+         h.result = op.result;
+         h.block_num = op.block_num;
+         h.trx_in_block = op.trx_in_block;
+         h.op_in_trx = op.op_in_trx;
+         h.virtual_op = op.virtual_op;
+         h.block_time = b.timestamp;
+      });
 
-         // now we can clear old unusable data
-         if ( (db.head_block_time() >= HARDFORK_617_TIME) && (db.head_block_time() <= HARDFORK_620_TIME) )
-         {
-            auto history_index = db.get_index_type<account_transaction_history_index>().indices().get<by_time>().lower_bound(db.head_block_time());
-            auto begin_iter = db.get_index_type<account_transaction_history_index>().indices().get<by_time>().begin();
-            while (begin_iter != history_index)
-            {
-               /**
-                * we cant' erase old operation_history_object if it
-                * belongs to our tracked_accounts
-                */
-               if (_tracked_accounts.find(begin_iter->account) == _tracked_accounts.end())
-               {
-                  bool can_erase_obj = true;
-                  auto idx = db.get_index_type<operation_history_index>().indices().get<by_id>().find(begin_iter->operation_id);
-                  if (idx != db.get_index_type<operation_history_index>().indices().get<by_id>().end())
-                  {
-                     const operation_history_object& obj = *idx;
-
-                     flat_set<account_id_type> impacted_acc_tmp;
-                     flat_set<fund_id_type> impacted_funds_tmp;
-
-                     vector<authority> other_tmp;
-                     operation_get_required_authorities(obj.op, impacted_acc_tmp, impacted_acc_tmp, other_tmp);
-
-                     if (obj.op.which() == operation::tag<account_create_operation>::value) {
-                        impacted_acc_tmp.insert(obj.result.get<object_id_type>());
-                     }
-                     else {
-                        graphene::app::operation_get_impacted_items(obj.op, impacted_acc_tmp, impacted_funds_tmp, &db);
-                     }
-
-                     for (auto& a: other_tmp)
-                     {
-                        for (std::pair<account_id_type,weight_type>& item_pair: a.account_auths) {
-                           impacted_acc_tmp.insert(item_pair.first);
-                        }
-                     }
-
-                     for (const account_id_type& item_id: impacted_acc_tmp)
-                     {
-                        if (_tracked_accounts.find(item_id) != _tracked_accounts.end())
-                        {
-                           can_erase_obj = false;
-                           break;
-                        }
-                     }
-                  }
-                  else {
-                     can_erase_obj = false;
-                  }
-
-                  if (can_erase_obj) {
-                     db.remove(*idx);
-                  }
-                  db.remove(*begin_iter);
-               }
-               ++begin_iter;
-            }
-         }
-      }
+      const string address = transfer_address( op.op );
+      for (const account_id_type& account_id: *linked_acc)
+         add_account_history(account_id, oho, address);
+
+      // now we can clear old unusable data
+      if ( !track_all && (db.head_block_time() >= HARDFORK_617_TIME) && (db.head_block_time() <= HARDFORK_620_TIME) )
+         clear_untracked_history();
 
       /******** funds ********/
 
       if (_tracked_accounts.size() == 0)
       {
-         for (const fund_id_type& fund_id: impacted_funds)
-         {
-            const auto& stats_obj = fund_id(db).statistics_id(db);
-            const auto& ath = db.create<fund_transaction_history_object>([&](fund_transaction_history_object& obj)
-             {
-                obj.operation_id = oho.id;
-                obj.fund         = fund_id;
-                obj.sequence     = stats_obj.total_ops+1;
-                obj.next         = stats_obj.most_recent_op;
-                obj.block_time   = b.timestamp;
-             });
-            db.modify(stats_obj, [&](fund_statistics_object& obj)
-            {
-               obj.most_recent_op = ath.id;
-               obj.total_ops = ath.sequence;
-            });
-         }
+         for (const fund_id_type& fund_id: _impacted_funds)
+            add_fund_history(fund_id, oho);
       }
    }
+
+   if (_cold_store.is_open())
+      trim_pending_accounts();
+   flush_cold_store();
 }
 } // end namespace detail
 
@@ -294,6 +441,11 @@ void history_plugin::plugin_set_program_options(
 {
    cli.add_options()
          ("track-account", boost::program_options::value<std::vector<std::string>>()->composing()->multitoken(), "Account ID to track history for (may specify multiple times)")
+         ("max-ops-per-account", boost::program_options::value<uint64_t>(), "Maximum number of operations per account kept in the history, 0 to keep all of them (default: 0)")
+         ("max-ops-per-account-override", boost::program_options::value<std::vector<std::string>>()->composing()->multitoken(),
+          "Maximum number of operations kept for one account, as a pair [\"account ID\", count] (may specify multiple times)")
+         ("cold-history-dir", boost::program_options::value<boost::filesystem::path>(),
+          "Directory of an on-disk store keeping the operations beyond max-ops-per-account, which are dropped otherwise")
          ;
    cfg.add(cli);
 }
@@ -303,10 +455,21 @@ void history_plugin::plugin_initialize(const boost::program_options::variables_m
    database().applied_block.connect( [&]( const signed_block& b){ my->update_histories(b); } );
 
    database().add_index<primary_index<operation_history_index>>();
-   database().add_index<primary_index<account_transaction_history_index>>();
-   database().add_index<primary_index<fund_transaction_history_index>>();
+   database().add_index<primary_index<account_transaction_history_index>>()
+      ->add_secondary_index<operation_reference_index<account_transaction_history_object>>();
+   database().add_index<primary_index<account_address_history_index>>();
+   database().add_index<primary_index<fund_transaction_history_index>>()
+      ->add_secondary_index<operation_reference_index<fund_transaction_history_object>>();
 
    LOAD_VALUE_SET(options, "track-account", my->_tracked_accounts, graphene::chain::account_id_type);
+   if (options.count("max-ops-per-account")) {
+      my->_max_ops_per_account = options["max-ops-per-account"].as<uint64_t>();
+   }
+   typedef std::pair<graphene::chain::account_id_type, uint64_t> max_ops_override;
+   LOAD_VALUE_SET(options, "max-ops-per-account-override", my->_max_ops_per_account_overrides, max_ops_override);
+   if (options.count("cold-history-dir")) {
+      open_cold_store(options["cold-history-dir"].as<boost::filesystem::path>());
+   }
 }
 
 void history_plugin::plugin_startup() { }
@@ -315,4 +478,20 @@ flat_set<account_id_type> history_plugin::tracked_accounts() const {
    return my->_tracked_accounts;
 }
 
+void history_plugin::set_max_ops_per_account( uint64_t max_ops, const flat_map<account_id_type, uint64_t>& overrides )
+{
+   my->_max_ops_per_account = max_ops;
+   my->_max_ops_per_account_overrides = overrides;
+}
+
+void history_plugin::open_cold_store( const fc::path& dir )
+{
+   my->_cold_store.open(dir);
+   ilog( "Keeping trimmed account history in ${dir}, ${n} entries stored", ("dir", dir)("n", my->_cold_store.size()) );
+}
+
+const cold_history_store* history_plugin::cold_store() const {
+   return my->_cold_store.is_open() ? &my->_cold_store : nullptr;
+}
+
 } }
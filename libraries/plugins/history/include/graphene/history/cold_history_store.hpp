@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <graphene/db/generic_index.hpp>
+#include <graphene/chain/operation_history_object.hpp>
+#include <graphene/app/cold_history.hpp>
+
+#include <fc/filesystem.hpp>
+
+#include <fstream>
+#include <mutex>
+
+namespace graphene { namespace history {
+   using namespace chain;
+
+/**
+ * @brief Append-only on-disk store for the old history entries of accounts
+ *
+ * The history plugin moves the entries it trims from memory here. Each entry is appended to operations.log as
+ * its packed operation_history_object prefixed with the size, and to index.log as a fixed-size
+ * (account, sequence) -> offset record. The index is loaded into memory when the store is opened, at a small
+ * fraction of the size of the objects it replaces.
+ *
+ * Entries are never removed, so only entries of irreversible blocks may be appended. An entry of an account which
+ * is not newer than the last stored one of that account, such as an entry trimmed again after the block trimming
+ * it was popped and applied again, is ignored.
+ */
+class cold_history_store : public graphene::app::cold_history_reader
+{
+   public:
+      typedef graphene::app::cold_history_entry entry;
+
+      ~cold_history_store();
+
+      void open( const fc::path& dir );
+      void close();
+      bool is_open()const { return _log.is_open(); }
+
+      /** stores @p op as the entry @p sequence of the history of @p account */
+      void append( account_id_type account, uint32_t sequence, const operation_history_object& op );
+
+      /**
+       * writes the appended entries to disk, making them visible to read()
+       * @return false if writing failed
+       */
+      bool flush();
+
+      /** @return the stored entries of @p account ordered by sequence */
+      const vector<entry>& entries( account_id_type account )const override;
+
+      /** @return the operation of @p item */
+      operation_history_object read( const entry& item )const override;
+
+      /** @return one entry of each stored operation, ordered by operation id */
+      vector<entry> operation_entries()const;
+
+      uint64_t size()const { return _size; }
+
+   private:
+      std::ofstream _log;
+      std::ofstream _index;
+      mutable std::ifstream _reader;
+      mutable std::mutex _reader_mutex;
+
+      uint64_t _log_size = 0;
+      uint64_t _size = 0;
+      map< account_id_type, vector<entry> > _entries;
+};
+
+} } // graphene::history
+
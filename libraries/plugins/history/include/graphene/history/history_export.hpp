@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/operation_history_object.hpp>
+#include <graphene/history/cold_history_store.hpp>
+
+#include <ostream>
+
+namespace graphene { namespace history {
+   using namespace chain;
+
+enum class history_export_format
+{
+   json,   ///< one JSON object per line
+   binary  ///< each packed object prefixed with its size as a 32-bit integer
+};
+
+/**
+ * Writes the operation_history_objects of the blocks @p first_block to @p last_block (the head block if 0) to
+ * @p out in one pass over the operation history index, oldest first. The objects are serialized in batches by the
+ * fc worker threads while the previous batch is written, so a whole chain is exported at the speed of the output.
+ * The operations the history plugin trimmed from memory are read from @p cold_store, if given, and merged in by id;
+ * without it they are missing from the export.
+ *
+ * @return the number of exported operations
+ */
+uint64_t export_operation_history( const database& db, std::ostream& out, uint32_t first_block, uint32_t last_block,
+                                   history_export_format format, const cold_history_store* cold_store = nullptr );
+
+} } // graphene::history
@@ -27,9 +27,12 @@
 #include <graphene/chain/database.hpp>
 
 #include <graphene/chain/operation_history_object.hpp>
+#include <graphene/history/cold_history_store.hpp>
 
 #include <fc/thread/future.hpp>
 
+#include <unordered_map>
+
 namespace graphene { namespace history {
    using namespace chain;
    //using namespace graphene::db;
@@ -56,12 +59,43 @@ enum account_history_object_type
    bucket_object_type = 1 ///< used in market_history_plugin
 };
 
+/**
+ * @brief Counts the history entries of type @p HistoryObject that refer to each operation
+ *
+ * The count follows the entries as they are linked and removed, so whether an operation is still referenced
+ * does not depend on what the operation impacts in the current state.
+ */
+template<typename HistoryObject>
+class operation_reference_index : public secondary_index
+{
+   public:
+      virtual void object_inserted( const object& obj ) override
+      {
+         ++_references[ static_cast<const HistoryObject&>( obj ).operation_id.instance.value ];
+      }
+
+      virtual void object_removed( const object& obj ) override
+      {
+         auto itr = _references.find( static_cast<const HistoryObject&>( obj ).operation_id.instance.value );
+         if( itr != _references.end() && --itr->second == 0 )
+            _references.erase( itr );
+      }
+
+      bool is_referenced( operation_history_id_type op )const
+      {
+         return _references.find( op.instance.value ) != _references.end();
+      }
+
+   private:
+      std::unordered_map<uint64_t, uint32_t> _references;
+};
+
 namespace detail
 {
    class history_plugin_impl;
 }
 
-class history_plugin : public graphene::app::plugin
+class history_plugin : public graphene::app::plugin, public graphene::app::cold_history_provider
 {
    public:
       history_plugin();
@@ -76,6 +110,22 @@ class history_plugin : public graphene::app::plugin
 
       flat_set<account_id_type> tracked_accounts()const;
 
+      /**
+       * Limits the number of history entries kept per account, 0 to keep all of them. The oldest entries of an
+       * account are removed as new ones are added, and so are their operations once no history refers to them.
+       */
+      void set_max_ops_per_account( uint64_t max_ops, const flat_map<account_id_type, uint64_t>& overrides = {} );
+
+      /**
+       * Moves the entries trimmed from the history of an account to a cold store in @p dir instead of dropping
+       * them.
+       */
+      void open_cold_store( const fc::path& dir );
+
+      /** @return the store of the entries trimmed from memory, or nullptr if they are dropped */
+      const cold_history_store* cold_store()const;
+      const graphene::app::cold_history_reader* cold_history()const override { return cold_store(); }
+
       friend class detail::history_plugin_impl;
       std::unique_ptr<detail::history_plugin_impl> my;
 };
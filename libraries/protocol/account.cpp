@@ -297,6 +297,15 @@ void create_market_address_operation::validate() const
    FC_ASSERT( notes.length() <= 50 );
 }
 
+void update_online_time_operation::validate() const
+{
+   FC_ASSERT( fee.amount >= 0 );
+   FC_ASSERT( !online_info.empty() || !removed.empty(), "Nothing to update" );
+   for( const auto& id : removed )
+      FC_ASSERT( online_info.find( id ) == online_info.end(),
+                 "Account ${a} is both updated and removed", ("a", id) );
+}
+
 } } // graphene::protocol
 
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::account_options )
@@ -322,6 +331,7 @@ GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::create_market_add
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::account_edc_limit_daily_volume_operation::fee_parameters_type )
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::update_accounts_referrer_operation::fee_parameters_type )
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::enable_account_referral_payments_operation::fee_parameters_type )
+GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::update_online_time_operation::fee_parameters_type )
 
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::account_create_operation )
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::account_update_operation )
@@ -342,4 +352,5 @@ GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::set_market_operat
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::create_market_address_operation )
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::account_edc_limit_daily_volume_operation )
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::update_accounts_referrer_operation )
-GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::enable_account_referral_payments_operation )
\ No newline at end of file
+GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::enable_account_referral_payments_operation )
+GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::update_online_time_operation )
\ No newline at end of file
@@ -512,6 +512,25 @@ namespace graphene { namespace protocol {
       void            validate() const { };
    };
 
+   /**
+    * @brief Changes online minutes of some accounts, unlike set_online_time_operation which replaces them all
+    */
+   struct update_online_time_operation: public base_operation
+   {
+      struct fee_parameters_type { uint64_t fee = 0; };
+
+      asset fee;
+
+      /// new online minutes of the accounts whose minutes changed
+      map<account_id_type, uint16_t> online_info;
+      /// accounts whose online minutes are no longer reported
+      flat_set<account_id_type> removed;
+
+      extensions_type extensions;
+      account_id_type fee_payer() const { return ALPHA_ACCOUNT_ID; }
+      void            validate() const;
+   };
+
 } } // graphene::protocol
 
 FC_REFLECT_ENUM( graphene::protocol::account_whitelist_operation::account_listing,
@@ -551,6 +570,7 @@ FC_REFLECT( graphene::protocol::create_market_address_operation::fee_parameters_
 FC_REFLECT( graphene::protocol::account_edc_limit_daily_volume_operation::fee_parameters_type, (fee) )
 FC_REFLECT( graphene::protocol::update_accounts_referrer_operation::fee_parameters_type, (fee) )
 FC_REFLECT( graphene::protocol::enable_account_referral_payments_operation::fee_parameters_type, (fee) )
+FC_REFLECT( graphene::protocol::update_online_time_operation::fee_parameters_type, (fee) )
 
 FC_REFLECT( graphene::protocol::account_create_operation,
             (fee)(registrar)
@@ -578,6 +598,7 @@ FC_REFLECT( graphene::protocol::create_market_address_operation, (fee)(market_ac
 FC_REFLECT( graphene::protocol::account_edc_limit_daily_volume_operation, (fee)(account_id)(limit_transfers_enabled)(extensions) )
 FC_REFLECT( graphene::protocol::update_accounts_referrer_operation, (fee)(accounts)(new_referrer)(extensions) )
 FC_REFLECT( graphene::protocol::enable_account_referral_payments_operation, (fee)(account_id)(enabled)(extensions) )
+FC_REFLECT( graphene::protocol::update_online_time_operation, (fee)(online_info)(removed)(extensions) )
 
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::account_options )
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::limit_daily_ext_info )
@@ -602,6 +623,7 @@ GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::create_market_addre
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::account_edc_limit_daily_volume_operation::fee_parameters_type )
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::update_accounts_referrer_operation::fee_parameters_type )
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::enable_account_referral_payments_operation::fee_parameters_type )
+GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::update_online_time_operation::fee_parameters_type )
 
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::account_create_operation )
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::account_update_operation )
@@ -622,4 +644,5 @@ GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::set_market_operatio
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::create_market_address_operation )
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::account_edc_limit_daily_volume_operation )
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::update_accounts_referrer_operation )
-GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::enable_account_referral_payments_operation )
\ No newline at end of file
+GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::enable_account_referral_payments_operation )
+GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::update_online_time_operation )
\ No newline at end of file
@@ -35,6 +35,7 @@
 #define GRAPHENE_MAX_SHARE_SUPPLY int64_t(999999999999999000)
 #define GRAPHENE_MAX_PAY_RATE 10000 /* 100% */
 #define GRAPHENE_MAX_SIG_CHECK_DEPTH 2
+#define GRAPHENE_DEFAULT_SIGNATURE_CACHE_SIZE 50000 ///< number of recovered signature keys kept in memory
 /**
  * Don't allow the committee_members to publish a limit that would
  * make the network unable to operate.
@@ -145,7 +145,8 @@ namespace graphene { namespace protocol {
             set_witness_exception_operation,
             update_referral_settings_operation,
             update_accounts_referrer_operation,    // [idx: 88]
-            enable_account_referral_payments_operation
+            enable_account_referral_payments_operation,
+            update_online_time_operation           // [idx: 90]
          > operation;
 
    /// @} // operations group
@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#pragma once
+#include <graphene/protocol/types.hpp>
+
+#include <fc/thread/spin_yield_lock.hpp>
+
+#include <boost/multi_index_container.hpp>
+#include <boost/multi_index/hashed_index.hpp>
+#include <boost/multi_index/member.hpp>
+#include <boost/multi_index/sequenced_index.hpp>
+
+namespace graphene { namespace protocol {
+
+   /**
+    *  @brief LRU cache of public keys recovered from transaction signatures
+    *
+    *  A transaction is signature-checked when it is pushed, again each time the pending
+    *  transactions are re-applied after a block, and once more when a witness includes it.
+    *  Recovering a public key is by far the most expensive part of these checks, so
+    *  signed_transaction::get_signature_keys() consults this cache before doing it.
+    *
+    *  Entries are keyed by the signature digest (which commits to the chain id and the whole
+    *  transaction) and the signature itself. The cache is shared by all threads of the process.
+    */
+   class signature_cache
+   {
+      public:
+         struct cache_stats
+         {
+            uint64_t hits     = 0;
+            uint64_t misses   = 0;
+            uint64_t size     = 0;
+            uint64_t capacity = 0;
+         };
+
+         static signature_cache& instance();
+
+         /// @return the key which produced @ref sig for @ref digest, recovering it on a cache miss
+         public_key_type recover( const signature_type& sig, const digest_type& digest );
+
+         /// Sets the maximum number of cached keys, 0 disables the cache
+         void        set_capacity( size_t capacity );
+         cache_stats get_stats()const;
+         void        reset_stats();
+         void        clear();
+
+      private:
+         struct entry
+         {
+            digest_type     digest;
+            signature_type  signature;
+            public_key_type key;
+         };
+
+         struct entry_hash
+         {
+            size_t operator()( const std::pair<digest_type,signature_type>& k )const
+            {
+               // both the digest and the r value of the signature are uniformly distributed
+               uint64_t r;
+               memcpy( &r, k.second.data() + 1, sizeof(r) );
+               return size_t( k.first._hash[0].value() ^ r );
+            }
+         };
+
+         struct entry_key
+         {
+            typedef std::pair<digest_type,signature_type> result_type;
+            result_type operator()( const entry& e )const { return result_type( e.digest, e.signature ); }
+         };
+
+         typedef boost::multi_index_container<
+            entry,
+            boost::multi_index::indexed_by<
+               boost::multi_index::sequenced<>,
+               boost::multi_index::hashed_unique< entry_key, entry_hash >
+            >
+         > entry_index;
+
+         mutable fc::spin_yield_lock _lock;
+         entry_index                 _entries;
+         size_t                      _capacity = GRAPHENE_DEFAULT_SIGNATURE_CACHE_SIZE;
+         uint64_t                    _hits     = 0;
+         uint64_t                    _misses   = 0;
+   };
+
+} } // graphene::protocol
+
+FC_REFLECT( graphene::protocol::signature_cache::cache_stats, (hits)(misses)(size)(capacity) )
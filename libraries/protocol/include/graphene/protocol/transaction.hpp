@@ -64,6 +64,14 @@ namespace graphene { namespace protocol {
     */
    struct transaction
    {
+      transaction() = default;
+      transaction( const transaction& ) = default;
+      transaction( transaction&& ) = default;
+      virtual ~transaction() = default;
+
+      transaction& operator=( const transaction& ) = default;
+      transaction& operator=( transaction&& ) = default;
+
       /**
        * Least significant 16 bits from the reference block number. If @ref relative_expiration is zero, this field
        * must be zero as well.
@@ -85,11 +93,11 @@ namespace graphene { namespace protocol {
       extensions_type    extensions;
 
       /// Calculate the digest for a transaction
-      digest_type         digest()const;
+      virtual digest_type digest()const;
       transaction_id_type id()const;
       void                validate() const;
       /// Calculate the digest used for signature validation
-      digest_type         sig_digest( const chain_id_type& chain_id )const;
+      virtual digest_type sig_digest( const chain_id_type& chain_id )const;
 
       void set_expiration( fc::time_point_sec expiration_time );
       void set_reference_block( const block_id_type& reference_block );
@@ -165,7 +173,7 @@ namespace graphene { namespace protocol {
          uint32_t max_recursion = GRAPHENE_MAX_SIG_CHECK_DEPTH
          ) const;
 
-      flat_set<public_key_type> get_signature_keys( const chain_id_type& chain_id )const;
+      virtual flat_set<public_key_type> get_signature_keys( const chain_id_type& chain_id )const;
 
       vector<signature_type> signatures;
 
@@ -181,6 +189,81 @@ namespace graphene { namespace protocol {
                           const flat_set<account_id_type>& active_aprovals = flat_set<account_id_type>(),
                           const flat_set<account_id_type>& owner_approvals = flat_set<account_id_type>());
 
+   /**
+    *  @brief a signed transaction which caches its serialization, digests and signature keys
+    *
+    *  Transactions received from the network (and the ones contained in blocks) are never
+    *  modified after they have been received, so each of them only needs to be packed and
+    *  hashed once. The results may be computed in advance on a worker thread, see
+    *  database::precompute_parallel().
+    *
+    *  The cached values are only taken over from another precomputable_transaction, a
+    *  plain signed_transaction always starts with an empty cache.
+    *
+    *  The cache is dropped when a field is replaced, or an element is added to or removed
+    *  from one of the vectors, e.g. by sign() or clear(). The non-const visit() drops it as
+    *  well. Call invalidate_cache() after changing an element of a vector in place.
+    */
+   struct precomputable_transaction : public signed_transaction
+   {
+      precomputable_transaction() {}
+      precomputable_transaction( const signed_transaction& trx );
+      precomputable_transaction( signed_transaction&& trx );
+
+      digest_type               digest()const override;
+      digest_type               sig_digest( const chain_id_type& chain_id )const override;
+      flat_set<public_key_type> get_signature_keys( const chain_id_type& chain_id )const override;
+
+      /// @return the packed transaction, without signatures
+      const vector<char>&       packed_transaction()const;
+
+      /// drops all cached values
+      void                      invalidate_cache() { drop_cache(); }
+
+      /// visit all operations, which may modify them
+      template<typename Visitor>
+      vector<typename Visitor::result_type> visit( Visitor&& visitor )
+      {
+         invalidate_cache();
+         return signed_transaction::visit( std::forward<Visitor>( visitor ) );
+      }
+      template<typename Visitor>
+      vector<typename Visitor::result_type> visit( Visitor&& visitor )const
+      {
+         return signed_transaction::visit( std::forward<Visitor>( visitor ) );
+      }
+
+   protected:
+      /// the fields of the transaction which are compared with the cached ones before a cached value is used
+      struct cache_key
+      {
+         uint16_t           ref_block_num    = 0;
+         uint32_t           ref_block_prefix = 0;
+         fc::time_point_sec expiration;
+         size_t             operations       = 0;
+         size_t             extensions       = 0;
+         size_t             signatures       = 0;
+
+         bool operator==( const cache_key& other )const;
+      };
+      cache_key current_cache_key()const;
+
+      /// drops the cached values if the transaction has been modified since they were computed
+      void check_cache()const;
+      virtual void drop_cache()const;
+
+      mutable optional<vector<char>>                         _packed_trx;
+      mutable optional<digest_type>                          _digest;
+      mutable optional<std::pair<chain_id_type,digest_type>> _sig_digest;
+      mutable optional<chain_id_type>                        _signees_chain_id;
+      mutable flat_set<public_key_type>                      _signees;
+
+   private:
+      void copy_cache_from( const signed_transaction& trx );
+
+      mutable cache_key _cache_key;
+   };
+
    /**
     *  @brief captures the result of evaluating the operations contained in the transaction
     *
@@ -194,14 +277,26 @@ namespace graphene { namespace protocol {
     *  If an operation did not create any new object IDs then 0
     *  should be returned.
     */
-   struct processed_transaction : public signed_transaction
+   struct processed_transaction : public precomputable_transaction
    {
       processed_transaction( const signed_transaction& trx = signed_transaction() )
-         : signed_transaction(trx){}
+         : precomputable_transaction(trx){}
 
       vector<operation_result> operation_results;
 
       digest_type merkle_digest()const;
+      /// @return fc::raw::pack_size() of this processed transaction
+      size_t      get_packed_size()const;
+
+   private:
+      void drop_cache()const override;
+      /// drops the values below if operation_results has been replaced or resized since they were computed
+      void check_results_cache()const;
+
+      // depend on operation_results, so they are never taken over from a signed_transaction
+      mutable optional<digest_type> _merkle_digest;
+      mutable optional<size_t>      _packed_size;
+      mutable size_t                _cached_results = 0;
    };
 
    /// @} transactions group
@@ -211,9 +306,10 @@ namespace graphene { namespace protocol {
 FC_REFLECT( graphene::protocol::transaction, (ref_block_num)(ref_block_prefix)(expiration)(operations)(extensions) )
 // Note: not reflecting signees field for backward compatibility; in addition, it should not be in p2p messages
 FC_REFLECT_DERIVED( graphene::protocol::signed_transaction, (graphene::protocol::transaction), (signatures) )
-FC_REFLECT_DERIVED( graphene::protocol::processed_transaction, (graphene::protocol::signed_transaction), (operation_results) )
+FC_REFLECT_DERIVED( graphene::protocol::precomputable_transaction, (graphene::protocol::signed_transaction), )
+FC_REFLECT_DERIVED( graphene::protocol::processed_transaction, (graphene::protocol::precomputable_transaction), (operation_results) )
 
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::transaction)
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::signed_transaction)
-//GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::precomputable_transaction)
+GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::precomputable_transaction)
 GRAPHENE_DECLARE_EXTERNAL_SERIALIZATION( graphene::protocol::processed_transaction)
\ No newline at end of file
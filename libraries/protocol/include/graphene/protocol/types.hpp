@@ -59,7 +59,7 @@
 #define GRAPHENE_EXTERNAL_SERIALIZATION(ext, type) \
 namespace fc { \
    ext template void from_variant( const variant& v, type& vo, uint32_t max_depth ); \
-   ext template void to_variant( const type& v, variant& vo, uint32_t max_depth ); \
+   ext template reflected_to_variant to_variant( const type& v, variant& vo, uint32_t max_depth ); \
 namespace raw { \
    ext template void pack< datastream<size_t>, type >( datastream<size_t>& s, const type& tx, uint32_t _max_depth ); \
    ext template void pack< sha256::encoder, type >( sha256::encoder& s, const type& tx, uint32_t _max_depth ); \
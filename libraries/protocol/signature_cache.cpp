@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/protocol/signature_cache.hpp>
+
+#include <fc/thread/scoped_lock.hpp>
+
+namespace graphene { namespace protocol {
+
+signature_cache& signature_cache::instance()
+{
+   static signature_cache cache;
+   return cache;
+}
+
+public_key_type signature_cache::recover( const signature_type& sig, const digest_type& digest )
+{
+   {
+      fc::scoped_lock<fc::spin_yield_lock> lock( _lock );
+      if( _capacity > 0 )
+      {
+         const auto& by_key = _entries.get<1>();
+         auto itr = by_key.find( std::make_pair( digest, sig ) );
+         if( itr != by_key.end() )
+         {
+            ++_hits;
+            _entries.relocate( _entries.begin(), _entries.project<0>( itr ) );
+            return itr->key;
+         }
+      }
+      ++_misses;
+   }
+
+   // recover without holding the lock, this is what the cache is saving us from
+   public_key_type key = fc::ecc::public_key( sig, digest );
+
+   fc::scoped_lock<fc::spin_yield_lock> lock( _lock );
+   if( _capacity > 0 && _entries.push_front( entry{ digest, sig, key } ).second )
+   {
+      while( _entries.size() > _capacity )
+         _entries.pop_back();
+   }
+   return key;
+}
+
+void signature_cache::set_capacity( size_t capacity )
+{
+   fc::scoped_lock<fc::spin_yield_lock> lock( _lock );
+   _capacity = capacity;
+   while( _entries.size() > _capacity )
+      _entries.pop_back();
+}
+
+signature_cache::cache_stats signature_cache::get_stats()const
+{
+   fc::scoped_lock<fc::spin_yield_lock> lock( _lock );
+   cache_stats result;
+   result.hits     = _hits;
+   result.misses   = _misses;
+   result.size     = _entries.size();
+   result.capacity = _capacity;
+   return result;
+}
+
+void signature_cache::reset_stats()
+{
+   fc::scoped_lock<fc::spin_yield_lock> lock( _lock );
+   _hits = 0;
+   _misses = 0;
+}
+
+void signature_cache::clear()
+{
+   fc::scoped_lock<fc::spin_yield_lock> lock( _lock );
+   _entries.clear();
+}
+
+} } // graphene::protocol
@@ -25,17 +25,53 @@
 #include <graphene/protocol/exceptions.hpp>
 #include <graphene/protocol/fee_schedule.hpp>
 #include <graphene/protocol/pts_address.hpp>
+#include <graphene/protocol/signature_cache.hpp>
 #include <algorithm>
 
 #include <fc/io/raw.hpp>
 
 namespace graphene { namespace protocol {
 
+void processed_transaction::drop_cache()const
+{
+   precomputable_transaction::drop_cache();
+   _merkle_digest.reset();
+   _packed_size.reset();
+}
+
+void processed_transaction::check_results_cache()const
+{
+   check_cache();
+   if( _cached_results != operation_results.size() )
+   {
+      _merkle_digest.reset();
+      _packed_size.reset();
+      _cached_results = operation_results.size();
+   }
+}
+
 digest_type processed_transaction::merkle_digest()const
 {
-   digest_type::encoder enc;
-   fc::raw::pack( enc, *this );
-   return enc.result();
+   check_results_cache();
+   if( !_merkle_digest.valid() )
+   {
+      // same as packing *this, but the transaction itself is only packed once
+      const vector<char>& packed = packed_transaction();
+      digest_type::encoder enc;
+      enc.write( packed.data(), packed.size() );
+      fc::raw::pack( enc, signatures );
+      fc::raw::pack( enc, operation_results );
+      _merkle_digest = enc.result();
+   }
+   return *_merkle_digest;
+}
+
+size_t processed_transaction::get_packed_size()const
+{
+   check_results_cache();
+   if( !_packed_size.valid() )
+      _packed_size = packed_transaction().size() + fc::raw::pack_size( signatures ) + fc::raw::pack_size( operation_results );
+   return *_packed_size;
 }
 
 digest_type transaction::digest()const
@@ -77,10 +113,7 @@ const signature_type& graphene::protocol::signed_transaction::sign(const private
 
 signature_type graphene::protocol::signed_transaction::sign(const private_key_type& key, const chain_id_type& chain_id)const
 {
-   digest_type::encoder enc;
-   fc::raw::pack( enc, chain_id );
-   fc::raw::pack( enc, *this );
-   return key.sign_compact(enc.result());
+   return key.sign_compact( sig_digest( chain_id ) );
 }
 
 void transaction::set_expiration( fc::time_point_sec expiration_time )
@@ -306,10 +339,11 @@ flat_set<public_key_type> signed_transaction::get_signature_keys( const chain_id
 { try {
    auto d = sig_digest( chain_id );
    flat_set<public_key_type> result;
+   auto& cache = signature_cache::instance();
    for( const auto&  sig : signatures )
    {
       GRAPHENE_ASSERT(
-         result.insert( fc::ecc::public_key(sig,d) ).second,
+         result.insert( cache.recover( sig, d ) ).second,
          tx_duplicate_sig,
          "Duplicate Signature detected" );
    }
@@ -379,6 +413,114 @@ set<public_key_type> signed_transaction::minimize_required_signatures(
    return set<public_key_type>( result.begin(), result.end() );
 }
 
+precomputable_transaction::precomputable_transaction( const signed_transaction& trx )
+   : signed_transaction( trx )
+{
+   copy_cache_from( trx );
+}
+
+precomputable_transaction::precomputable_transaction( signed_transaction&& trx )
+   : signed_transaction( std::move(trx) )
+{
+   // only the signed_transaction part of trx has been moved, the cache is still there
+   copy_cache_from( trx );
+}
+
+void precomputable_transaction::copy_cache_from( const signed_transaction& trx )
+{
+   const auto* other = dynamic_cast<const precomputable_transaction*>( &trx );
+   if( other == nullptr || other == this )
+      return;
+   // the key of other tells whether the values still match the fields, which are the same here
+   _cache_key        = other->_cache_key;
+   _packed_trx       = other->_packed_trx;
+   _digest           = other->_digest;
+   _sig_digest       = other->_sig_digest;
+   _signees_chain_id = other->_signees_chain_id;
+   _signees          = other->_signees;
+}
+
+bool precomputable_transaction::cache_key::operator==( const cache_key& other )const
+{
+   return ref_block_num == other.ref_block_num && ref_block_prefix == other.ref_block_prefix
+          && expiration == other.expiration && operations == other.operations
+          && extensions == other.extensions && signatures == other.signatures;
+}
+
+precomputable_transaction::cache_key precomputable_transaction::current_cache_key()const
+{
+   cache_key key;
+   key.ref_block_num    = ref_block_num;
+   key.ref_block_prefix = ref_block_prefix;
+   key.expiration       = expiration;
+   key.operations       = operations.size();
+   key.extensions       = extensions.size();
+   key.signatures       = signatures.size();
+   return key;
+}
+
+void precomputable_transaction::check_cache()const
+{
+   const cache_key key = current_cache_key();
+   if( key == _cache_key )
+      return;
+   drop_cache();
+   _cache_key = key;
+}
+
+void precomputable_transaction::drop_cache()const
+{
+   _packed_trx.reset();
+   _digest.reset();
+   _sig_digest.reset();
+   _signees_chain_id.reset();
+   _signees.clear();
+}
+
+const vector<char>& precomputable_transaction::packed_transaction()const
+{
+   check_cache();
+   if( !_packed_trx.valid() )
+      _packed_trx = fc::raw::pack( static_cast<const transaction&>( *this ) );
+   return *_packed_trx;
+}
+
+digest_type precomputable_transaction::digest()const
+{
+   check_cache();
+   if( !_digest.valid() )
+   {
+      const vector<char>& packed = packed_transaction();
+      _digest = digest_type::hash( packed.data(), packed.size() );
+   }
+   return *_digest;
+}
+
+digest_type precomputable_transaction::sig_digest( const chain_id_type& chain_id )const
+{
+   check_cache();
+   if( !_sig_digest.valid() || _sig_digest->first != chain_id )
+   {
+      const vector<char>& packed = packed_transaction();
+      digest_type::encoder enc;
+      fc::raw::pack( enc, chain_id );
+      enc.write( packed.data(), packed.size() );
+      _sig_digest = std::make_pair( chain_id, enc.result() );
+   }
+   return _sig_digest->second;
+}
+
+flat_set<public_key_type> precomputable_transaction::get_signature_keys( const chain_id_type& chain_id )const
+{
+   check_cache();
+   if( !_signees_chain_id.valid() || *_signees_chain_id != chain_id )
+   {
+      _signees = signed_transaction::get_signature_keys( chain_id );
+      _signees_chain_id = chain_id;
+   }
+   return _signees;
+}
+
 void signed_transaction::verify_authority(
    const chain_id_type& chain_id,
    const std::function<const authority*(account_id_type)>& get_active,
@@ -392,5 +534,5 @@ void signed_transaction::verify_authority(
 
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::transaction)
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::signed_transaction)
-//GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::precomputable_transaction)
+GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::precomputable_transaction)
 GRAPHENE_IMPLEMENT_EXTERNAL_SERIALIZATION( graphene::protocol::processed_transaction)
\ No newline at end of file
@@ -192,6 +192,7 @@ class wallet_api
       vector<call_order_object>         get_call_orders(string a, uint32_t limit)const;
       vector<force_settlement_object>   get_settle_orders(string a, uint32_t limit)const;
       map<account_id_type, uint16_t>    get_online_info()const;
+      vector<account_online_object>     list_online_info(account_id_type start, uint32_t limit)const;
       /** Returns the block chain's slowly-changing settings.
        * This object contains all of the properties of the blockchain that are fixed
        * or that change only once per maintenance interval (daily) such as the
@@ -581,6 +582,10 @@ class wallet_api
       transfer2(string from, string to, string amount, string asset_symbol, string memo);
 
       signed_transaction set_online_time( map<account_id_type, uint16_t> online_info);
+      /**
+       * Changes online minutes of the given accounts only, and removes the online info of the accounts in removed.
+       */
+      signed_transaction update_online_time( map<account_id_type, uint16_t> online_info, flat_set<account_id_type> removed );
       signed_transaction set_verification_is_required( account_id_type target, bool verification_is_required);
 
       signed_transaction set_account_limit_daily_volume(const std::string& name_or_id, bool enabled);
@@ -1521,6 +1526,7 @@ FC_API( graphene::wallet::wallet_api,
         (transfer)
         (transfer2)
         (set_online_time)
+        (update_online_time)
         (set_verification_is_required)
         (set_account_limit_daily_volume)
         (get_transaction_id)
@@ -1601,6 +1607,7 @@ FC_API( graphene::wallet::wallet_api,
         (get_call_orders)
         (get_settle_orders)
         (get_online_info)
+        (list_online_info)
         (save_wallet_file)
         (serialize_transaction)
         (sign_transaction)
@@ -317,6 +317,10 @@ map<account_id_type, uint16_t> wallet_api::get_online_info() const {
    return my->_remote_db->get_online_info();
 }
 
+vector<account_online_object> wallet_api::list_online_info(account_id_type start, uint32_t limit) const {
+   return my->_remote_db->list_online_info(start, limit);
+}
+
 brain_key_info wallet_api::suggest_brain_key() const
 {
    brain_key_info result;
@@ -692,6 +696,10 @@ wallet_api::transfer2(string from, string to, string amount, string asset_symbol
 signed_transaction wallet_api::set_online_time( map<account_id_type, uint16_t> online_info ) {
    return my->set_online_time(online_info);
 }
+signed_transaction wallet_api::update_online_time( map<account_id_type, uint16_t> online_info,
+                                                   flat_set<account_id_type> removed ) {
+   return my->update_online_time(online_info, removed);
+}
 signed_transaction wallet_api::set_verification_is_required( account_id_type target, bool verification_is_required ) {
    return my->set_verification_is_required(target, verification_is_required);
 }
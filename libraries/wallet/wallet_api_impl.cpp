@@ -88,6 +88,24 @@ namespace graphene { namespace wallet { namespace detail {
       return sign_transaction(tx, broadcast);
    } FC_CAPTURE_AND_RETHROW( (online_info) ) }
 
+   signed_transaction wallet_api_impl::update_online_time( map<account_id_type, uint16_t> online_info,
+                                                           flat_set<account_id_type> removed )
+   { try {
+      bool broadcast = true;
+      fc::optional<asset_object> fee_asset_obj = get_asset("CORE");
+      FC_ASSERT(fee_asset_obj, "Could not find asset matching ${asset}", ("asset", "CORE"));
+
+      update_online_time_operation op;
+      op.online_info = online_info;
+      op.removed = removed;
+      signed_transaction tx;
+      tx.operations.push_back(op);
+      set_operation_fees( tx, _remote_db->get_global_properties().parameters.get_current_fees(), fee_asset_obj->options.core_exchange_rate );
+      tx.validate();
+
+      return sign_transaction(tx, broadcast);
+   } FC_CAPTURE_AND_RETHROW( (online_info)(removed) ) }
+
    signed_transaction wallet_api_impl::generate_address(const string& account_id_or_name)
    {
       const account_object& acc = get_account(account_id_or_name);
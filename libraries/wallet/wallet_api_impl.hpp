@@ -139,6 +139,7 @@ public:
    asset get_burnt_asset(asset_id_type id);
    
    signed_transaction set_online_time(map<account_id_type, uint16_t> online_info);
+   signed_transaction update_online_time(map<account_id_type, uint16_t> online_info, flat_set<account_id_type> removed);
    
    signed_transaction set_verification_is_required(account_id_type target, bool verification_is_required);
 
@@ -134,6 +134,7 @@ int main( int argc, char** argv )
          ("wallet-file,w", bpo::value<string>()->implicit_value("wallet.json"), "wallet to load")
          ("chain-id", bpo::value<string>(), "chain ID to connect to")
          ("delayed",  bpo::bool_switch(), "Connect to delayed node if specified")
+         ("binary-rpc",  bpo::bool_switch(), "Ask the server to send replies packed in binary instead of JSON")
          ("no-backups",  bpo::bool_switch(), "Disable before/after import key backups creation if specified")
          ("io-threads", bpo::value<uint16_t>()->implicit_value(1), "Number of IO threads, default to 1")
          ("logs-rpc-console-level", bpo::value<string>()->default_value("info"), "Level of console logging")
@@ -223,6 +224,8 @@ int main( int argc, char** argv )
       idump((wdata.ws_server));
       auto con  = client.connect( wdata.ws_server );
       auto apic = std::make_shared<fc::rpc::websocket_api_connection>(con, GRAPHENE_MAX_NESTED_OBJECTS);
+      if( options.count("binary-rpc") && options.at("binary-rpc").as<bool>() )
+         apic->enable_binary_mode();
 
       auto remote_api = apic->get_remote_api< login_api >(1);
       edump((wdata.ws_user)(wdata.ws_password) );
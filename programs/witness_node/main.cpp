@@ -24,6 +24,7 @@
 #include <graphene/app/application.hpp>
 
 #include <graphene/witness/witness.hpp>
+#include <graphene/history/history_export.hpp>
 #include <graphene/history/history_plugin.hpp>
 #include <graphene/market_history/market_history_plugin.hpp>
 
@@ -69,6 +70,10 @@ int main(int argc, char** argv) {
             ("data-dir,d", bpo::value<boost::filesystem::path>()->default_value("witness_node_data_dir"), "Directory containing databases, configuration file, etc.")
             ("key-path,K", bpo::value<boost::filesystem::path>()->default_value(""), "Path to file with EDC owner key")
             ("fast",  bpo::value<int>(0), "Size of history in days")
+            ("export-history", bpo::value<boost::filesystem::path>(), "Write the operation history to this file (- for stdout) and exit")
+            ("export-history-format", bpo::value<std::string>()->default_value("json"), "Format of the exported history: json (one object per line) or binary")
+            ("export-history-start-block", bpo::value<uint32_t>()->default_value(1), "First block of the exported history")
+            ("export-history-end-block", bpo::value<uint32_t>()->default_value(0), "Last block of the exported history, 0 for the head block")
             ;
 
       bpo::variables_map options;
@@ -173,6 +178,36 @@ int main(int argc, char** argv) {
       node->initialize(data_dir, options);
       node->initialize_plugins( options );
 
+      if( options.count("export-history") )
+      {
+         // The export only reads the chain database, so the p2p node and RPC servers are never started
+         node->open_database();
+
+         const std::string format_name = options["export-history-format"].as<std::string>();
+         FC_ASSERT( format_name == "json" || format_name == "binary", "Unknown history export format ${f}",
+                    ("f", format_name) );
+         const auto format = ( format_name == "json" ) ? history::history_export_format::json
+                                                       : history::history_export_format::binary;
+         const boost::filesystem::path out_path = options["export-history"].as<boost::filesystem::path>();
+         std::ofstream out_file;
+         if( out_path != "-" )
+         {
+            out_file.open( out_path.string(), std::ofstream::binary | std::ofstream::out | std::ofstream::trunc );
+            FC_ASSERT( out_file, "Unable to open ${f}", ("f", out_path.string()) );
+         }
+         std::ostream& out = ( out_path == "-" ) ? std::cout : out_file;
+
+         const auto start = fc::time_point::now();
+         const uint64_t count = history::export_operation_history( *node->chain_database(), out,
+                                   options["export-history-start-block"].as<uint32_t>(),
+                                   options["export-history-end-block"].as<uint32_t>(), format,
+                                   history_plug->cold_store() );
+         ilog( "Exported ${n} operations in ${t} s", ("n", count)("t", (fc::time_point::now() - start).count() / 1000000) );
+         node->shutdown();
+         delete node;
+         return 0;
+      }
+
       node->startup();
       node->startup_plugins();
 
@@ -0,0 +1,346 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <graphene/app/api_reader_pool.hpp>
+#include <graphene/app/database_api.hpp>
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/account_object.hpp>
+#include <graphene/chain/operation_history_object.hpp>
+
+#include <fc/io/json.hpp>
+#include <fc/io/json_writer.hpp>
+#include <fc/io/raw.hpp>
+#include <fc/io/raw_variant.hpp>
+#include <fc/rpc/state.hpp>
+#include <fc/thread/thread.hpp>
+
+#include <boost/test/auto_unit_test.hpp>
+
+#include <algorithm>
+#include <atomic>
+
+#include "../common/database_fixture.hpp"
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+
+BOOST_FIXTURE_TEST_SUITE( api_benchmarks, database_fixture )
+
+BOOST_AUTO_TEST_CASE( object_changes_for_500_sessions )
+{
+   try {
+
+      BOOST_TEST_MESSAGE( "=== object_changes_for_500_sessions ===" );
+
+      const uint32_t session_count = 500;
+      const uint32_t account_count = 1000;
+      const uint32_t blocks = 10;
+      const uint32_t transfers_per_block = 1000;
+
+      vector<account_id_type> accounts;
+      for( uint32_t i = 0; i < account_count; ++i )
+      {
+         accounts.push_back( create_account( "bench-" + std::to_string( i ) ).id );
+         transfer( committee_account, accounts.back(), asset( 1000000 ) );
+      }
+      generate_block();
+
+      // every session follows two accounts, like a wallet with its own account and a contact
+      uint64_t delivered = 0;
+      vector<std::shared_ptr<graphene::app::database_api>> sessions;
+      for( uint32_t i = 0; i < session_count; ++i )
+      {
+         auto session = std::make_shared<graphene::app::database_api>( std::ref( db ) );
+         session->set_subscribe_callback( [&delivered]( const variant& updates ) {
+            delivered += updates.get_array().size();
+         }, true );
+         session->get_accounts( { accounts[2 * i], accounts[2 * i + 1] } );
+         sessions.push_back( session );
+      }
+
+      // the API sessions handle changed_objects between these two handlers
+      fc::time_point handlers_start;
+      fc::microseconds handlers_time;
+      uint64_t changed = 0;
+      fc::microseconds serialize_time;
+      auto before = db.changed_objects.connect( [&]( const vector<object_id_type>& ids ) {
+         // what a single serialization of the changes costs, which every session used to pay
+         auto start = fc::time_point::now();
+         for( const auto& id : ids )
+            if( const object* obj = db.find_object( id ) )
+               obj->to_variant();
+         serialize_time += fc::time_point::now() - start;
+         changed += ids.size();
+         handlers_start = fc::time_point::now();
+      }, boost::signals2::at_front );
+      auto after = db.changed_objects.connect( [&]( const vector<object_id_type>& ) {
+         handlers_time += fc::time_point::now() - handlers_start;
+      });
+
+      for( uint32_t b = 0; b < blocks; ++b )
+      {
+         for( uint32_t i = 0; i < transfers_per_block; ++i )
+            transfer( accounts[(b + i) % account_count], accounts[(b + i + 1) % account_count], asset( 1 ) );
+         generate_block();
+      }
+      before.disconnect();
+      after.disconnect();
+      fc::usleep( fc::milliseconds( 200 ) );
+
+      ilog( "${s} sessions, ${c} changed objects per block: ${d} us per block dispatching, "
+            "${o} us per block to serialize the changes once (${n} us for one serialization per session), "
+            "${v} updates delivered",
+            ("s", session_count)("c", changed / blocks)("d", handlers_time.count() / blocks)
+            ("o", serialize_time.count() / blocks)("n", serialize_time.count() / blocks * session_count)
+            ("v", delivered) );
+   }
+   catch (fc::exception& e)
+   {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+
+BOOST_AUTO_TEST_CASE( blocks_under_read_only_api_load )
+{
+   try {
+
+      BOOST_TEST_MESSAGE( "=== blocks_under_read_only_api_load ===" );
+
+      const uint32_t account_count = 1000;
+      const uint32_t client_count = 8;
+      const uint32_t reader_count = 4;
+      const uint32_t blocks = 20;
+      const uint32_t transfers_per_block = 200;
+
+      vector<account_id_type> accounts;
+      vector<string> names;
+      for( uint32_t i = 0; i < account_count; ++i )
+      {
+         names.push_back( "bench-" + std::to_string( i ) );
+         accounts.push_back( create_account( names.back() ).id );
+         transfer( committee_account, accounts.back(), asset( 1000000 ) );
+      }
+      generate_block();
+
+      graphene::app::database_api inline_api( db );
+      graphene::app::database_api pooled_api( db, graphene::app::subscription_queue_limits(),
+                                              graphene::app::transport_backlog_reader(),
+                                              std::make_shared<graphene::app::api_reader_pool>( db, reader_count ) );
+      fc::thread& api_thread = fc::thread::current();
+
+      // like the websocket server, the clients' calls are handled by tasks of the API thread, which yields to them
+      // between blocks
+      auto run = [&]( bool with_clients, graphene::app::database_api& api, uint64_t& calls ) {
+         std::atomic<bool> stop{false};
+         std::atomic<uint64_t> done{0};
+         vector<std::unique_ptr<fc::thread>> clients;
+         vector<fc::future<void>> loops;
+         if( with_clients )
+            for( uint32_t c = 0; c < client_count; ++c )
+            {
+               clients.emplace_back( new fc::thread( "api client " + std::to_string( c ) ) );
+               loops.push_back( clients.back()->async( [&, c]() {
+                  for( uint32_t i = 0; !stop; ++i )
+                  {
+                     const auto first = names.begin() + ( c * 97 + i * 10 ) % ( account_count - 10 );
+                     const vector<string> wanted( first, first + 10 );
+                     api_thread.async( [&]() {
+                        api.get_full_accounts( wanted, false );
+                        api.lookup_accounts( wanted.front(), 100 );
+                     }).wait();
+                     ++done;
+                  }
+               }));
+            }
+
+         fc::microseconds block_time;
+         for( uint32_t b = 0; b < blocks; ++b )
+         {
+            auto start = fc::time_point::now();
+            for( uint32_t i = 0; i < transfers_per_block; ++i )
+               transfer( accounts[(b + i) % account_count], accounts[(b + i + 1) % account_count], asset( 1 ) );
+            generate_block();
+            fc::yield();
+            block_time += fc::time_point::now() - start;
+         }
+
+         stop = true;
+         while( with_clients && std::any_of( loops.begin(), loops.end(), []( const fc::future<void>& f ) {
+                   return !f.ready(); } ) )
+            fc::usleep( fc::milliseconds( 1 ) );
+         for( auto& client : clients )
+            client->quit();
+         calls = done;
+         return block_time.count() / blocks;
+      };
+
+      uint64_t calls = 0;
+      const auto idle = run( false, inline_api, calls );
+      const auto inline_load = run( true, inline_api, calls );
+      const uint64_t inline_calls = calls;
+
+      const auto pooled_load = run( true, pooled_api, calls );
+
+      ilog( "${b} blocks of ${t} transfers, ${c} API clients: ${i} us per block idle, "
+            "${l} us per block with the calls on the API thread (${lc} calls), "
+            "${p} us per block with the calls on ${r} reader threads (${pc} calls)",
+            ("b", blocks)("t", transfers_per_block)("c", client_count)("i", idle)
+            ("l", inline_load)("lc", inline_calls)("p", pooled_load)("r", reader_count)("pc", calls) );
+   }
+   catch (fc::exception& e)
+   {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+BOOST_AUTO_TEST_CASE( json_vs_binary_replies )
+{
+   try {
+
+      BOOST_TEST_MESSAGE( "=== json_vs_binary_replies ===" );
+
+      const uint32_t account_count = 100;
+      const uint32_t blocks = 50;
+      const uint32_t rounds = 100;
+
+      vector<account_id_type> accounts;
+      for( uint32_t i = 0; i < account_count; ++i )
+      {
+         accounts.push_back( create_account( "bench-" + std::to_string( i ) ).id );
+         transfer( committee_account, accounts.back(), asset( 1000000 ) );
+      }
+      generate_block();
+
+      // a get_blocks style reply, the kind of bulk result a syncing wallet fetches
+      vector<signed_block> fetched;
+      for( uint32_t b = 0; b < blocks; ++b )
+      {
+         for( uint32_t i = 0; i + 1 < account_count; ++i )
+            transfer( accounts[i], accounts[i + 1], asset( 10 ) );
+         fetched.push_back( generate_block() );
+      }
+      const fc::rpc::response reply( fc::variant( 1 ), fc::variant( fetched, GRAPHENE_MAX_NESTED_OBJECTS ) );
+
+      size_t json_size = 0;
+      auto start = fc::time_point::now();
+      for( uint32_t r = 0; r < rounds; ++r )
+      {
+         const std::string text = fc::json::to_string( reply, fc::json::stringify_large_ints_and_doubles,
+                                                       GRAPHENE_MAX_NESTED_OBJECTS );
+         json_size = text.size();
+         auto decoded = fc::json::from_string( text, fc::json::legacy_parser, GRAPHENE_MAX_NESTED_OBJECTS )
+                           .as<fc::rpc::response>( GRAPHENE_MAX_NESTED_OBJECTS );
+         BOOST_REQUIRE( decoded.result.valid() );
+      }
+      const auto json_time = fc::time_point::now() - start;
+
+      size_t binary_size = 0;
+      start = fc::time_point::now();
+      for( uint32_t r = 0; r < rounds; ++r )
+      {
+         const std::vector<char> packed = fc::raw::pack( reply, uint32_t( GRAPHENE_MAX_NESTED_OBJECTS ) );
+         binary_size = packed.size();
+         auto decoded = fc::raw::unpack<fc::rpc::response>( packed, uint32_t( GRAPHENE_MAX_NESTED_OBJECTS ) );
+         BOOST_REQUIRE( decoded.result.valid() );
+      }
+      const auto binary_time = fc::time_point::now() - start;
+
+      ilog( "reply with ${b} blocks of ${t} transfers: JSON ${js} bytes, ${jt} us per encode and decode; "
+            "binary ${bs} bytes, ${bt} us per encode and decode",
+            ("b", blocks)("t", account_count - 1)("js", json_size)("jt", json_time.count() / rounds)
+            ("bs", binary_size)("bt", binary_time.count() / rounds) );
+   }
+   catch (fc::exception& e)
+   {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+BOOST_AUTO_TEST_CASE( json_writer_vs_variant_json )
+{
+   try {
+
+      BOOST_TEST_MESSAGE( "=== json_writer_vs_variant_json ===" );
+
+      const uint32_t account_count = 200;
+      const uint32_t transfers_per_block = 1000;
+      const uint32_t rounds = 50;
+      const uint32_t depth = GRAPHENE_MAX_NESTED_OBJECTS;
+
+      vector<account_id_type> accounts;
+      for( uint32_t i = 0; i < account_count; ++i )
+      {
+         accounts.push_back( create_account( "bench-" + std::to_string( i ) ).id );
+         transfer( committee_account, accounts.back(), asset( 1000000 ) );
+      }
+      generate_block();
+
+      for( uint32_t i = 0; i < transfers_per_block; ++i )
+         transfer( accounts[i % account_count], accounts[(i + 1) % account_count], asset( 10 ) );
+      const signed_block block = generate_block();
+
+      // a 100 item page, as get_account_history returns it
+      vector<operation_history_object> page;
+      for( const auto& h : db.get_index_type<operation_history_index>().indices() )
+      {
+         page.push_back( h );
+         if( page.size() == 100 )
+            break;
+      }
+
+      auto measure = [&]( const auto& value, const char* name ) {
+         std::string through_variant;
+         auto start = fc::time_point::now();
+         for( uint32_t r = 0; r < rounds; ++r )
+            through_variant = fc::json::to_string( fc::variant( value, depth ),
+                                                   fc::json::stringify_large_ints_and_doubles, depth );
+         const auto variant_time = fc::time_point::now() - start;
+
+         std::string direct;
+         start = fc::time_point::now();
+         for( uint32_t r = 0; r < rounds; ++r )
+            direct = fc::json_writer::to_string( value, fc::json::stringify_large_ints_and_doubles, depth );
+         const auto direct_time = fc::time_point::now() - start;
+
+         BOOST_CHECK( through_variant == direct );
+         ilog( "${n}: ${s} bytes, ${v} us through fc::variant, ${d} us with json_writer",
+               ("n", name)("s", direct.size())("v", variant_time.count() / rounds)
+               ("d", direct_time.count() / rounds) );
+      };
+
+      measure( block, "get_block with 1000 transfers" );
+      measure( page, "100 item history page" );
+   }
+   catch (fc::exception& e)
+   {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
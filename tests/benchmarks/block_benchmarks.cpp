@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/account_object.hpp>
+#include <graphene/chain/global_property_object.hpp>
+
+#include <fc/io/raw.hpp>
+
+#include <boost/test/auto_unit_test.hpp>
+
+#include "../common/database_fixture.hpp"
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+
+BOOST_FIXTURE_TEST_SUITE( block_benchmarks, database_fixture )
+
+/**
+ * Pushes trx_count distinct transfers from one account to another into the pending queue.
+ */
+static void push_pending_transfers( database_fixture& f, account_id_type from, account_id_type to, uint32_t trx_count,
+                                    const fc::ecc::private_key& key )
+{
+   for( uint32_t i = 0; i < trx_count; ++i )
+   {
+      signed_transaction tx;
+      transfer_operation op;
+      op.from = from;
+      op.to = to;
+      op.amount = asset( 1 );
+      tx.operations.push_back( op );
+      set_expiration( f.db, tx );
+      tx.expiration += i; // makes every transaction unique
+      f.sign( tx, key );
+      f.db.push_transaction( tx, database::skip_nothing );
+   }
+}
+
+BOOST_AUTO_TEST_CASE( block_apply_with_cached_digests )
+{
+   try {
+
+      BOOST_TEST_MESSAGE( "=== block_apply_with_cached_digests ===" );
+
+      ACTORS( (alice)(bob) );
+      fund( alice );
+
+      const uint32_t trx_count = 1000;
+      const uint32_t rounds = 10;
+      push_pending_transfers( *this, alice_id, bob_id, trx_count, alice_private_key );
+      const signed_block b = generate_block();
+      BOOST_REQUIRE_EQUAL( b.transactions.size(), trx_count );
+
+      const vector<char> packed = fc::raw::pack( b );
+      const uint32_t skip = database::skip_nothing;
+
+      // every round applies a freshly unpacked block, so every id and digest is computed from scratch
+      fc::microseconds fresh_time;
+      for( uint32_t i = 0; i < rounds; ++i )
+      {
+         db.pop_block();
+         const signed_block fresh = fc::raw::unpack<signed_block>( packed );
+         auto start = fc::time_point::now();
+         PUSH_BLOCK( db, fresh, skip );
+         fresh_time += fc::time_point::now() - start;
+      }
+
+      // the transactions of b have been packed and hashed once, by generate_block()
+      fc::microseconds cached_time;
+      for( uint32_t i = 0; i < rounds; ++i )
+      {
+         db.pop_block();
+         auto start = fc::time_point::now();
+         PUSH_BLOCK( db, b, skip );
+         cached_time += fc::time_point::now() - start;
+      }
+
+      ilog( "Applied block with ${n} transfers: ${f} us without cached digests, ${c} us with cached digests",
+            ("n", trx_count)("f", fresh_time.count() / rounds)("c", cached_time.count() / rounds) );
+   }
+   catch (fc::exception& e)
+   {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+BOOST_AUTO_TEST_CASE( generate_blocks_from_pending_transfers )
+{
+   try {
+
+      BOOST_TEST_MESSAGE( "=== generate_blocks_from_pending_transfers ===" );
+
+      ACTORS( (alice)(bob) );
+      fund( alice, asset( 1000000 ) );
+
+      const uint32_t trx_count = 10000;
+      push_pending_transfers( *this, alice_id, bob_id, trx_count, alice_private_key );
+
+      // limit blocks to about a quarter of the pending transfers, so blocks are filled up
+      signed_transaction sample;
+      transfer_operation op;
+      op.from = alice_id;
+      op.to = bob_id;
+      op.amount = asset( 1 );
+      sample.operations.push_back( op );
+      set_expiration( db, sample );
+      sign( sample, alice_private_key );
+      const size_t trx_size = fc::raw::pack_size( processed_transaction( sample ) );
+      db.modify( db.get_global_properties(), [&]( global_property_object& p ) {
+         p.parameters.maximum_block_size = trx_size * trx_count / 4;
+      });
+
+      uint32_t blocks = 0;
+      uint32_t included = 0;
+      fc::microseconds total_time;
+      while( included < trx_count && blocks < 100 )
+      {
+         auto start = fc::time_point::now();
+         const signed_block b = db.generate_block( db.get_slot_time(1), db.get_scheduled_witness(1),
+                                                   init_account_priv_key, database::skip_nothing );
+         total_time += fc::time_point::now() - start;
+         ++blocks;
+         included += b.transactions.size();
+         ilog( "Generated block with ${n} of ${p} pending transfers",
+               ("n", b.transactions.size())("p", trx_count - included + b.transactions.size()) );
+      }
+      BOOST_CHECK_EQUAL( included, trx_count );
+
+      ilog( "Generated ${b} blocks from ${n} pending transfers: ${t} us per block",
+            ("b", blocks)("n", trx_count)("t", total_time.count() / blocks) );
+   }
+   catch (fc::exception& e)
+   {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+BOOST_AUTO_TEST_CASE( time_to_broadcast )
+{
+   try {
+
+      BOOST_TEST_MESSAGE( "=== time_to_broadcast ===" );
+
+      ACTORS( (alice)(bob) );
+      fund( alice, asset( 1000000 ) );
+
+      const uint32_t trx_count = 2000;
+      const uint32_t rounds = 5;
+      fc::microseconds generate_time;
+      fc::microseconds replay_time;
+      for( uint32_t i = 0; i < rounds; ++i )
+      {
+         push_pending_transfers( *this, alice_id, bob_id, trx_count, alice_private_key );
+
+         // the block is ready to be broadcast when generate_block() returns
+         auto start = fc::time_point::now();
+         const signed_block b = db.generate_block( db.get_slot_time(1), db.get_scheduled_witness(1),
+                                                   init_account_priv_key, database::skip_nothing );
+         generate_time += fc::time_point::now() - start;
+         BOOST_REQUIRE_EQUAL( b.transactions.size(), trx_count );
+
+         // pushing the block again measures the application which is no longer repeated by generate_block()
+         db.pop_block();
+         start = fc::time_point::now();
+         PUSH_BLOCK( db, b, database::skip_transaction_signatures );
+         replay_time += fc::time_point::now() - start;
+      }
+
+      ilog( "Generated blocks with ${n} transfers in ${g} us, applying such a block again takes ${r} us",
+            ("n", trx_count)("g", generate_time.count() / rounds)("r", replay_time.count() / rounds) );
+   }
+   catch (fc::exception& e)
+   {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <graphene/app/api.hpp>
+#include <graphene/app/impacted.hpp>
+#include <graphene/chain/database.hpp>
+#include <graphene/chain/account_object.hpp>
+#include <graphene/chain/hardfork.hpp>
+#include <graphene/chain/operation_history_object.hpp>
+#include <graphene/history/history_plugin.hpp>
+#include <graphene/utilities/tempdir.hpp>
+
+#include <boost/test/auto_unit_test.hpp>
+
+#include "../common/database_fixture.hpp"
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+
+BOOST_FIXTURE_TEST_SUITE( history_benchmarks, database_fixture )
+
+BOOST_AUTO_TEST_CASE( page_to_millionth_operation )
+{
+   try {
+
+      BOOST_TEST_MESSAGE( "=== page_to_millionth_operation ===" );
+
+      ACTORS( (alice) );
+      generate_block();
+
+      const uint32_t history_size = 1000000;
+      const uint32_t page_size = 100;
+
+      // Only the oldest page references real operations, the rest of the history only needs its entries.
+      vector<operation_history_id_type> real_ops;
+      for( uint32_t i = 0; i < page_size; ++i )
+      {
+         real_ops.push_back( db.create<operation_history_object>( [&]( operation_history_object& o ) {
+            transfer_operation op;
+            op.from = alice_id;
+            op.amount = asset( i + 1 );
+            o.op = op;
+         }).id );
+      }
+      const uint64_t fake_op_base = real_ops.back().instance.value + 1;
+
+      const account_statistics_object& stats = alice_id(db).statistics(db);
+      const uint32_t first_seq = stats.total_ops + 1;
+      account_transaction_history_id_type prev = stats.most_recent_op;
+      auto start = fc::time_point::now();
+      for( uint32_t i = 0; i < history_size; ++i )
+      {
+         prev = db.create<account_transaction_history_object>( [&]( account_transaction_history_object& h ) {
+            h.account = alice_id;
+            h.operation_id = ( i < page_size ) ? real_ops[i] : operation_history_id_type( fake_op_base + i );
+            h.sequence = first_seq + i;
+            h.next = prev;
+         }).id;
+      }
+      db.modify( stats, [&]( account_statistics_object& s ) {
+         s.most_recent_op = prev;
+         s.total_ops = first_seq + history_size - 1;
+      });
+      ilog( "Created a history of ${n} operations in ${t} ms",
+            ("n", history_size)("t", (fc::time_point::now() - start).count() / 1000) );
+
+      graphene::app::history_api hist_api( app );
+      const uint32_t target = first_seq + page_size - 1;
+
+      // what the history endpoints did before: follow the next links from the most recent operation
+      start = fc::time_point::now();
+      const account_transaction_history_object* node = &stats.most_recent_op(db);
+      while( node->sequence > target )
+         node = &node->next(db);
+      const fc::microseconds walk_time = fc::time_point::now() - start;
+      BOOST_CHECK( node->operation_id == real_ops.back() );
+
+      start = fc::time_point::now();
+      const graphene::app::account_history_page page = hist_api.get_account_history_page( alice_id, target, page_size );
+      const fc::microseconds seq_time = fc::time_point::now() - start;
+      BOOST_REQUIRE_EQUAL( page.operations.size(), page_size );
+      BOOST_CHECK( page.operations.front().id == real_ops.back() );
+
+      start = fc::time_point::now();
+      const vector<operation_history_object> by_id = hist_api.get_account_history( alice_id,
+                                                        operation_history_id_type(), page_size, real_ops.back() );
+      const fc::microseconds id_time = fc::time_point::now() - start;
+      BOOST_REQUIRE_EQUAL( by_id.size(), page_size );
+
+      ilog( "Reached operation ${n}: ${w} us following links, ${s} us seeking by sequence, ${i} us seeking by id",
+            ("n", history_size)("w", walk_time.count())("s", seq_time.count())("i", id_time.count()) );
+   }
+   catch (fc::exception& e)
+   {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+BOOST_AUTO_TEST_CASE( cold_history_queries )
+{
+   try {
+
+      BOOST_TEST_MESSAGE( "=== cold_history_queries ===" );
+
+      create_edc();
+      generate_blocks( HARDFORK_620_TIME + 60 );
+      ACTORS( (alice)(bob) );
+      fund( alice, asset( 100000000 ) );
+      generate_block();
+
+      const uint32_t transfers = 20000;
+      const uint32_t kept = 1000;
+      const uint32_t page_size = 100;
+
+      fc::temp_directory cold_dir( graphene::utilities::temp_directory_path() );
+      auto plugin = app.get_plugin<graphene::history::history_plugin>( "history" );
+      plugin->set_max_ops_per_account( kept );
+      plugin->open_cold_store( cold_dir.path() );
+
+      auto start = fc::time_point::now();
+      for( uint32_t i = 0; i < transfers; ++i )
+      {
+         transfer( alice_id, bob_id, asset( 1 + i % 100 ) );
+         if( i % 200 == 199 )
+            generate_block();
+      }
+      generate_block();
+      ilog( "Applied ${n} transfers in ${t} ms", ("n", transfers)("t", (fc::time_point::now() - start).count() / 1000) );
+
+      // memory: the objects of one entry against its index entry, both accounts of a transfer sharing its operation
+      const auto& hist_idx = db.get_index_type<account_transaction_history_index>().indices().get<by_seq>();
+      const size_t entry_size = sizeof( account_transaction_history_object ) + sizeof( operation_history_object ) / 2;
+      const size_t memory_entries = std::distance( hist_idx.lower_bound( boost::make_tuple( alice_id ) ),
+                                                   hist_idx.upper_bound( boost::make_tuple( alice_id ) ) );
+      const size_t cold_entries = plugin->cold_store()->entries( alice_id ).size();
+      BOOST_CHECK_EQUAL( memory_entries, kept );
+      ilog( "${m} entries in memory, ${c} on disk: about ${saved} KiB of objects replaced by ${index} KiB of index",
+            ("m", memory_entries)("c", cold_entries)("saved", cold_entries * entry_size / 1024)
+            ("index", cold_entries * sizeof( graphene::history::cold_history_store::entry ) / 1024) );
+
+      graphene::app::history_api hist_api( app );
+      const uint32_t total_ops = alice_id(db).statistics(db).total_ops;
+      auto time_page = [&]( uint32_t seq )
+      {
+         auto page_start = fc::time_point::now();
+         const graphene::app::account_history_page page = hist_api.get_account_history_page( alice_id, seq, page_size );
+         const fc::microseconds elapsed = fc::time_point::now() - page_start;
+         BOOST_CHECK_EQUAL( page.operations.size(), page_size );
+         return elapsed.count();
+      };
+      ilog( "Pages of ${p} operations: ${hot} us in memory, ${cold} us on disk, ${across} us across both",
+            ("p", page_size)("hot", time_page( total_ops ))("cold", time_page( total_ops / 2 ))
+            ("across", time_page( total_ops - kept + page_size / 2 )) );
+   }
+   catch (fc::exception& e)
+   {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+BOOST_AUTO_TEST_CASE( update_histories_per_block )
+{
+   try {
+
+      BOOST_TEST_MESSAGE( "=== update_histories_per_block ===" );
+
+      ACTORS( (alice)(bob)(carol)(dave) );
+      fund( alice, asset( 100000000 ) );
+      fund( carol, asset( 100000000 ) );
+      generate_block();
+
+      const uint32_t blocks = 20;
+      const uint32_t transfers_per_block = 2000;
+
+      // the history plugins handle applied_block between these two handlers
+      fc::time_point handlers_start;
+      fc::microseconds handlers_time;
+      auto before = db.applied_block.connect( [&]( const signed_block& ) { handlers_start = fc::time_point::now(); },
+                                              boost::signals2::at_front );
+      auto after = db.applied_block.connect( [&]( const signed_block& ) {
+         handlers_time += fc::time_point::now() - handlers_start;
+      });
+
+      // Both ways of storing the applied operations of a block when only alice is tracked, each replayed in an undo
+      // session that is thrown away: the former one created an operation_history_object for every operation and
+      // removed it again when it failed or nobody referred to it, with new impacted sets per operation; the current
+      // one reuses its impacted sets and only consumes the ids of the operations it does not store.
+      const flat_set<account_id_type> tracked{ alice_id };
+      fc::microseconds former_time;
+      fc::microseconds current_time;
+      auto compare = db.applied_block.connect( [&]( const signed_block& blk ) {
+         const auto& hist = db.get_applied_operations();
+         auto store = [&]( const operation_history_object& op ) -> const operation_history_object& {
+            return db.create<operation_history_object>( [&]( operation_history_object& h ) {
+               h.op = op.op;
+               h.result = op.result;
+               h.block_num = op.block_num;
+               h.trx_in_block = op.trx_in_block;
+               h.op_in_trx = op.op_in_trx;
+               h.virtual_op = op.virtual_op;
+               h.block_time = blk.timestamp;
+            });
+         };
+         object_id_type former_next;
+         {
+            auto session = db._undo_db.start_undo_session();
+            auto start = fc::time_point::now();
+            for( const optional<operation_history_object>& o_op : hist )
+            {
+               const auto& oho = o_op.valid() ? store( *o_op ) : db.create<operation_history_object>(
+                                                                    []( operation_history_object& ) {} );
+               if( !o_op.valid() )
+               {
+                  db.remove( oho );
+                  continue;
+               }
+               flat_set<account_id_type> impacted_acc;
+               flat_set<fund_id_type> impacted_funds;
+               graphene::app::operation_get_impacted_items( o_op->op, impacted_acc, impacted_funds );
+               bool linked = false;
+               for( const account_id_type& account_id : tracked )
+                  linked = linked || impacted_acc.count( account_id );
+               if( !linked )
+                  db.remove( oho );
+            }
+            former_time += fc::time_point::now() - start;
+            former_next = db.get_index_type<operation_history_index>().get_next_id();
+         }
+         {
+            auto session = db._undo_db.start_undo_session();
+            auto start = fc::time_point::now();
+            flat_set<account_id_type> impacted_acc;
+            flat_set<fund_id_type> impacted_funds;
+            flat_set<account_id_type> linked_acc;
+            for( const optional<operation_history_object>& o_op : hist )
+            {
+               if( !o_op.valid() )
+               {
+                  db.skip_next_id<operation_history_object>();
+                  continue;
+               }
+               impacted_acc.clear();
+               impacted_funds.clear();
+               linked_acc.clear();
+               graphene::app::operation_get_impacted_items( o_op->op, impacted_acc, impacted_funds );
+               std::set_intersection( impacted_acc.begin(), impacted_acc.end(), tracked.begin(), tracked.end(),
+                                      std::inserter( linked_acc, linked_acc.end() ) );
+               if( linked_acc.empty() )
+                  db.skip_next_id<operation_history_object>();
+               else
+                  store( *o_op );
+            }
+            current_time += fc::time_point::now() - start;
+            // both ways hand out the same operation history ids
+            BOOST_CHECK( db.get_index_type<operation_history_index>().get_next_id() == former_next );
+         }
+      });
+
+      fc::microseconds block_time;
+      for( uint32_t b = 0; b < blocks; ++b )
+      {
+         for( uint32_t i = 0; i < transfers_per_block; ++i )
+         {
+            if( i % 2 )
+               transfer( alice_id, bob_id, asset( 1 + i % 100 ) );
+            else
+               transfer( carol_id, dave_id, asset( 1 + i % 100 ) );
+         }
+         auto start = fc::time_point::now();
+         generate_block();
+         block_time += fc::time_point::now() - start;
+      }
+      before.disconnect();
+      after.disconnect();
+      compare.disconnect();
+
+      ilog( "${n} transfers per block: ${h} us per block in applied_block handlers, ${b} us per block in total",
+            ("n", transfers_per_block)("h", handlers_time.count() / blocks)("b", block_time.count() / blocks) );
+      ilog( "Storing the operations of a block with one tracked account: ${f} us before, ${c} us now",
+            ("f", former_time.count() / blocks)("c", current_time.count() / blocks) );
+   }
+   catch (fc::exception& e)
+   {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
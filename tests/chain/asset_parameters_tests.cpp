@@ -226,9 +226,7 @@ BOOST_AUTO_TEST_CASE( mining_test )
    }
    target += fc::days(1);
    set_expiration(db, this->trx);
-   db.modify(accounts_online_id_type()(db), [&](accounts_online_object& aoo) {
-      aoo.online_info.emplace(alice_id, 720);
-   });
+   db.set_online_minutes(alice_id, 720);
    transfer(alice_id, account_id_type(), asset(1000, asset1.id), asset(0, asset_id_type(1)));
    while( db.head_block_time() < target)
    {
@@ -26,6 +26,7 @@
 
 #include <graphene/chain/database.hpp>
 #include <graphene/chain/exceptions.hpp>
+#include <graphene/protocol/signature_cache.hpp>
 
 #include <graphene/chain/account_object.hpp>
 #include <graphene/chain/asset_object.hpp>
@@ -1361,4 +1362,84 @@ BOOST_FIXTURE_TEST_CASE( nonminimal_sig_test, database_fixture )
    }
 }
 
+BOOST_AUTO_TEST_CASE( precomputed_signature_keys )
+{ try {
+   BOOST_TEST_MESSAGE( "=== precomputed_signature_keys ===" );
+
+   ACTORS( (alice)(bob) );
+   fund( alice );
+
+   transfer_operation op;
+   op.from = alice_id;
+   op.to = bob_id;
+   op.amount = asset(500);
+   trx.operations.push_back( op );
+   set_expiration( db, trx );
+   sign( trx, alice_private_key );
+
+   precomputable_transaction ptrx( trx );
+   db.precompute_parallel( ptrx ).wait();
+   BOOST_CHECK( ptrx.id() == trx.id() );
+   BOOST_CHECK( ptrx.get_signature_keys( db.get_chain_id() ) == trx.get_signature_keys( db.get_chain_id() ) );
+
+   // the cache is taken over from other precomputable transactions only
+   processed_transaction copy( ptrx );
+   BOOST_CHECK( copy.id() == trx.id() );
+   trx.operations.back().get<transfer_operation>().amount = asset(400);
+   trx.signatures.clear();
+   sign( trx, alice_private_key );
+   BOOST_CHECK( precomputable_transaction( trx ).id() == trx.id() );
+   BOOST_CHECK( precomputable_transaction( trx ).id() != ptrx.id() );
+
+   PUSH_TX( db, ptrx, database::skip_transaction_dupe_check );
+   signed_block b = generate_block();
+   BOOST_REQUIRE_EQUAL( b.transactions.size(), 1u );
+   db.precompute_parallel( b, database::skip_nothing ).wait();
+   BOOST_CHECK( b.transactions[0].id() == ptrx.id() );
+   BOOST_CHECK_EQUAL( get_balance( bob_id, asset_id_type() ), 500 );
+} FC_LOG_AND_RETHROW() }
+
+BOOST_AUTO_TEST_CASE( signature_cache_lru )
+{ try {
+   BOOST_TEST_MESSAGE( "=== signature_cache_lru ===" );
+
+   ACTORS( (alice)(bob) );
+
+   auto& cache = signature_cache::instance();
+   cache.clear();
+   cache.reset_stats();
+   cache.set_capacity( 1 );
+
+   transfer_operation op;
+   op.from = alice_id;
+   op.to = bob_id;
+   op.amount = asset(500);
+   trx.operations.push_back( op );
+   set_expiration( db, trx );
+   sign( trx, alice_private_key );
+
+   const flat_set<public_key_type> keys = trx.get_signature_keys( db.get_chain_id() );
+   BOOST_CHECK( keys == flat_set<public_key_type>{ alice_public_key } );
+   BOOST_CHECK( trx.get_signature_keys( db.get_chain_id() ) == keys );
+   BOOST_CHECK_EQUAL( cache.get_stats().misses, 1u );
+   BOOST_CHECK_EQUAL( cache.get_stats().hits, 1u );
+
+   // a different transaction evicts the least recently used key
+   signed_transaction trx2 = trx;
+   trx2.operations.back().get<transfer_operation>().amount = asset(400);
+   trx2.signatures.clear();
+   sign( trx2, alice_private_key );
+   BOOST_CHECK( trx2.get_signature_keys( db.get_chain_id() ) == keys );
+   BOOST_CHECK_EQUAL( cache.get_stats().size, 1u );
+   BOOST_CHECK( trx.get_signature_keys( db.get_chain_id() ) == keys );
+   BOOST_CHECK_EQUAL( cache.get_stats().misses, 3u );
+
+   cache.set_capacity( 0 );
+   BOOST_CHECK_EQUAL( cache.get_stats().size, 0u );
+   BOOST_CHECK( trx.get_signature_keys( db.get_chain_id() ) == keys );
+   BOOST_CHECK_EQUAL( cache.get_stats().hits, 1u );
+
+   cache.set_capacity( GRAPHENE_DEFAULT_SIGNATURE_CACHE_SIZE );
+} FC_LOG_AND_RETHROW() }
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -424,4 +424,135 @@ BOOST_AUTO_TEST_CASE( merkle_root )
    BOOST_CHECK( block.calculate_merkle_root() == c(dO) );
 }
 
+BOOST_AUTO_TEST_CASE( cached_transaction_digests )
+{
+   BOOST_TEST_MESSAGE( "=== cached_transaction_digests ===" );
+
+   fc::ecc::private_key key = fc::ecc::private_key::regenerate( fc::sha256::hash( string( "key" ) ) );
+   const chain_id_type chain_id = db.get_chain_id();
+
+   signed_transaction trx;
+   transfer_operation op;
+   op.amount = asset(100);
+   trx.operations.push_back( op );
+   trx.ref_block_prefix = 1;
+   trx.sign( key, chain_id );
+
+   processed_transaction ptx( trx );
+   ptx.operation_results.push_back( void_result() );
+
+   BOOST_CHECK( ptx.digest() == trx.digest() );
+   BOOST_CHECK( ptx.id() == trx.id() );
+   BOOST_CHECK( ptx.sig_digest( chain_id ) == trx.sig_digest( chain_id ) );
+   BOOST_CHECK( ptx.merkle_digest() == digest_type::hash( ptx ) );
+   BOOST_CHECK_EQUAL( ptx.get_packed_size(), fc::raw::pack_size( ptx ) );
+   BOOST_CHECK( ptx.packed_transaction() == fc::raw::pack( static_cast<const transaction&>( trx ) ) );
+
+   // a processed transaction built from a different transaction does not reuse the cache
+   trx.ref_block_prefix = 2;
+   trx.signatures.clear();
+   trx.sign( key, chain_id );
+   processed_transaction ptx2( trx );
+   BOOST_CHECK( ptx2.id() == trx.id() );
+   BOOST_CHECK( ptx2.id() != ptx.id() );
+   BOOST_CHECK( ptx2.merkle_digest() == digest_type::hash( ptx2 ) );
+
+   // copies of a processed transaction keep the cached values
+   processed_transaction copy( ptx );
+   BOOST_CHECK( copy.merkle_digest() == ptx.merkle_digest() );
+   BOOST_CHECK( processed_transaction( static_cast<const signed_transaction&>( ptx ) ).id() == ptx.id() );
+}
+
+namespace {
+
+/// sets the amount of the transfers it visits
+struct set_transfer_amount
+{
+   typedef int result_type;
+   share_type amount;
+
+   template<typename Op>
+   int operator()( Op& )const { return 0; }
+   int operator()( transfer_operation& op )const { op.amount.amount = amount; return 1; }
+};
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_CASE( cached_transaction_digests_follow_changes )
+{
+   BOOST_TEST_MESSAGE( "=== cached_transaction_digests_follow_changes ===" );
+
+   fc::ecc::private_key key = fc::ecc::private_key::regenerate( fc::sha256::hash( string( "key" ) ) );
+   fc::ecc::private_key key2 = fc::ecc::private_key::regenerate( fc::sha256::hash( string( "key2" ) ) );
+   const chain_id_type chain_id = db.get_chain_id();
+
+   signed_transaction trx;
+   transfer_operation op;
+   op.amount = asset(100);
+   trx.operations.push_back( op );
+   trx.ref_block_prefix = 1;
+   trx.sign( key, chain_id );
+
+   processed_transaction ptx( trx );
+   ptx.operation_results.push_back( void_result() );
+
+   // compares every cached value with the one computed from scratch
+   auto check_fresh = [&]( const processed_transaction& t )
+   {
+      const signed_transaction plain( t );
+      BOOST_CHECK( t.digest() == plain.digest() );
+      BOOST_CHECK( t.id() == plain.id() );
+      BOOST_CHECK( t.sig_digest( chain_id ) == plain.sig_digest( chain_id ) );
+      BOOST_CHECK( t.get_signature_keys( chain_id ) == plain.get_signature_keys( chain_id ) );
+      BOOST_CHECK( t.packed_transaction() == fc::raw::pack( static_cast<const transaction&>( plain ) ) );
+      BOOST_CHECK( t.merkle_digest() == digest_type::hash( t ) );
+      BOOST_CHECK_EQUAL( t.get_packed_size(), fc::raw::pack_size( t ) );
+   };
+   check_fresh( ptx );
+
+   BOOST_TEST_MESSAGE( "Fields replaced or resized after caching" );
+   transaction_id_type old_id = ptx.id();
+   ptx.operations.push_back( op );
+   check_fresh( ptx );
+   BOOST_CHECK( ptx.id() != old_id );
+
+   old_id = ptx.id();
+   ptx.expiration += 10;
+   check_fresh( ptx );
+   BOOST_CHECK( ptx.id() != old_id );
+
+   ptx.sign( key2, chain_id );
+   check_fresh( ptx );
+   BOOST_CHECK( ptx.get_signature_keys( chain_id ).count( key2.get_public_key() ) == 1 );
+
+   ptx.operation_results.push_back( asset( 5 ) );
+   check_fresh( ptx );
+
+   ptx.clear();
+   check_fresh( ptx );
+   BOOST_CHECK( ptx.get_signature_keys( chain_id ).empty() );
+
+   BOOST_TEST_MESSAGE( "Elements changed in place after caching" );
+   ptx.operations.push_back( op );
+   ptx.sign( key, chain_id );
+   check_fresh( ptx );
+   old_id = ptx.id();
+   ptx.visit( set_transfer_amount{ 200 } );
+   check_fresh( ptx );
+   BOOST_CHECK( ptx.id() != old_id );
+
+   old_id = ptx.id();
+   ptx.operations[0] = op;
+   ptx.invalidate_cache();
+   check_fresh( ptx );
+   BOOST_CHECK( ptx.id() != old_id );
+
+   BOOST_TEST_MESSAGE( "Copies of a cached transaction changed afterwards" );
+   processed_transaction copy( ptx );
+   copy.operations.push_back( op );
+   check_fresh( copy );
+   check_fresh( ptx );
+   BOOST_CHECK( copy.id() != ptx.id() );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -32,6 +32,7 @@
 #include <graphene/chain/committee_member_object.hpp>
 #include <graphene/chain/proposal_object.hpp>
 #include <graphene/chain/market_object.hpp>
+#include <graphene/chain/witness_object.hpp>
 
 #include <graphene/utilities/tempdir.hpp>
 
@@ -1235,6 +1236,214 @@ BOOST_FIXTURE_TEST_CASE( transaction_invalidated_in_cache, database_fixture )
    }
 }
 
+BOOST_FIXTURE_TEST_CASE( pending_transactions_revalidated_incrementally, database_fixture )
+{
+   try
+   {
+      ACTORS( (alice)(bob) );
+
+      auto generate_block = [&]( database& d, uint32_t skip ) -> signed_block
+      {
+         return d.generate_block(d.get_slot_time(1), d.get_scheduled_witness(1), init_account_priv_key, skip);
+      };
+
+      // tx's created by ACTORS() have bogus authority
+      generate_block( db, database::skip_authority_check );
+
+      fc::temp_directory data_dir2( graphene::utilities::temp_directory_path() );
+      database db2;
+      db2.open(data_dir2.path(), make_genesis);
+      while( db2.head_block_num() < db.head_block_num() )
+      {
+         fc::optional< signed_block > b = db.fetch_block_by_number( db2.head_block_num()+1 );
+         db2.push_block(*b, database::skip_witness_signature);
+      }
+
+      transfer( account_id_type(), alice_id, asset( 1000 ) );
+      transfer( account_id_type(),   bob_id, asset( 1000 ) );
+      db2.push_block(generate_block(db, database::skip_authority_check), database::skip_authority_check);
+
+      {
+         BOOST_TEST_MESSAGE( "The head block reports the objects it changed" );
+         const block_id_type previous = db.head_block_id();
+         signed_block b = generate_block( db, database::skip_nothing );
+         PUSH_BLOCK( db2, b );
+         std::unordered_set<object_id_type> changed;
+         BOOST_CHECK( db.get_head_block_changes( previous, changed ) );
+         BOOST_CHECK( changed.count( dynamic_global_property_id_type() ) == 1 );
+         BOOST_CHECK( !db.get_head_block_changes( db.head_block_id(), changed ) );
+      }
+
+      auto generate_xfer_tx = [&]( account_id_type from, account_id_type to, share_type amount,
+                                   const fc::ecc::private_key& key )
+      {
+         signed_transaction tx;
+         transfer_operation xfer_op;
+         xfer_op.from = from;
+         xfer_op.to = to;
+         xfer_op.amount = asset( amount );
+         xfer_op.fee = asset( 0 );
+         tx.operations.push_back( xfer_op );
+         tx.set_expiration( db.head_block_time() + 10 * db.get_global_properties().parameters.block_interval );
+         tx.set_reference_block( db.head_block_id() );
+         sign( tx, key );
+         return tx;
+      };
+
+      BOOST_TEST_MESSAGE( "Pending transactions of alice and bob" );
+      PUSH_TX( db, generate_xfer_tx( alice_id, bob_id, 100, alice_private_key ) );
+      PUSH_TX( db, generate_xfer_tx( bob_id, alice_id, 100, bob_private_key ) );
+      signed_transaction expiring = generate_xfer_tx( bob_id, alice_id, 50, bob_private_key );
+      expiring.set_expiration( db.head_block_time() + db.get_global_properties().parameters.block_interval );
+      expiring.signatures.clear();
+      sign( expiring, bob_private_key );
+      PUSH_TX( db, expiring );
+      BOOST_CHECK_EQUAL( db.get_balance( alice_id, asset_id_type() ).amount.value, 1050 );
+      BOOST_CHECK_EQUAL( db.get_balance(   bob_id, asset_id_type() ).amount.value,  950 );
+
+      BOOST_TEST_MESSAGE( "A block replacing the active key of alice invalidates her pending transaction" );
+      fc::ecc::private_key new_key = generate_private_key( "alice_new" );
+      {
+         signed_transaction tx;
+         account_update_operation op;
+         op.account = alice_id;
+         op.active = authority( 1, public_key_type( new_key.get_public_key() ), 1 );
+         tx.operations.push_back( op );
+         tx.set_expiration( db2.head_block_time() + 10 * db2.get_global_properties().parameters.block_interval );
+         sign( tx, alice_private_key );
+         PUSH_TX( db2, tx );
+      }
+      // the block time is past the expiration of the third transaction
+      signed_block b = db2.generate_block( db2.get_slot_time(2), db2.get_scheduled_witness(2),
+                                           init_account_priv_key, database::skip_nothing );
+      PUSH_BLOCK( db, b );
+      BOOST_CHECK( db.get( alice_id ).active.key_auths.count( public_key_type( new_key.get_public_key() ) ) == 1 );
+
+      // only bob's first transfer is still pending
+      BOOST_CHECK_EQUAL( db.get_balance( alice_id, asset_id_type() ).amount.value, 1100 );
+      BOOST_CHECK_EQUAL( db.get_balance(   bob_id, asset_id_type() ).amount.value,  900 );
+
+      signed_block b2 = generate_block( db, database::skip_nothing );
+      BOOST_REQUIRE_EQUAL( b2.transactions.size(), 1u );
+      BOOST_CHECK( b2.transactions[0].operations[0].get<transfer_operation>().from == bob_id );
+   }
+   catch (fc::exception& e)
+   {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+BOOST_FIXTURE_TEST_CASE( generated_block_applied_in_place, database_fixture )
+{
+   try
+   {
+      ACTORS( (alice)(bob) );
+
+      // tx's created by ACTORS() have bogus authority
+      db.generate_block( db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key,
+                         database::skip_authority_check );
+
+      fc::temp_directory data_dir2( graphene::utilities::temp_directory_path() );
+      database db2;
+      db2.open(data_dir2.path(), make_genesis);
+      while( db2.head_block_num() < db.head_block_num() )
+      {
+         fc::optional< signed_block > b = db.fetch_block_by_number( db2.head_block_num()+1 );
+         db2.push_block(*b, database::skip_witness_signature);
+      }
+
+      transfer( account_id_type(), alice_id, asset( 1000 ) );
+      transfer( account_id_type(),   bob_id, asset( 1000 ) );
+
+      vector< operation_history_object > applied_ops;
+      auto connection = db.applied_block.connect( [&]( const signed_block& ) {
+         for( const optional< operation_history_object >& o : db.get_applied_operations() )
+            if( o.valid() )
+               applied_ops.push_back( *o );
+      });
+
+      signed_block b = db.generate_block( db.get_slot_time(1), db.get_scheduled_witness(1), init_account_priv_key,
+                                          database::skip_nothing );
+      connection.disconnect();
+      BOOST_REQUIRE_EQUAL( b.transactions.size(), 2u );
+      BOOST_CHECK( db.head_block_id() == b.id() );
+      BOOST_CHECK( db.fetch_block_by_number( b.block_num() )->id() == b.id() );
+
+      // the operations reported for the block are exactly the ones of its transactions
+      BOOST_REQUIRE( applied_ops.size() >= 2u );
+      for( const operation_history_object& o : applied_ops )
+      {
+         BOOST_CHECK_EQUAL( o.block_num, b.block_num() );
+         BOOST_CHECK( o.trx_in_block <= 2 );
+      }
+      BOOST_CHECK_EQUAL( applied_ops.front().trx_in_block, 0 );
+
+      // a node applying the block from scratch reaches the same state
+      PUSH_BLOCK( db2, b );
+      BOOST_CHECK( db2.head_block_id() == db.head_block_id() );
+      BOOST_CHECK_EQUAL( db2.get_balance( alice_id, asset_id_type() ).amount.value, 1000 );
+      BOOST_CHECK_EQUAL( db2.get_balance(   bob_id, asset_id_type() ).amount.value, 1000 );
+      BOOST_CHECK_EQUAL( db.get_balance( alice_id, asset_id_type() ).amount.value, 1000 );
+      BOOST_CHECK_EQUAL( db.get_balance(   bob_id, asset_id_type() ).amount.value, 1000 );
+      BOOST_CHECK( db2.get_dynamic_global_properties().next_maintenance_time
+                   == db.get_dynamic_global_properties().next_maintenance_time );
+      BOOST_CHECK_EQUAL( db2.get_dynamic_global_properties().current_aslot,
+                         db.get_dynamic_global_properties().current_aslot );
+
+      // the block is undoable like any other
+      db.pop_block();
+      BOOST_CHECK_EQUAL( db.get_balance( alice_id, asset_id_type() ).amount.value, 0 );
+      PUSH_BLOCK( db, b );
+      BOOST_CHECK_EQUAL( db.get_balance( alice_id, asset_id_type() ).amount.value, 1000 );
+   }
+   catch (fc::exception& e)
+   {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
+BOOST_FIXTURE_TEST_CASE( generated_block_updates_own_signing_key, database_fixture )
+{
+   try
+   {
+      generate_block();
+
+      const witness_id_type producer = db.get_scheduled_witness( 1 );
+      const account_id_type producer_account = producer( db ).witness_account;
+      const fc::ecc::private_key new_signing_key = generate_private_key( "new_signing_key" );
+
+      witness_update_operation op;
+      op.witness = producer;
+      op.witness_account = producer_account;
+      op.new_signing_key = public_key_type( new_signing_key.get_public_key() );
+      trx.operations.push_back( op );
+      set_expiration( db, trx );
+      PUSH_TX( db, trx, ~0 );
+      trx.clear();
+
+      // the block is signed with the key the witness had before its own update
+      signed_block b = db.generate_block( db.get_slot_time(1), producer, init_account_priv_key,
+                                          database::skip_authority_check );
+      BOOST_REQUIRE_EQUAL( b.transactions.size(), 1u );
+      BOOST_CHECK( db.head_block_id() == b.id() );
+      BOOST_CHECK( producer( db ).signing_key == public_key_type( new_signing_key.get_public_key() ) );
+
+      // a node replaying the block accepts it as well
+      db.pop_block();
+      BOOST_CHECK( producer( db ).signing_key == public_key_type( init_account_priv_key.get_public_key() ) );
+      PUSH_BLOCK( db, b, database::skip_authority_check );
+      BOOST_CHECK( db.head_block_id() == b.id() );
+      BOOST_CHECK( producer( db ).signing_key == public_key_type( new_signing_key.get_public_key() ) );
+   }
+   catch (fc::exception& e)
+   {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
 BOOST_AUTO_TEST_CASE( genesis_reserve_ids )
 {
    try
@@ -28,6 +28,10 @@
 
 #include <graphene/chain/account_object.hpp>
 
+#include <graphene/app/api_reader_pool.hpp>
+#include <graphene/app/api_response_cache.hpp>
+#include <graphene/app/database_api.hpp>
+
 #include <fc/crypto/digest.hpp>
 
 #include "../common/database_fixture.hpp"
@@ -62,3 +66,393 @@ BOOST_AUTO_TEST_CASE( undo_test )
       throw;
    }
 }
+
+BOOST_FIXTURE_TEST_CASE( user_count_with_balances, database_fixture )
+{
+   try {
+      create_edc();
+      ACTORS( (alice)(bob)(carol) );
+
+      graphene::app::database_api db_api( db );
+      const auto& bal_idx = dynamic_cast<const primary_index<account_balance_index>&>(
+         db.get_index_type<account_balance_index>() );
+      const auto& holders = bal_idx.get_secondary_index<account_balance_holders_index>();
+      BOOST_CHECK_EQUAL( holders.holders_count( EDC_ASSET ), 0u );
+      BOOST_CHECK_EQUAL( db_api.get_user_count_with_balances(), 0 );
+
+      db.adjust_balance( alice_id, asset( 1000, EDC_ASSET ) );
+      db.adjust_balance( bob_id, asset( 1000, EDC_ASSET ) );
+      BOOST_CHECK_EQUAL( db_api.get_user_count_with_balances(), 2 );
+
+      db.adjust_balance( alice_id, asset( -1000, EDC_ASSET ) );
+      db.adjust_balance( bob_id, asset( -400, EDC_ASSET ) );
+      BOOST_CHECK_EQUAL( db_api.get_user_count_with_balances(), 1 );
+
+      BOOST_TEST_MESSAGE( "Undoing a change restores the count" );
+      {
+         auto session = db._undo_db.start_undo_session();
+         db.adjust_balance( carol_id, asset( 5, EDC_ASSET ) );
+         BOOST_CHECK_EQUAL( holders.holders_count( EDC_ASSET ), 2u );
+      }
+      BOOST_CHECK_EQUAL( holders.holders_count( EDC_ASSET ), 1u );
+
+      BOOST_TEST_MESSAGE( "Date ranges count the accounts registered within them" );
+      generate_blocks( 10 );
+      const fc::time_point_sec registered = db.head_block_time();
+      ACTOR( dave );
+      db.adjust_balance( dave_id, asset( 1, EDC_ASSET ) );
+      BOOST_CHECK( dave_id(db).register_datetime == registered );
+
+      BOOST_CHECK_EQUAL( db_api.get_user_count_with_balances(), 2 );
+      BOOST_CHECK_EQUAL( db_api.get_user_count_with_balances( { registered, registered + 86400 } ), 1 );
+      BOOST_CHECK_EQUAL( db_api.get_user_count_with_balances( { registered - 1, fc::time_point_sec( 1 ) } ), 1 );
+      BOOST_CHECK_EQUAL( db_api.get_user_count_with_balances( { registered + 1, registered + 86400 } ), 0 );
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE( object_changes_follow_subscriptions, database_fixture )
+{
+   try {
+      ACTORS( (alice)(bob)(carol) );
+      generate_block();
+
+      auto collect = []( vector<object_id_type>& ids ) {
+         return [&ids]( const variant& updates ) {
+            for( const variant& update : updates.get_array() )
+               ids.push_back( update.is_object() ? update["id"].as<object_id_type>( 1 )
+                                                 : update.as<object_id_type>( 1 ) );
+         };
+      };
+
+      vector<object_id_type> alice_updates, bob_updates, carol_updates;
+      graphene::app::database_api alice_api( db ), bob_api( db ), carol_api( db );
+      alice_api.set_subscribe_callback( collect( alice_updates ), true );
+      bob_api.set_subscribe_callback( collect( bob_updates ), true );
+      carol_api.set_subscribe_callback( collect( carol_updates ), true );
+      alice_api.get_accounts( { alice_id } );
+      bob_api.get_accounts( { bob_id } );
+
+      transfer( committee_account, alice_id, asset( 1000 ) );
+      generate_block();
+      fc::usleep( fc::milliseconds( 100 ) );
+
+      const auto& bal_idx = db.get_index_type<account_balance_index>().indices().get<by_account_asset>();
+      const object_id_type alice_balance = bal_idx.find( boost::make_tuple( alice_id, asset_id_type() ) )->id;
+      auto received = []( const vector<object_id_type>& ids, object_id_type id ) {
+         return std::find( ids.begin(), ids.end(), id ) != ids.end();
+      };
+
+      BOOST_TEST_MESSAGE( "Objects relevant to a subscribed account are delivered" );
+      BOOST_CHECK( received( alice_updates, alice_balance ) );
+
+      BOOST_TEST_MESSAGE( "Sessions that did not subscribe to the account do not receive its objects" );
+      BOOST_CHECK( !received( bob_updates, alice_balance ) );
+      BOOST_CHECK( carol_updates.empty() );
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE( subscription_queue_coalesces_and_overflows, database_fixture )
+{
+   try {
+      ACTORS( (alice) );
+      generate_block();
+
+      vector<object_id_type> received;
+      graphene::app::database_api alice_api( db );
+      alice_api.set_subscribe_callback( [&received]( const variant& updates ) {
+         for( const variant& update : updates.get_array() )
+            received.push_back( update["id"].as<object_id_type>( 1 ) );
+      }, true );
+      alice_api.get_accounts( { alice_id } );
+
+      graphene::app::subscription_queue_limits limits;
+      limits.max_updates = 1;
+      limits.cancel_on_overflow = true;
+      uint32_t slow_calls = 0;
+      graphene::app::database_api slow_api( db, limits );
+      slow_api.set_subscribe_callback( [&slow_calls]( const variant& ) { ++slow_calls; }, true );
+      slow_api.get_accounts( { alice_id } );
+
+      graphene::app::subscription_queue_limits byte_limits;
+      byte_limits.max_bytes = 1;
+      uint32_t large_calls = 0;
+      graphene::app::database_api large_api( db, byte_limits );
+      large_api.set_subscribe_callback( [&large_calls]( const variant& ) { ++large_calls; }, true );
+      large_api.get_accounts( { alice_id } );
+
+      // the connection of this session does not send anything until unsent goes back to 0
+      graphene::app::subscription_queue_limits stall_limits;
+      stall_limits.max_transport_bytes = 1000;
+      stall_limits.max_bytes = 1000000;
+      uint64_t unsent = 2000;
+      vector<object_id_type> stalled_received;
+      graphene::app::database_api stalled_api( db, stall_limits, [&unsent]() { return unsent; } );
+      stalled_api.set_subscribe_callback( [&stalled_received]( const variant& updates ) {
+         for( const variant& update : updates.get_array() )
+            stalled_received.push_back( update["id"].as<object_id_type>( 1 ) );
+      }, true );
+      stalled_api.get_accounts( { alice_id } );
+
+      // nothing is delivered between the blocks, the second state of every object replaces the first one
+      transfer( committee_account, alice_id, asset( 1000 ) );
+      generate_block();
+      transfer( committee_account, alice_id, asset( 1000 ) );
+      generate_block();
+
+      const auto info = alice_api.get_subscription_queue_info();
+      BOOST_CHECK( info.coalesced_updates > 0 );
+      BOOST_CHECK( info.queued_bytes > 0 );
+      BOOST_CHECK_EQUAL( info.dropped_updates, 0u );
+
+      BOOST_TEST_MESSAGE( "A session over its limits loses its queued updates and its subscriptions" );
+      const auto slow_info = slow_api.get_subscription_queue_info();
+      BOOST_CHECK( slow_info.overflows > 0 );
+      BOOST_CHECK( slow_info.dropped_updates > 0 );
+
+      fc::usleep( fc::milliseconds( 100 ) );
+      BOOST_CHECK_EQUAL( received.size(), info.queued_updates );
+      BOOST_CHECK( std::set<object_id_type>( received.begin(), received.end() ).size() == received.size() );
+      BOOST_CHECK_EQUAL( alice_api.get_subscription_queue_info().queued_updates, 0u );
+      BOOST_CHECK_EQUAL( slow_calls, 0u );
+
+      BOOST_TEST_MESSAGE( "The byte limit is enforced without the update limit" );
+      const auto large_info = large_api.get_subscription_queue_info();
+      BOOST_CHECK( large_info.overflows > 0 );
+      BOOST_CHECK( large_info.dropped_updates > 0 );
+      BOOST_CHECK_EQUAL( large_calls, 0u );
+
+      BOOST_TEST_MESSAGE( "Nothing is handed to a connection that is not sending, the queue keeps coalescing" );
+      auto stalled_info = stalled_api.get_subscription_queue_info();
+      BOOST_CHECK( stalled_received.empty() );
+      BOOST_CHECK( stalled_info.deferred_flushes > 0 );
+      BOOST_CHECK( stalled_info.queued_updates > 0 );
+      BOOST_CHECK( stalled_info.coalesced_updates > 0 );
+      BOOST_CHECK_EQUAL( stalled_info.transport_bytes, unsent );
+      BOOST_CHECK_EQUAL( stalled_info.overflows, 0u );
+
+      BOOST_TEST_MESSAGE( "The queue is delivered once the connection catches up" );
+      unsent = 0;
+      fc::usleep( fc::milliseconds( 250 ) );
+      BOOST_CHECK_EQUAL( stalled_received.size(), stalled_info.queued_updates );
+      BOOST_CHECK_EQUAL( stalled_api.get_subscription_queue_info().queued_updates, 0u );
+
+      BOOST_TEST_MESSAGE( "The bytes the connection has not sent count against the byte limit" );
+      unsent = stall_limits.max_bytes;
+      transfer( committee_account, alice_id, asset( 1000 ) );
+      generate_block();
+      stalled_info = stalled_api.get_subscription_queue_info();
+      BOOST_CHECK( stalled_info.overflows > 0 );
+      BOOST_CHECK( stalled_info.dropped_updates > 0 );
+      BOOST_CHECK_EQUAL( stalled_info.queued_updates, 0u );
+      // let the deferred flush finish while unsent still exists
+      unsent = 0;
+      fc::usleep( fc::milliseconds( 250 ) );
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE( read_only_calls_run_on_reader_pool, database_fixture )
+{
+   try {
+      ACTORS( (alice)(bob) );
+      transfer( committee_account, alice_id, asset( 1000 ) );
+      generate_block();
+
+      graphene::app::database_api inline_api( db );
+      const auto expected = fc::json::to_string( inline_api.get_full_accounts( { "alice", "bob" }, false ) );
+
+      auto pool = std::make_shared<graphene::app::api_reader_pool>( db, 2 );
+      graphene::app::database_api api( db, graphene::app::subscription_queue_limits(),
+                                       graphene::app::transport_backlog_reader(), pool );
+
+      BOOST_TEST_MESSAGE( "The calls run on a reader thread and give the same results" );
+      bool on_reader = false;
+      graphene::app::read_only( pool, [&]() { on_reader = pool->is_reader_thread(); } );
+      BOOST_CHECK( on_reader );
+      graphene::app::read_only( nullptr, [&]() { on_reader = pool->is_reader_thread(); } );
+      BOOST_CHECK( !on_reader );
+      BOOST_CHECK_EQUAL( fc::json::to_string( api.get_full_accounts( { "alice", "bob" }, false ) ), expected );
+      BOOST_CHECK_EQUAL( api.get_account_balances( alice_id, {} ).front().amount.value, 1000 );
+
+      BOOST_TEST_MESSAGE( "Subscriptions made by calls on the pool are added on this thread" );
+      vector<object_id_type> received;
+      api.set_subscribe_callback( [&received]( const variant& updates ) {
+         for( const variant& update : updates.get_array() )
+            received.push_back( update["id"].as<object_id_type>( 1 ) );
+      }, true );
+      api.get_full_accounts( { "bob" }, true );
+
+      BOOST_TEST_MESSAGE( "Blocks are still applied while calls run on the pool" );
+      transfer( alice_id, bob_id, asset( 400 ) );
+      generate_block();
+      BOOST_CHECK_EQUAL( api.get_account_balances( bob_id, {} ).front().amount.value, 400 );
+      fc::usleep( fc::milliseconds( 100 ) );
+      BOOST_CHECK( std::find( received.begin(), received.end(), object_id_type( bob_id ) ) != received.end() );
+
+      BOOST_TEST_MESSAGE( "Exceptions reach the caller" );
+      GRAPHENE_REQUIRE_THROW( api.get_referrals( "nobody" ), fc::exception );
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE( state_lock_is_held_by_fibers )
+{
+   try {
+      graphene::chain::reader_writer_lock lock;
+      vector<int> order;
+
+      BOOST_TEST_MESSAGE( "Another fiber of the thread waits for the write lock instead of taking it again" );
+      auto first = fc::async( [&]() {
+         std::unique_lock<graphene::chain::reader_writer_lock> guard( lock );
+         order.push_back( 1 );
+         // the holding fiber may take it again
+         std::unique_lock<graphene::chain::reader_writer_lock> nested( lock );
+         fc::usleep( fc::milliseconds( 50 ) );
+         order.push_back( 2 );
+      } );
+      fc::yield();
+      auto second = fc::async( [&]() {
+         std::unique_lock<graphene::chain::reader_writer_lock> guard( lock );
+         order.push_back( 3 );
+      } );
+
+      BOOST_TEST_MESSAGE( "The thread keeps running its other fibers meanwhile" );
+      bool ran = false;
+      fc::async( [&]() { ran = true; } ).wait();
+      BOOST_CHECK( ran );
+
+      first.wait();
+      second.wait();
+      BOOST_CHECK( order == vector<int>( { 1, 2, 3 } ) );
+
+      BOOST_TEST_MESSAGE( "A writer waits for the readers of other threads" );
+      fc::thread reader( "state reader" );
+      std::atomic<bool> reading{false};
+      auto read = reader.async( [&]() {
+         std::shared_lock<graphene::chain::reader_writer_lock> guard( lock );
+         reading = true;
+         fc::usleep( fc::milliseconds( 50 ) );
+         reading = false;
+      } );
+      while( !reading )
+         fc::usleep( fc::milliseconds( 1 ) );
+      {
+         std::unique_lock<graphene::chain::reader_writer_lock> guard( lock );
+         BOOST_CHECK( !reading );
+      }
+      read.wait();
+      reader.quit();
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE( response_cache_hits_until_state_changes, database_fixture )
+{
+   try {
+      ACTORS( (alice)(bob) );
+      transfer( committee_account, alice_id, asset( 1000 ) );
+      generate_block();
+
+      graphene::app::database_api api( db );
+      BOOST_CHECK( !api.get_response_cache_info().enabled );
+      graphene::app::api_response_cache::install( std::make_shared<graphene::app::api_response_cache>( db, 100 ) );
+
+      BOOST_TEST_MESSAGE( "Identical calls are answered from the cache" );
+      graphene::app::database_api other_api( db );
+      BOOST_CHECK_EQUAL( api.get_account_balances( alice_id, {} ).front().amount.value, 1000 );
+      BOOST_CHECK_EQUAL( other_api.get_account_balances( alice_id, {} ).front().amount.value, 1000 );
+      BOOST_CHECK_EQUAL( api.get_account_balances( bob_id, {} ).size(), 0u );
+      auto info = api.get_response_cache_info();
+      BOOST_CHECK( info.enabled );
+      BOOST_CHECK_EQUAL( info.hits, 1u );
+      BOOST_CHECK_EQUAL( info.misses, 2u );
+      BOOST_CHECK_EQUAL( info.entries, 2u );
+
+      BOOST_TEST_MESSAGE( "A pending transaction drops the cached results" );
+      transfer( alice_id, bob_id, asset( 400 ) );
+      BOOST_CHECK_EQUAL( api.get_account_balances( alice_id, {} ).front().amount.value, 600 );
+      info = api.get_response_cache_info();
+      BOOST_CHECK_EQUAL( info.hits, 1u );
+      BOOST_CHECK_EQUAL( info.invalidations, 1u );
+
+      BOOST_TEST_MESSAGE( "So does a new block" );
+      const auto head = api.get_dynamic_global_properties().head_block_number;
+      generate_block();
+      BOOST_CHECK_EQUAL( api.get_dynamic_global_properties().head_block_number, head + 1 );
+      BOOST_CHECK_EQUAL( api.get_response_cache_info().hits, 1u );
+
+      BOOST_TEST_MESSAGE( "And popping it" );
+      db.pop_block();
+      BOOST_CHECK_EQUAL( api.get_dynamic_global_properties().head_block_number, head );
+
+      graphene::app::api_response_cache::uninstall( db );
+      BOOST_CHECK( !api.get_response_cache_info().enabled );
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_FIXTURE_TEST_CASE( asset_balances_in_columns, database_fixture )
+{
+   try {
+      create_edc();
+      ACTORS( (alice)(bob)(carol)(dave) );
+
+      db.adjust_balance( alice_id, asset( 100, EDC_ASSET ) );
+      db.adjust_balance( carol_id, asset( 300, EDC_ASSET ) );
+      db.adjust_balance( dave_id, asset( 400, EDC_ASSET ) );
+      db.adjust_balance( bob_id, asset( 7 ) );
+
+      // before HARDFORK_622_TIME every new EDC balance also gets a mature one
+      const auto& mature_idx = db.get_index_type<account_mature_balance_index>().indices().get<by_account_asset>();
+      auto carol_mature = mature_idx.find( boost::make_tuple( carol_id, EDC_ASSET ) );
+      BOOST_REQUIRE( carol_mature != mature_idx.end() );
+      BOOST_REQUIRE_GT( carol_mature->balance.value, 0 );
+      const share_type carol_mature_balance = carol_mature->balance;
+
+      // record a fund deposit the way fund_deposit_evaluator does
+      db.modify( carol, [&]( account_object& a ) {
+         dep_info inf;
+         inf.fund_id = fund_id_type();
+         inf.sum = asset( 50, EDC_ASSET );
+         inf.nearest_deposit_dt = db.head_block_time() + fc::days( 5 );
+         a.deposits_info.emplace( inf.fund_id, std::move( inf ) );
+      });
+
+      graphene::app::database_api api( db );
+
+      BOOST_TEST_MESSAGE( "Holders of the asset come in the order of their IDs" );
+      auto page = api.get_asset_balances( EDC_ASSET, alice_id, 2 );
+      BOOST_CHECK( page.asset_id == EDC_ASSET );
+      BOOST_REQUIRE_EQUAL( page.accounts.size(), 2u );
+      BOOST_REQUIRE_EQUAL( page.balances.size(), 2u );
+      BOOST_REQUIRE_EQUAL( page.mature_balances.size(), 2u );
+      BOOST_REQUIRE_EQUAL( page.deposits.size(), 2u );
+      BOOST_CHECK_EQUAL( page.accounts[0], alice_id.instance.value );
+      BOOST_CHECK_EQUAL( page.accounts[1], carol_id.instance.value );
+      BOOST_CHECK_EQUAL( page.balances[0].value, 100 );
+      BOOST_CHECK_EQUAL( page.balances[1].value, 300 );
+      BOOST_CHECK_EQUAL( page.mature_balances[1].value, carol_mature_balance.value );
+      BOOST_CHECK_EQUAL( page.deposits[0].value, 0 );
+      BOOST_CHECK_EQUAL( page.deposits[1].value, 50 );
+      BOOST_REQUIRE( page.next.valid() );
+      BOOST_CHECK( *page.next == dave_id );
+
+      page = api.get_asset_balances( EDC_ASSET, *page.next, 2 );
+      BOOST_REQUIRE_EQUAL( page.accounts.size(), 1u );
+      BOOST_CHECK_EQUAL( page.accounts[0], dave_id.instance.value );
+      BOOST_CHECK_EQUAL( page.balances[0].value, 400 );
+      BOOST_CHECK( !page.next.valid() );
+
+      BOOST_TEST_MESSAGE( "A list of accounts keeps its order and reports missing balances as 0" );
+      auto list = api.get_asset_balances_of( EDC_ASSET, { dave_id, bob_id, alice_id, carol_id } );
+      BOOST_REQUIRE_EQUAL( list.accounts.size(), 4u );
+      BOOST_REQUIRE_EQUAL( list.mature_balances.size(), 4u );
+      BOOST_REQUIRE_EQUAL( list.deposits.size(), 4u );
+      BOOST_CHECK_EQUAL( list.accounts[1], bob_id.instance.value );
+      BOOST_CHECK_EQUAL( list.balances[0].value, 400 );
+      BOOST_CHECK_EQUAL( list.balances[1].value, 0 );
+      BOOST_CHECK_EQUAL( list.balances[2].value, 100 );
+      BOOST_CHECK_EQUAL( list.mature_balances[1].value, 0 );
+      BOOST_CHECK_EQUAL( list.deposits[1].value, 0 );
+      BOOST_CHECK_EQUAL( list.mature_balances[3].value, carol_mature_balance.value );
+      BOOST_CHECK_EQUAL( list.deposits[3].value, 50 );
+
+      GRAPHENE_REQUIRE_THROW( api.get_asset_balances( EDC_ASSET, account_id_type(), 10001 ), fc::exception );
+   } FC_LOG_AND_RETHROW()
+}
@@ -1,6 +1,7 @@
 #include <boost/test/unit_test.hpp>
 #include "../common/database_fixture.hpp"
 
+#include <graphene/app/api.hpp>
 #include <graphene/chain/fund_object.hpp>
 #include <graphene/chain/hardfork.hpp>
 
@@ -421,11 +422,13 @@ BOOST_AUTO_TEST_CASE( fund_make_payments_test )
       generate_blocks(db.get_dynamic_global_properties().next_maintenance_time);
 
       // history
-      BOOST_CHECK(fund.history_id(db).items.size() == 1);
-      BOOST_CHECK(fund.history_id(db).items[0].create_datetime.sec_since_epoch() == db.head_block_time().sec_since_epoch());
-      BOOST_CHECK(fund.history_id(db).items[0].daily_payments_total.value == 200);
-      BOOST_CHECK(fund.history_id(db).items[0].daily_payments_without_owner.value == 40);
-      BOOST_CHECK(fund.history_id(db).items[0].daily_payments_owner.value == 160);
+      const auto& hist_idx = db.get_index_type<fund_history_item_index>().indices().get<by_fund_datetime>();
+      BOOST_CHECK(hist_idx.count(fund.get_id()) == 1);
+      const fund_history_item_object& h_item = *hist_idx.lower_bound(fund.get_id());
+      BOOST_CHECK(h_item.create_datetime.sec_since_epoch() == db.head_block_time().sec_since_epoch());
+      BOOST_CHECK(h_item.daily_payments_total.value == 200);
+      BOOST_CHECK(h_item.daily_payments_without_owner.value == 40);
+      BOOST_CHECK(h_item.daily_payments_owner.value == 160);
 
       // std::cout << "========= 1 alice's balance: " << get_balance(alice_id, EDC_ASSET) << std::endl;
       // std::cout << "========= 1 bob's balance: " << get_balance(bob_id, EDC_ASSET) << std::endl;
@@ -451,7 +454,7 @@ BOOST_AUTO_TEST_CASE( fund_make_payments_test )
       }
 
       // history
-      BOOST_CHECK(fund.history_id(db).items.size() == 50);
+      BOOST_CHECK(hist_idx.count(fund.get_id()) == 50);
 
       // std::cout << "========= 2 alice's balance: " << get_balance(alice_id, EDC_ASSET) << std::endl;
       // std::cout << "========= 2 bob's balance: " << get_balance(bob_id, EDC_ASSET) << std::endl;
@@ -582,6 +585,44 @@ BOOST_AUTO_TEST_CASE( fund_make_payments_test )
       BOOST_CHECK(get_balance(bob_id, EDC_ASSET) == 240);
       BOOST_CHECK(get_balance(alice_id, EDC_ASSET) == 6827);
 
+      // history: newest items first
+      graphene::app::history_api hist_api(app);
+      auto payments = hist_api.get_fund_payments_history(fund.get_id(), 0, 2);
+      BOOST_REQUIRE(payments.size() == 2);
+      BOOST_CHECK(payments[0].create_datetime > payments[1].create_datetime);
+      BOOST_CHECK(payments[0].create_datetime == std::prev(hist_idx.upper_bound(fund.get_id()))->create_datetime);
+      auto skipped = hist_api.get_fund_payments_history(fund.get_id(), 1, 1);
+      BOOST_REQUIRE(skipped.size() == 1);
+      BOOST_CHECK(skipped[0].create_datetime == payments[1].create_datetime);
+
+      // history: cursor pages resume before the last item returned
+      auto newest = hist_api.list_fund_payments_history(fund.get_id(), fc::time_point(), 1);
+      BOOST_REQUIRE(newest.size() == 1);
+      BOOST_CHECK(newest[0].create_datetime == payments[0].create_datetime);
+      auto next_page = hist_api.list_fund_payments_history(fund.get_id(), newest[0].create_datetime, 1);
+      BOOST_REQUIRE(next_page.size() == 1);
+      BOOST_CHECK(next_page[0].create_datetime == payments[1].create_datetime);
+      vector<fund_history_object::history_item> paged;
+      fc::time_point before;
+      for (;;) {
+         auto page = hist_api.list_fund_payments_history(fund.get_id(), before, 3);
+         if (page.empty()) break;
+         paged.insert(paged.end(), page.begin(), page.end());
+         before = page.back().create_datetime;
+      }
+      BOOST_CHECK(paged.size() == hist_idx.count(fund.get_id()));
+      BOOST_CHECK(paged.back().create_datetime == hist_idx.lower_bound(fund.get_id())->create_datetime);
+
+      // history: old items are pruned by history size
+      db.set_history_size(10);
+      h_time = db.head_block_time() + fc::days(1);
+      while (db.head_block_time() < h_time) {
+         generate_block();
+      }
+      BOOST_CHECK(hist_idx.count(fund.get_id()) > 0);
+      BOOST_CHECK(hist_idx.count(fund.get_id()) <= 11);
+      BOOST_CHECK(hist_idx.lower_bound(fund.get_id())->create_datetime >= db.head_block_time() - fc::days(10));
+
    } FC_LOG_AND_RETHROW()
 }
 
@@ -1008,4 +1049,100 @@ BOOST_AUTO_TEST_CASE( funds_payments_limit_test )
    } FC_LOG_AND_RETHROW()
 }
 
+BOOST_AUTO_TEST_CASE( fund_deposit_pages_follow_ids )
+{
+   try
+   {
+      BOOST_TEST_MESSAGE( "=== fund_deposit_pages_follow_ids ===" );
+
+      ACTOR(abcde1); // for needed IDs
+      ACTOR(abcde2);
+      ACTOR(alice);
+      ACTOR(bob);
+
+      SET_ACTOR_CAN_CREATE_ASSET(alice_id);
+      create_edc();
+      issue_uia(alice_id, asset(10000000, EDC_ASSET));
+      issue_uia(bob_id, asset(10000000, EDC_ASSET));
+
+      fund_options::fund_rate fr;
+      fr.amount = 10000;
+      fr.day_percent = 1000;
+      fund_options::payment_rate pr;
+      pr.period = 50;
+      pr.percent = 20000;
+      fund_options::payment_rate pr2;
+      pr2.period = 100;
+      pr2.percent = 20000;
+
+      fund_options options;
+      options.description = "FUND DESCRIPTION";
+      options.period = 100;
+      options.min_deposit = 10000;
+      options.rates_reduction_per_month = 300;
+      options.fund_rates.push_back(std::move(fr));
+      options.payment_rates.push_back(std::move(pr));
+      options.payment_rates.push_back(std::move(pr2));
+      make_fund("TESTFUND", options, alice_id);
+      const fund_object& fund = *db.get_index_type<fund_index>().indices().get<by_name>().find("TESTFUND");
+
+      auto deposit = [&]( account_id_type from, uint32_t period ) {
+         fund_deposit_operation fdo;
+         fdo.amount = 10000;
+         fdo.fee = asset();
+         fdo.from_account = from;
+         fdo.period = period;
+         fdo.fund_id = fund.id;
+         set_expiration(db, trx);
+         trx.operations.push_back(std::move(fdo));
+         PUSH_TX(db, trx, ~0);
+         trx.clear();
+      };
+      for( int i = 0; i < 5; ++i )
+      {
+         deposit( alice_id, i % 2 ? 100 : 50 );
+         deposit( bob_id, 50 );
+      }
+      generate_block();
+
+      graphene::app::database_api api(db);
+
+      BOOST_TEST_MESSAGE( "Pages of the fund deposits cover all of them from the newest one" );
+      const vector<fund_deposit_object> all = api.get_fund_deposits("TESTFUND", 0, 100);
+      BOOST_REQUIRE_EQUAL( all.size(), 10u );
+      vector<fund_deposit_object> paged;
+      fund_deposit_id_type start;
+      while( true )
+      {
+         const auto page = api.list_fund_deposits("TESTFUND", start, 3);
+         paged.insert( paged.end(), page.begin(), page.end() );
+         if( page.size() < 3 || page.back().id.instance() == 0 )
+            break;
+         start = fund_deposit_id_type( page.back().id.instance() - 1 );
+      }
+      BOOST_REQUIRE_EQUAL( paged.size(), all.size() );
+      for( size_t i = 0; i < all.size(); ++i )
+         BOOST_CHECK( paged[i].id == all[i].id );
+
+      BOOST_TEST_MESSAGE( "Account deposits are paged from the newest one" );
+      auto alice_page = api.list_account_deposits(alice_id, fund_deposit_id_type(), 2);
+      BOOST_REQUIRE_EQUAL( alice_page.size(), 2u );
+      BOOST_CHECK( alice_page[1].id < alice_page[0].id );
+      alice_page = api.list_account_deposits(alice_id, fund_deposit_id_type( alice_page[1].id.instance() - 1 ), 100);
+      BOOST_CHECK_EQUAL( alice_page.size(), 3u );
+      for( const auto& d: alice_page )
+         BOOST_CHECK( d.account_id == alice_id );
+
+      BOOST_TEST_MESSAGE( "Deposits of a period are paged from the oldest one" );
+      auto period_page = api.list_fund_deposits_by_period(50, fund_deposit_id_type(), 4);
+      BOOST_REQUIRE_EQUAL( period_page.size(), 4u );
+      period_page = api.list_fund_deposits_by_period(50, fund_deposit_id_type( period_page.back().id.instance() + 1 ), 100);
+      BOOST_CHECK_EQUAL( period_page.size(), 4u );
+      for( const auto& d: period_page )
+         BOOST_CHECK_EQUAL( d.period, 50u );
+      BOOST_CHECK_EQUAL( api.list_fund_deposits_by_period(100, fund_deposit_id_type(), 100).size(), 2u );
+
+   } FC_LOG_AND_RETHROW()
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
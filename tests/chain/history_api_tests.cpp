@@ -0,0 +1,640 @@
+/*
+ * Copyright (c) 2015 Cryptonomex, Inc., and contributors.
+ *
+ * The MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <graphene/app/api.hpp>
+#include <graphene/chain/hardfork.hpp>
+#include <graphene/chain/operation_history_object.hpp>
+#include <graphene/history/history_export.hpp>
+#include <graphene/history/history_plugin.hpp>
+#include <graphene/utilities/tempdir.hpp>
+
+#include <fc/io/json.hpp>
+#include <fc/io/raw.hpp>
+
+#include <sstream>
+
+#include "../common/database_fixture.hpp"
+
+using namespace graphene::chain;
+using namespace graphene::chain::test;
+using namespace graphene::app;
+
+BOOST_FIXTURE_TEST_SUITE( history_api_tests, database_fixture )
+
+BOOST_AUTO_TEST_CASE( account_history_paging )
+{
+   try {
+      ACTORS( (alice)(bob) );
+      fund( alice );
+      generate_block();
+
+      for( int i = 0; i < 25; ++i )
+      {
+         transfer( alice_id, bob_id, asset( 10 + i ) );
+         if( i % 5 == 4 )
+            generate_block();
+      }
+      generate_block();
+
+      history_api hist_api( app );
+      const vector<operation_history_object> full = get_operation_history( alice_id );
+      BOOST_REQUIRE( full.size() > 25 );
+
+      BOOST_TEST_MESSAGE( "Paging by operation id matches the linked list" );
+      vector<operation_history_object> paged;
+      operation_history_id_type start;
+      while( true )
+      {
+         vector<operation_history_object> page = hist_api.get_account_history( alice_id, operation_history_id_type(), 7, start );
+         if( page.empty() )
+            break;
+         BOOST_REQUIRE( page.size() <= 7 );
+         paged.insert( paged.end(), page.begin(), page.end() );
+         if( page.back().id.instance() == 0 )
+            break;
+         start = operation_history_id_type( page.back().id.instance() - 1 );
+      }
+      BOOST_REQUIRE_EQUAL( paged.size(), full.size() );
+      for( size_t i = 0; i < full.size(); ++i )
+         BOOST_CHECK( paged[i].id == full[i].id );
+
+      BOOST_TEST_MESSAGE( "Start and stop bound the result" );
+      const operation_history_id_type mid = full[10].id;
+      const operation_history_id_type low = full[20].id;
+      vector<operation_history_object> bounded = hist_api.get_account_history( alice_id, low, 100, mid );
+      BOOST_REQUIRE_EQUAL( bounded.size(), 10u );
+      BOOST_CHECK( bounded.front().id == mid );
+      BOOST_CHECK( bounded.back().id == full[19].id );
+
+      BOOST_TEST_MESSAGE( "Sequence based pages continue where the previous one stopped" );
+      paged.clear();
+      uint32_t next = 0;
+      do
+      {
+         account_history_page page = hist_api.get_account_history_page( alice_id, next, 6 );
+         BOOST_REQUIRE( page.operations.size() <= 6 );
+         paged.insert( paged.end(), page.operations.begin(), page.operations.end() );
+         next = page.next_start;
+      } while( next != 0 );
+      BOOST_REQUIRE_EQUAL( paged.size(), full.size() );
+      for( size_t i = 0; i < full.size(); ++i )
+         BOOST_CHECK( paged[i].id == full[i].id );
+
+      const vector<uint16_t> transfer_type = { operation::tag<transfer_operation>::value };
+      size_t transfers = 0;
+      next = 0;
+      do
+      {
+         account_history_page page = hist_api.get_account_history_page( alice_id, next, 4, transfer_type );
+         for( const operation_history_object& o : page.operations )
+            BOOST_CHECK_EQUAL( o.op.which(), operation::tag<transfer_operation>::value );
+         transfers += page.operations.size();
+         next = page.next_start;
+      } while( next != 0 );
+      BOOST_CHECK( transfers >= 25 );
+
+      BOOST_TEST_MESSAGE( "Accounts without history return nothing" );
+      const account_object& carol = create_account( "carol" );
+      BOOST_CHECK( hist_api.get_account_history_page( carol.id, 0, 10 ).operations.empty() );
+      BOOST_CHECK( hist_api.listtransactions( carol.id, {}, 10 ).empty() );
+      BOOST_CHECK_EQUAL( hist_api.listtransactions( alice_id, {}, 10 ).size(), 10u );
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE( typed_account_history )
+{
+   try {
+      ACTORS( (alice)(bob) );
+      fund( alice, asset( 30000000 ) );
+      upgrade_to_lifetime_member( alice_id );
+      generate_block();
+
+      for( int i = 0; i < 12; ++i )
+      {
+         transfer( alice_id, bob_id, asset( 10 + i ) );
+         if( i % 4 == 3 )
+         {
+            const string name = "alicechild" + string( 1, char( 'a' + i / 4 ) );
+            create_account( name, alice_id(db), alice_id(db), 80, generate_private_key( name ).get_public_key() );
+            generate_block();
+         }
+      }
+      generate_block();
+
+      history_api hist_api( app );
+      const vector<operation_history_object> full = get_operation_history( alice_id );
+      const uint16_t transfer_type = operation::tag<transfer_operation>::value;
+      const uint16_t create_type = operation::tag<account_create_operation>::value;
+
+      auto filter = [&]( const flat_set<uint16_t>& types, operation_history_id_type stop, operation_history_id_type start )
+      {
+         vector<operation_history_id_type> ids;
+         for( const operation_history_object& o : full )
+            if( types.count( o.op.which() ) && o.id.instance() > stop.instance.value
+                && ( start == operation_history_id_type() || o.id.instance() <= start.instance.value ) )
+               ids.push_back( o.id );
+         return ids;
+      };
+      auto ids_of = []( const vector<operation_history_object>& ops )
+      {
+         vector<operation_history_id_type> ids;
+         for( const operation_history_object& o : ops )
+            ids.push_back( o.id );
+         return ids;
+      };
+
+      const vector<operation_history_id_type> transfers = filter( { transfer_type }, operation_history_id_type(),
+                                                                  operation_history_id_type() );
+      BOOST_REQUIRE( transfers.size() >= 12 );
+      BOOST_CHECK( ids_of( hist_api.get_account_operation_history( alice_id, transfer_type, 100 ) ) == transfers );
+      BOOST_CHECK( ids_of( hist_api.get_account_operation_history( alice_id, transfer_type, 5 ) )
+                   == vector<operation_history_id_type>( transfers.begin(), transfers.begin() + 5 ) );
+
+      BOOST_TEST_MESSAGE( "Start and stop of typed queries" );
+      const operation_history_id_type start = full[3].id;
+      const operation_history_id_type stop = full[full.size() - 4].id;
+      BOOST_CHECK( ids_of( hist_api.get_account_operation_history2( alice_id, stop, 100, start, transfer_type ) )
+                   == filter( { transfer_type }, stop, start ) );
+
+      BOOST_TEST_MESSAGE( "Several types are merged from most recent to oldest" );
+      const vector<operation_history_id_type> mixed = filter( { transfer_type, create_type }, stop, start );
+      BOOST_CHECK( std::any_of( mixed.begin(), mixed.end(), [&]( operation_history_id_type id ) {
+         return id(db).op.which() == create_type;
+      }) );
+      BOOST_CHECK( ids_of( hist_api.get_account_operation_history3( alice_id, stop, 100, start,
+                                                                   { create_type, transfer_type, transfer_type } ) )
+                   == mixed );
+
+      vector<operation_history_id_type> paged;
+      uint32_t next = 0;
+      do
+      {
+         account_history_page page = hist_api.get_account_history_page( alice_id, next, 3, { transfer_type, create_type } );
+         const vector<operation_history_id_type> ids = ids_of( page.operations );
+         paged.insert( paged.end(), ids.begin(), ids.end() );
+         next = page.next_start;
+      } while( next != 0 );
+      BOOST_CHECK( paged == filter( { transfer_type, create_type }, operation_history_id_type(), operation_history_id_type() ) );
+
+      BOOST_TEST_MESSAGE( "Transfers from the oldest on" );
+      vector<operation_history_id_type> ascending( transfers.rbegin(), transfers.rend() );
+      BOOST_CHECK( ids_of( hist_api.get_account_operation_history4( alice_id, operation_history_id_type(), 100,
+                                                                   { transfer_type } ) ) == ascending );
+      BOOST_CHECK( ids_of( hist_api.get_account_operation_history4( alice_id, ascending[2], 3, { transfer_type } ) )
+                   == vector<operation_history_id_type>( ascending.begin() + 2, ascending.begin() + 5 ) );
+      BOOST_CHECK( hist_api.get_account_operation_history4( alice_id, operation_history_id_type(), 100,
+                                                            { create_type } ).empty() );
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE( listtransactions_by_address )
+{
+   try {
+      ACTORS( (market)(alice)(bob) );
+      fund( alice );
+      fund( bob );
+
+      const vector<string> addresses = { "addr-a", "addr-b", "addr-c", "" };
+      auto send = [&]( const account_object& from, const string& address, share_type amount )
+      {
+         set_expiration( db, trx );
+         transfer_operation op;
+         op.from = from.id;
+         op.to = market_id;
+         op.amount = asset( amount );
+         if( !address.empty() )
+            op.extensions.insert( address );
+         trx.operations.push_back( op );
+         PUSH_TX( db, trx, ~0 );
+         trx.clear();
+      };
+      for( int i = 0; i < 20; ++i )
+      {
+         send( i % 2 ? alice : bob, addresses[i % addresses.size()], 10 + i );
+         if( i % 5 == 4 )
+            generate_block();
+      }
+      generate_block();
+
+      history_api hist_api( app );
+      auto address_of = []( const listtransactions_result& r )
+      {
+         for( const auto& ext : r.transfer.extensions )
+            if( ext.which() == asset_ext_type::value_type::tag<string>::value )
+               return ext.get<string>();
+         return string();
+      };
+      const vector<listtransactions_result> all = hist_api.listtransactions( market_id, {}, 100 );
+      BOOST_REQUIRE_EQUAL( all.size(), 20u );
+
+      auto expected = [&]( const vector<string>& wanted, size_t count )
+      {
+         vector<share_type> amounts;
+         for( const listtransactions_result& r : all )
+            if( amounts.size() < count && std::find( wanted.begin(), wanted.end(), address_of( r ) ) != wanted.end() )
+               amounts.push_back( r.transfer.amount.amount );
+         return amounts;
+      };
+      auto amounts_of = []( const vector<listtransactions_result>& results )
+      {
+         vector<share_type> amounts;
+         for( const listtransactions_result& r : results )
+            amounts.push_back( r.transfer.amount.amount );
+         return amounts;
+      };
+
+      BOOST_TEST_MESSAGE( "Ranges of several addresses are merged from the most recent transfer" );
+      BOOST_CHECK( amounts_of( hist_api.listtransactions( market_id, { "addr-a", "addr-c" }, 100 ) )
+                   == expected( { "addr-a", "addr-c" }, 100 ) );
+      BOOST_CHECK( amounts_of( hist_api.listtransactions( market_id, { "addr-c", "addr-a", "addr-c" }, 3 ) )
+                   == expected( { "addr-a", "addr-c" }, 3 ) );
+      BOOST_CHECK_EQUAL( hist_api.listtransactions( market_id, { "addr-b" }, 100 ).size(), 5u );
+      BOOST_CHECK( hist_api.listtransactions( market_id, { "addr-unknown" }, 100 ).empty() );
+
+      BOOST_TEST_MESSAGE( "The empty address selects transfers without one" );
+      BOOST_CHECK( amounts_of( hist_api.listtransactions( market_id, { "" }, 100 ) ) == expected( { "" }, 100 ) );
+      BOOST_CHECK_EQUAL( hist_api.listtransactions( market_id, { "" }, 100 ).size(), 5u );
+      BOOST_CHECK( amounts_of( hist_api.listtransactions( market_id, { "addr-b", "" }, 100 ) )
+                   == expected( { "addr-b", "" }, 100 ) );
+
+      BOOST_TEST_MESSAGE( "Only the transfers with an address are in the address index, once per account" );
+      BOOST_CHECK_EQUAL( db.get_index_type<account_address_history_index>().indices().size(), 30u );
+
+      BOOST_TEST_MESSAGE( "The sender sees its transfers under the same addresses" );
+      BOOST_CHECK_EQUAL( hist_api.listtransactions( alice_id, { "addr-b" }, 100 ).size(), 5u );
+      BOOST_CHECK( hist_api.listtransactions( bob_id, { "addr-b" }, 100 ).empty() );
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE( max_ops_per_account )
+{
+   try {
+      // the history of every account is kept until HARDFORK_617_TIME
+      create_edc();
+      generate_blocks( HARDFORK_620_TIME + 60 );
+      ACTORS( (alice)(bob)(carol) );
+      fund( alice );
+      generate_block();
+
+      auto plugin = app.get_plugin<graphene::history::history_plugin>( "history" );
+      plugin->set_max_ops_per_account( 5, { { bob_id, 0 }, { carol_id, 2 } } );
+
+      for( int i = 0; i < 10; ++i )
+         transfer( alice_id, bob_id, asset( 10 + i ) );
+      generate_block();
+      const operation_history_id_type first_to_bob = get_operation_history( bob_id ).back().id;
+
+      transfer( alice_id, carol_id, asset( 20 ) );
+      generate_block();
+      const operation_history_id_type first_to_carol = get_operation_history( carol_id ).front().id;
+      for( int i = 1; i < 4; ++i )
+         transfer( alice_id, carol_id, asset( 20 + i ) );
+      generate_block();
+      BOOST_CHECK_EQUAL( get_operation_history( carol_id ).size(), 2u );
+      BOOST_CHECK( db.find( first_to_carol ) != nullptr );
+
+      BOOST_TEST_MESSAGE( "Each account keeps its most recent entries" );
+      vector<operation_history_object> alice_ops = get_operation_history( alice_id );
+      BOOST_REQUIRE_EQUAL( alice_ops.size(), 5u );
+      BOOST_CHECK_EQUAL( alice_ops.front().op.get<transfer_operation>().amount.amount.value, 23 );
+      BOOST_CHECK_EQUAL( alice_ops.back().op.get<transfer_operation>().amount.amount.value, 19 );
+      BOOST_CHECK( alice_id(db).statistics(db).total_ops > 5u );
+      BOOST_CHECK( get_operation_history( bob_id ).size() > 10u );
+
+      BOOST_TEST_MESSAGE( "Operations are removed once no history refers to them" );
+      for( int i = 0; i < 5; ++i )
+         transfer( alice_id, bob_id, asset( 30 + i ) );
+      generate_block();
+      BOOST_CHECK( db.find( first_to_carol ) == nullptr );
+      BOOST_CHECK( db.find( first_to_bob ) != nullptr );
+      alice_ops = get_operation_history( alice_id );
+      BOOST_REQUIRE_EQUAL( alice_ops.size(), 5u );
+      BOOST_CHECK_EQUAL( alice_ops.back().op.get<transfer_operation>().amount.amount.value, 30 );
+
+      history_api hist_api( app );
+      BOOST_CHECK_EQUAL( hist_api.get_account_history( alice_id, operation_history_id_type(), 100,
+                                                       operation_history_id_type() ).size(), 5u );
+
+      BOOST_TEST_MESSAGE( "Transfers trimmed from the history are still found while they are stored" );
+      const uint16_t transfer_type = operation::tag<transfer_operation>::value;
+      vector<operation_history_id_type> stored_transfers;
+      for( const operation_history_object& o : db.get_index_type<operation_history_index>().indices().get<by_id>() )
+      {
+         if( o.op.which() != transfer_type )
+            continue;
+         const transfer_operation& t = o.op.get<transfer_operation>();
+         if( ( t.from == alice_id || t.to == alice_id ) && stored_transfers.size() < 100 )
+            stored_transfers.push_back( o.id );
+      }
+      BOOST_REQUIRE( stored_transfers.size() > 5u );
+      vector<operation_history_id_type> found;
+      for( const operation_history_object& o : hist_api.get_account_operation_history4( alice_id,
+                                                  operation_history_id_type(), 100, { transfer_type } ) )
+         found.push_back( o.id );
+      BOOST_CHECK( found == stored_transfers );
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE( operation_references_follow_history_entries )
+{
+   try {
+      ACTORS( (alice)(bob)(carol) );
+      fund( alice );
+      transfer( alice_id, bob_id, asset( 10 ) );
+      generate_block();
+
+      const operation_history_id_type op_id = get_operation_history( bob_id ).front().id;
+      const auto& hist_idx = dynamic_cast<const primary_index<account_transaction_history_index>&>(
+         db.get_index_type<account_transaction_history_index>() );
+      const auto& refs = hist_idx.get_secondary_index<
+         graphene::history::operation_reference_index<account_transaction_history_object>>();
+      BOOST_CHECK( refs.is_referenced( op_id ) );
+
+      BOOST_TEST_MESSAGE( "An entry keeps the operation referenced whatever the operation impacts" );
+      const auto& carol_entry = db.create<account_transaction_history_object>( [&]( account_transaction_history_object& o ) {
+         o.account = carol_id;
+         o.operation_id = op_id;
+         o.sequence = 1000;
+      });
+      const account_transaction_history_id_type carol_entry_id = carol_entry.id;
+      const auto& by_op_idx = hist_idx.indices().get<by_op>();
+      for( account_id_type acc : { alice_id, bob_id } )
+         db.remove( *by_op_idx.find( boost::make_tuple( acc, op_id ) ) );
+      BOOST_CHECK( refs.is_referenced( op_id ) );
+
+      {
+         auto session = db._undo_db.start_undo_session();
+         db.remove( carol_entry_id(db) );
+         BOOST_CHECK( !refs.is_referenced( op_id ) );
+      }
+      BOOST_CHECK( refs.is_referenced( op_id ) );
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE( cold_history_store )
+{
+   try {
+      create_edc();
+      generate_blocks( HARDFORK_620_TIME + 60 );
+      ACTORS( (alice)(bob) );
+      fund( alice );
+      generate_block();
+
+      fc::temp_directory cold_dir( graphene::utilities::temp_directory_path() );
+      auto plugin = app.get_plugin<graphene::history::history_plugin>( "history" );
+      plugin->set_max_ops_per_account( 5 );
+      plugin->open_cold_store( cold_dir.path() );
+
+      // only the entries of irreversible blocks go to the store, the others are trimmed once their block is
+      auto make_irreversible = [&]()
+      {
+         const uint32_t head = db.head_block_num();
+         while( db.get_dynamic_global_properties().last_irreversible_block_num < head )
+            generate_block();
+         generate_block();
+      };
+      auto check_stored_blocks = [&]()
+      {
+         const uint32_t last_irreversible = db.get_dynamic_global_properties().last_irreversible_block_num;
+         for( const auto& e : plugin->cold_store()->entries( alice_id ) )
+            BOOST_CHECK( plugin->cold_store()->read( e ).block_num <= last_irreversible );
+      };
+
+      for( int i = 0; i < 20; ++i )
+      {
+         transfer( alice_id, bob_id, asset( 10 + i ) );
+         if( i % 3 == 2 )
+         {
+            generate_block();
+            check_stored_blocks();
+         }
+      }
+      make_irreversible();
+
+      uint32_t total_ops = alice_id(db).statistics(db).total_ops;
+      BOOST_CHECK_EQUAL( get_operation_history( alice_id ).size(), 5u );
+      BOOST_REQUIRE( plugin->cold_store() != nullptr );
+      BOOST_CHECK_EQUAL( plugin->cold_store()->entries( alice_id ).size(), total_ops - 5 );
+
+      BOOST_TEST_MESSAGE( "Queries read the entries in memory and on disk" );
+      history_api hist_api( app );
+      const vector<operation_history_object> all = hist_api.get_account_history( alice_id,
+                                                      operation_history_id_type(), 100, operation_history_id_type() );
+      BOOST_REQUIRE_EQUAL( all.size(), total_ops );
+      for( size_t i = 1; i < all.size(); ++i )
+         BOOST_CHECK( all[i].id < all[i - 1].id );
+      BOOST_CHECK_EQUAL( all[6].op.get<transfer_operation>().amount.amount.value, 23 );
+
+      const vector<operation_history_object> middle = hist_api.get_account_history( alice_id, all[12].id, 100,
+                                                                                    all[3].id );
+      BOOST_REQUIRE_EQUAL( middle.size(), 9u );
+      BOOST_CHECK( middle.front().id == all[3].id );
+      BOOST_CHECK( middle.back().id == all[11].id );
+
+      vector<operation_history_id_type> paged;
+      uint32_t next = 0;
+      do
+      {
+         account_history_page page = hist_api.get_account_history_page( alice_id, next, 4 );
+         for( const operation_history_object& o : page.operations )
+            paged.push_back( o.id );
+         next = page.next_start;
+      } while( next != 0 );
+      BOOST_REQUIRE_EQUAL( paged.size(), all.size() );
+      for( size_t i = 0; i < all.size(); ++i )
+         BOOST_CHECK( paged[i] == all[i].id );
+
+      const uint16_t transfer_type = operation::tag<transfer_operation>::value;
+      size_t transfers = 0;
+      next = 0;
+      do
+      {
+         account_history_page page = hist_api.get_account_history_page( alice_id, next, 7, { transfer_type } );
+         transfers += page.operations.size();
+         next = page.next_start;
+      } while( next != 0 );
+      BOOST_CHECK_EQUAL( transfers, 20u );
+
+      BOOST_TEST_MESSAGE( "The other history queries read the store as well" );
+      vector<operation_history_id_type> all_transfers;
+      for( const operation_history_object& o : all )
+         if( o.op.which() == transfer_type )
+            all_transfers.push_back( o.id );
+      BOOST_CHECK_EQUAL( hist_api.listtransactions( alice_id, {}, 100 ).size(), all_transfers.size() );
+      BOOST_CHECK_EQUAL( hist_api.listtransactions( alice_id, { "" }, 100 ).size(), all_transfers.size() );
+      vector<operation_history_id_type> typed;
+      for( const operation_history_object& o : hist_api.get_account_operation_history( alice_id, transfer_type, 100 ) )
+         typed.push_back( o.id );
+      BOOST_CHECK( typed == all_transfers );
+      typed.clear();
+      for( const operation_history_object& o : hist_api.get_account_operation_history3( alice_id,
+                                                  operation_history_id_type(), 100, all[3].id, { transfer_type } ) )
+         typed.push_back( o.id );
+      BOOST_CHECK( typed == vector<operation_history_id_type>( all_transfers.begin() + 3, all_transfers.end() ) );
+      typed.clear();
+      for( const operation_history_object& o : hist_api.get_account_operation_history4( alice_id,
+                                                  operation_history_id_type(), 100, { transfer_type } ) )
+         typed.push_back( o.id );
+      BOOST_CHECK( typed == vector<operation_history_id_type>( all_transfers.rbegin(), all_transfers.rend() ) );
+      const vector<operation_history_object> relative = hist_api.get_relative_history( alice_id, 0, 100, 0 );
+      BOOST_REQUIRE_EQUAL( relative.size(), total_ops );
+      BOOST_CHECK( relative.back().id == all.back().id );
+
+      BOOST_TEST_MESSAGE( "Entries of a block popped again never reach the store" );
+      for( int i = 0; i < 6; ++i )
+         transfer( alice_id, bob_id, asset( 100 + i ) );
+      generate_block();
+      check_stored_blocks();
+      db.pop_block();
+      db._popped_tx.clear();
+      db.clear_pending();
+      for( int i = 0; i < 6; ++i )
+         transfer( alice_id, bob_id, asset( 200 + i ) );
+      generate_block();
+      make_irreversible();
+      check_stored_blocks();
+
+      total_ops = alice_id(db).statistics(db).total_ops;
+      BOOST_CHECK_EQUAL( get_operation_history( alice_id ).size(), 5u );
+      BOOST_CHECK_EQUAL( plugin->cold_store()->entries( alice_id ).size(), total_ops - 5 );
+      size_t popped = 0;
+      size_t applied = 0;
+      for( const operation_history_object& o : hist_api.get_account_history( alice_id, operation_history_id_type(),
+                                                                             100, operation_history_id_type() ) )
+      {
+         if( o.op.which() != transfer_type )
+            continue;
+         const int64_t amount = o.op.get<transfer_operation>().amount.amount.value;
+         popped += ( amount >= 100 && amount < 106 );
+         applied += ( amount >= 200 && amount < 206 );
+      }
+      BOOST_CHECK_EQUAL( popped, 0u );
+      BOOST_CHECK_EQUAL( applied, 6u );
+
+      BOOST_TEST_MESSAGE( "The store is loaded again from disk" );
+      plugin->open_cold_store( cold_dir.path() );
+      BOOST_CHECK_EQUAL( plugin->cold_store()->entries( alice_id ).size(), total_ops - 5 );
+      BOOST_CHECK_EQUAL( hist_api.get_account_history( alice_id, operation_history_id_type(), 100,
+                                                       operation_history_id_type() ).size(), total_ops );
+
+      BOOST_TEST_MESSAGE( "The export merges the trimmed operations in by id" );
+      std::stringstream memory_out;
+      BOOST_CHECK_EQUAL( graphene::history::export_operation_history( db, memory_out, 0, 0,
+                                                                      graphene::history::history_export_format::json ),
+                         db.get_index_type<operation_history_index>().indices().size() );
+      std::stringstream export_out;
+      graphene::history::export_operation_history( db, export_out, 0, 0, graphene::history::history_export_format::json,
+                                                   plugin->cold_store() );
+      vector<operation_history_object> exported;
+      std::string line;
+      while( std::getline( export_out, line ) )
+         exported.push_back( fc::json::from_string( line ).as<operation_history_object>( 20 ) );
+      for( size_t i = 1; i < exported.size(); ++i )
+         BOOST_CHECK( exported[i - 1].id < exported[i].id );
+      for( const operation_history_object& o : hist_api.get_account_history( alice_id, operation_history_id_type(),
+                                                                             100, operation_history_id_type() ) )
+         BOOST_CHECK( std::count_if( exported.begin(), exported.end(),
+                                     [&]( const operation_history_object& e ) { return e.id == o.id; } ) == 1 );
+
+      const uint32_t last_block = db.head_block_num() - 5;
+      std::stringstream range_out;
+      const uint64_t in_range = graphene::history::export_operation_history( db, range_out, 3, last_block,
+                                   graphene::history::history_export_format::json, plugin->cold_store() );
+      BOOST_CHECK_EQUAL( in_range, uint64_t( std::count_if( exported.begin(), exported.end(),
+                                                            [&]( const operation_history_object& e ) {
+                                                               return e.block_num >= 3 && e.block_num <= last_block;
+                                                            } ) ) );
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_CASE( export_operation_history )
+{
+   try {
+      ACTORS( (alice)(bob) );
+      fund( alice );
+      generate_block();
+
+      const uint32_t first_block = db.head_block_num() + 1;
+      for( int i = 0; i < 30; ++i )
+      {
+         transfer( alice_id, bob_id, asset( 10 + i ) );
+         if( i % 10 == 9 )
+            generate_block();
+      }
+      const uint32_t last_block = db.head_block_num() - 1;
+      generate_block();
+
+      vector<operation_history_object> expected;
+      for( const operation_history_object& o : db.get_index_type<operation_history_index>().indices().get<by_id>() )
+         if( o.block_num >= first_block && o.block_num <= last_block )
+            expected.push_back( o );
+      BOOST_REQUIRE_EQUAL( expected.size(), 20u );
+
+      BOOST_TEST_MESSAGE( "One JSON object per line" );
+      std::stringstream json_out;
+      BOOST_CHECK_EQUAL( graphene::history::export_operation_history( db, json_out, first_block, last_block,
+                                                                      graphene::history::history_export_format::json ),
+                         expected.size() );
+      std::string line;
+      size_t lines = 0;
+      while( std::getline( json_out, line ) )
+      {
+         BOOST_REQUIRE( lines < expected.size() );
+         const operation_history_object o = fc::json::from_string( line ).as<operation_history_object>( 20 );
+         BOOST_CHECK( o.id == expected[lines].id );
+         BOOST_CHECK_EQUAL( o.op.get<transfer_operation>().amount.amount.value,
+                            expected[lines].op.get<transfer_operation>().amount.amount.value );
+         ++lines;
+      }
+      BOOST_CHECK_EQUAL( lines, expected.size() );
+
+      BOOST_TEST_MESSAGE( "Packed objects prefixed with their size" );
+      std::stringstream binary_out;
+      graphene::history::export_operation_history( db, binary_out, first_block, last_block,
+                                                   graphene::history::history_export_format::binary );
+      const std::string data = binary_out.str();
+      size_t pos = 0;
+      for( const operation_history_object& o : expected )
+      {
+         uint32_t size = 0;
+         BOOST_REQUIRE( pos + sizeof( size ) <= data.size() );
+         memcpy( &size, data.data() + pos, sizeof( size ) );
+         pos += sizeof( size );
+         BOOST_REQUIRE( pos + size <= data.size() );
+         BOOST_CHECK( std::string( data.data() + pos, size ) == std::string( fc::raw::pack( o ).data(), size ) );
+         pos += size;
+      }
+      BOOST_CHECK_EQUAL( pos, data.size() );
+
+      BOOST_TEST_MESSAGE( "The whole history up to the head block" );
+      std::stringstream all_out;
+      BOOST_CHECK_EQUAL( graphene::history::export_operation_history( db, all_out, 0, 0,
+                                                                      graphene::history::history_export_format::json ),
+                         db.get_index_type<operation_history_index>().indices().size() );
+   } FC_LOG_AND_RETHROW()
+}
+
+BOOST_AUTO_TEST_SUITE_END()
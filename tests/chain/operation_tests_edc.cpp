@@ -11,6 +11,8 @@
 #include <graphene/chain/proposal_object.hpp>
 #include <graphene/chain/witness_object.hpp>
 
+#include <graphene/app/database_api.hpp>
+
 #include <fc/crypto/digest.hpp>
 
 #include "../common/database_fixture.hpp"
@@ -568,4 +570,130 @@ BOOST_AUTO_TEST_CASE(witness_fee_payments_test)
    }
 }
 
+BOOST_AUTO_TEST_CASE(update_online_time_test)
+{
+   try {
+      ACTORS((alice)(bob)(carol));
+
+      // the operation is rejected until the hardfork, even right before it
+      generate_blocks(HARDFORK_638_TIME - db.get_global_properties().parameters.block_interval);
+      BOOST_REQUIRE(db.head_block_time() <= HARDFORK_638_TIME);
+      {
+         update_online_time_operation op;
+         op.online_info = { {alice_id, 100} };
+         set_expiration(db, trx);
+         trx.operations.push_back(std::move(op));
+         GRAPHENE_REQUIRE_THROW(PUSH_TX(db, trx, ~0), fc::exception);
+         trx.clear();
+      }
+      BOOST_CHECK(!db.has_online_info());
+
+      generate_blocks(HARDFORK_638_TIME);
+      // online info is cleared at maintenance, keep the checks within one maintenance interval
+      generate_blocks(db.get_dynamic_global_properties().next_maintenance_time);
+      generate_block();
+
+      graphene::app::database_api api(db);
+      BOOST_CHECK(!db.has_online_info());
+
+      {
+         set_online_time_operation op;
+         op.online_info = { {alice_id, 100}, {bob_id, 200} };
+         set_expiration(db, trx);
+         trx.operations.push_back(std::move(op));
+         PUSH_TX(db, trx, ~0);
+         trx.clear();
+      }
+      generate_block();
+      uint32_t first_block = db.head_block_num();
+
+      BOOST_CHECK(db.has_online_info());
+      BOOST_CHECK_EQUAL(db.get_online_minutes(alice_id), 100);
+      BOOST_CHECK_EQUAL(db.get_online_minutes(bob_id), 200);
+      BOOST_CHECK_EQUAL(db.get_online_minutes(carol_id), 0);
+
+      {
+         update_online_time_operation op;
+         op.online_info = { {bob_id, 300}, {carol_id, 50} };
+         set_expiration(db, trx);
+         trx.operations.push_back(std::move(op));
+         PUSH_TX(db, trx, ~0);
+         trx.clear();
+      }
+      generate_block();
+
+      auto online = api.get_online_info();
+      BOOST_REQUIRE_EQUAL(online.size(), 3u);
+      BOOST_CHECK_EQUAL(online[alice_id], 100);
+      BOOST_CHECK_EQUAL(online[bob_id], 300);
+      BOOST_CHECK_EQUAL(online[carol_id], 50);
+
+      // only the entries of the last operation changed after the first block
+      auto changes = api.get_online_info_changes(first_block, account_id_type(), 100);
+      BOOST_CHECK_EQUAL(changes.head_block_num, db.head_block_num());
+      BOOST_CHECK(!changes.entries_removed);
+      BOOST_REQUIRE_EQUAL(changes.changed.size(), 2u);
+      BOOST_CHECK(changes.changed[0].owner == bob_id);
+      BOOST_CHECK(changes.changed[1].owner == carol_id);
+
+      // continue a page of one entry
+      changes = api.get_online_info_changes(first_block, account_id_type(), 1);
+      BOOST_REQUIRE_EQUAL(changes.changed.size(), 1u);
+      changes = api.get_online_info_changes(changes.changed[0].last_update_block - 1,
+                                            changes.changed[0].owner + 1, 1);
+      BOOST_REQUIRE_EQUAL(changes.changed.size(), 1u);
+      BOOST_CHECK(changes.changed[0].owner == carol_id);
+
+      auto page = api.list_online_info(bob_id, 1);
+      BOOST_REQUIRE_EQUAL(page.size(), 1u);
+      BOOST_CHECK(page[0].owner == bob_id);
+      BOOST_CHECK_EQUAL(page[0].online_minutes, 300);
+
+      {
+         update_online_time_operation op;
+         op.removed = { alice_id };
+         set_expiration(db, trx);
+         trx.operations.push_back(std::move(op));
+         PUSH_TX(db, trx, ~0);
+         trx.clear();
+      }
+      generate_block();
+
+      changes = api.get_online_info_changes(first_block, account_id_type(), 100);
+      BOOST_CHECK(changes.entries_removed);
+      BOOST_CHECK_EQUAL(api.get_online_info().count(alice_id), 0u);
+      BOOST_CHECK_EQUAL(db.get_online_minutes(alice_id), 0);
+
+      {
+         update_online_time_operation op;
+         op.online_info = { {alice_id, 10} };
+         op.removed = { alice_id };
+         set_expiration(db, trx);
+         trx.operations.push_back(std::move(op));
+         GRAPHENE_REQUIRE_THROW(PUSH_TX(db, trx, ~0), fc::exception);
+         trx.clear();
+      }
+
+      // the full replace of set_online_time_operation still removes the accounts it does not list
+      {
+         set_online_time_operation op;
+         op.online_info = { {carol_id, 60} };
+         set_expiration(db, trx);
+         trx.operations.push_back(std::move(op));
+         PUSH_TX(db, trx, ~0);
+         trx.clear();
+      }
+      generate_block();
+
+      online = api.get_online_info();
+      BOOST_REQUIRE_EQUAL(online.size(), 1u);
+      BOOST_CHECK_EQUAL(online[carol_id], 60);
+   }
+   catch (fc::exception& e)
+   {
+      edump((e.to_detail_string()))
+      throw;
+   }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -1,6 +1,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include <graphene/app/application.hpp>
+#include <graphene/app/database_api.hpp>
 #include <graphene/chain/database.hpp>
 #include <graphene/chain/exceptions.hpp>
 #include <graphene/chain/hardfork.hpp>
@@ -754,4 +755,77 @@ BOOST_AUTO_TEST_CASE( referrals_test )
 }
 
 
+BOOST_AUTO_TEST_CASE( referral_api_follows_referrer_changes )
+{
+   try
+   {
+      BOOST_TEST_MESSAGE( "=== referral_api_follows_referrer_changes ===" );
+
+      ACTORS( (alice)(bob)(carol)(dave)(erin) )
+
+      SET_ACTOR_CAN_CREATE_ASSET(alice_id)
+      create_edc(10000000000, asset(100, CORE_ASSET), asset(1, EDC_ASSET));
+
+      CHANGE_REFERRER_MULTIPLE(("bob")("carol"), "alice")
+      CHANGE_REFERRER_MULTIPLE(("dave"), "bob")
+      CHANGE_REFERRER_MULTIPLE(("erin"), "dave")
+      issue_uia(bob_id, asset(100000, EDC_ASSET));
+      issue_uia(dave_id, asset(200000, EDC_ASSET));
+      generate_block();
+
+      graphene::app::database_api api(db);
+      auto check_against_full_scan = [&]( const string& name ) {
+         auto& acc_idx = db.get_index_type<account_index>();
+         auto& bal_idx = db.get_index_type<account_balance_index>();
+         const account_id_type id = get_account_by_name(name).get_id();
+         referral_tree full(acc_idx, bal_idx, EDC_ASSET, id);
+         full.form_old();
+         const leaf_info& root = *full.referral_map.find(id)->second;
+         const ref_info info = api.get_referrals2(name);
+         BOOST_CHECK_EQUAL( info.all_sum, root.all_sum );
+         BOOST_CHECK_EQUAL( info.all_partners, root.all_partners );
+         BOOST_CHECK_EQUAL( info.level_1_sum, root.level_1_sum );
+         BOOST_CHECK_EQUAL( info.level_1_partners, root.level_1_partners );
+         BOOST_CHECK_EQUAL( info.level_2_partners, root.level_2_partners );
+         BOOST_CHECK_EQUAL( info.rank, root.rank );
+         return info;
+      };
+
+      BOOST_TEST_MESSAGE( "The referrals come from the referrer index" );
+      Unit referrals = api.get_referrals("alice");
+      BOOST_REQUIRE_EQUAL( referrals.referrals.size(), 2u );
+      BOOST_CHECK( referrals.referrals[0].id == bob_id );
+      BOOST_CHECK( referrals.referrals[1].id == carol_id );
+      BOOST_CHECK_EQUAL( referrals.referrals[0].balance, 100000u );
+
+      ref_info info = check_against_full_scan("alice");
+      BOOST_CHECK_EQUAL( info.all_sum, 300000u );
+      BOOST_CHECK_EQUAL( info.level_1.size(), 2u );
+      check_against_full_scan("bob");
+
+      BOOST_TEST_MESSAGE( "Pages start at the given referral" );
+      referrals = api.get_referrals_page("alice", carol_id, 10);
+      BOOST_REQUIRE_EQUAL( referrals.referrals.size(), 1u );
+      BOOST_CHECK( referrals.referrals[0].id == carol_id );
+      info = api.get_referrals2_page("alice", account_id_type(), 1);
+      BOOST_REQUIRE_EQUAL( info.level_1.size(), 1u );
+      BOOST_CHECK( info.level_1[0].id == bob_id );
+      BOOST_CHECK_EQUAL( info.all_sum, 300000u );
+
+      BOOST_TEST_MESSAGE( "A new referrer moves the whole downline" );
+      CHANGE_REFERRER_MULTIPLE(("dave"), "carol")
+      generate_block();
+      BOOST_CHECK( api.get_referrals("bob").referrals.empty() );
+      BOOST_REQUIRE_EQUAL( api.get_referrals("carol").referrals.size(), 1u );
+      info = check_against_full_scan("carol");
+      BOOST_CHECK_EQUAL( info.all_sum, 200000u );
+      check_against_full_scan("alice");
+   }
+   catch(fc::exception& e)
+   {
+      edump((e.to_detail_string()))
+      throw;
+   }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
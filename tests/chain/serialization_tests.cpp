@@ -25,16 +25,132 @@
 #include <boost/test/unit_test.hpp>
 
 #include <graphene/chain/database.hpp>
+#include <graphene/chain/operation_history_object.hpp>
 
 
 #include <fc/crypto/digest.hpp>
 #include <fc/crypto/elliptic.hpp>
+#include <fc/io/json.hpp>
+#include <fc/io/json_writer.hpp>
 #include <fc/reflect/variant.hpp>
 
+#include <graphene/app/api.hpp>
+#include <graphene/app/database_api.hpp>
+
 #include "../common/database_fixture.hpp"
 
 using namespace graphene::chain;
 
+namespace {
+
+template<typename T, typename = void>
+struct is_sample_container : std::false_type {};
+template<typename T>
+struct is_sample_container<T, decltype( void( std::declval<T&>().insert( std::declval<T&>().end(),
+                                                          std::declval<typename T::value_type>() ) ) )>
+   : std::integral_constant<bool, !std::is_same<T, std::string>::value> {};
+
+/**
+ * Builds a value of T with an element in every container, every optional set and every member of a reflected
+ * struct filled the same way, down to a few levels, so that the JSON of its nested types is compared too.
+ */
+template<typename T, typename = void>
+struct sampler
+{
+   static T make( uint32_t depth ) { return T(); }
+};
+
+template<typename T>
+struct sampler<fc::optional<T>>
+{
+   static fc::optional<T> make( uint32_t depth )
+   {
+      return depth > 0 ? fc::optional<T>( sampler<T>::make( depth - 1 ) ) : fc::optional<T>();
+   }
+};
+
+template<typename A, typename B>
+struct sampler<std::pair<A,B>>
+{
+   static std::pair<A,B> make( uint32_t depth )
+   {
+      return std::pair<A,B>( sampler<std::remove_const_t<A>>::make( depth ), sampler<B>::make( depth ) );
+   }
+};
+
+template<typename T>
+struct sampler<T, std::enable_if_t<is_sample_container<T>::value>>
+{
+   static T make( uint32_t depth )
+   {
+      T result;
+      if( depth > 0 )
+         result.insert( result.end(), sampler<typename T::value_type>::make( depth - 1 ) );
+      return result;
+   }
+};
+
+template<typename T>
+struct sampler<T, std::enable_if_t<fc::reflector<T>::is_defined::value && !std::is_enum<T>::value
+                                   && !is_sample_container<T>::value>>
+{
+   struct member_filler
+   {
+      T&             value;
+      const uint32_t depth;
+
+      template<typename Member, class Class, Member (Class::*member)>
+      void operator()( const char* )const
+      {
+         value.*member = sampler<Member>::make( depth );
+      }
+   };
+
+   static T make( uint32_t depth )
+   {
+      T result;
+      if( depth > 0 )
+         fc::reflector<T>::visit( member_filler{ result, depth - 1 } );
+      return result;
+   }
+};
+
+/** compares both ways of writing the result of every method of an API */
+struct api_result_checker
+{
+   template<typename R, typename... Args>
+   void operator()( const char* name, const std::function<R(Args...)>& )const
+   {
+      check( name, std::is_void<R>(), (R*)nullptr );
+   }
+
+   template<typename R>
+   void check( const char* name, std::true_type, R* )const {}
+
+   template<typename R>
+   void check( const char* name, std::false_type, R* )const
+   {
+      const uint32_t depth = GRAPHENE_MAX_NESTED_OBJECTS;
+      for( uint32_t fill = 0; fill < 4; ++fill )
+      {
+         const R value = sampler<R>::make( fill );
+         BOOST_CHECK_MESSAGE( fc::json::to_string( fc::variant( value, depth ),
+                                                   fc::json::stringify_large_ints_and_doubles, depth )
+                              == fc::json_writer::to_string( value, fc::json::stringify_large_ints_and_doubles, depth ),
+                              "the JSON of the result of " << name << " differs at fill level " << fill );
+      }
+   }
+};
+
+template<typename Api>
+void check_api_results()
+{
+   fc::api<Api> api;
+   api->visit( api_result_checker() );
+}
+
+} // anonymous namespace
+
 BOOST_FIXTURE_TEST_SUITE( operation_unit_tests, database_fixture )
 
 BOOST_AUTO_TEST_CASE( serialization_raw_test )
@@ -123,4 +239,55 @@ BOOST_AUTO_TEST_CASE( extension_serialization_test )
    }
 }
 
+BOOST_AUTO_TEST_CASE( json_writer_matches_variant_json )
+{
+   try
+   {
+      BOOST_TEST_MESSAGE( "=== json_writer_matches_variant_json ===" );
+
+      ACTORS( (alice)(bob) );
+      transfer( committee_account, alice_id, asset( 1000000 ) );
+      transfer( alice_id, bob_id, asset( 1000 ) );
+      const signed_block block = generate_block();
+
+      auto check = []( const auto& value ) {
+         const uint32_t depth = GRAPHENE_MAX_NESTED_OBJECTS;
+         BOOST_CHECK_EQUAL( fc::json::to_string( fc::variant( value, depth ),
+                                                 fc::json::stringify_large_ints_and_doubles, depth ),
+                            fc::json_writer::to_string( value, fc::json::stringify_large_ints_and_doubles, depth ) );
+      };
+
+      check( block );
+      check( alice_id(db) );
+      check( db.get_global_properties() );
+      check( db.get_dynamic_global_properties() );
+
+      vector<operation_history_object> history;
+      for( const auto& h : db.get_index_type<operation_history_index>().indices() )
+         history.push_back( h );
+      BOOST_REQUIRE( !history.empty() );
+      check( history );
+
+      account_create_operation create_op = make_account( "rex" );
+      buyback_account_options bbo;
+      bbo.asset_to_buy = asset_id_type(1000);
+      bbo.markets.emplace( asset_id_type(777) );
+      create_op.extensions.value.buyback_options = bbo;
+      check( operation( create_op ) );
+
+      BOOST_TEST_MESSAGE( "The result types of every API method" );
+      check_api_results<graphene::app::database_api>();
+      check_api_results<graphene::app::history_api>();
+      check_api_results<graphene::app::secure_api>();
+      check_api_results<graphene::app::network_broadcast_api>();
+      check_api_results<graphene::app::network_node_api>();
+      check_api_results<graphene::app::crypto_api>();
+   }
+   catch ( const fc::exception& e )
+   {
+      edump((e.to_detail_string()));
+      throw;
+   }
+}
+
 BOOST_AUTO_TEST_SUITE_END()